@@ -0,0 +1,53 @@
+#pragma once
+
+// Helpers shared by the scene-level benchmarks
+
+#include "scene/Scene.h"
+#include "systems/CoreSystems.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+namespace Benchmark {
+
+using Clock = std::chrono::high_resolution_clock;
+
+inline double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Best of `repeats` calls to run(), which returns a time
+template<typename Run>
+double bestOf(int repeats, Run&& run) {
+    double best = run();
+    for (int i = 1; i < repeats; ++i) {
+        best = std::min(best, run());
+    }
+    return best;
+}
+
+// An initialised scene in the given storage mode with RenderSystem and
+// PhysicsSystem registered, given the scene and their usual signatures, so
+// Scene::update() runs them as a game would
+inline std::unique_ptr<Scene> makeScene(StorageMode mode) {
+    auto scene = std::make_unique<Scene>();
+    scene->initialize();
+    scene->setStorageMode(mode);
+
+    auto renderSystem = scene->registerSystem<RenderSystem>();
+    renderSystem->setScene(scene.get());
+    ComponentMask renderSignature;
+    renderSignature.set(scene->getComponentType<Transform>());
+    renderSignature.set(scene->getComponentType<Sprite>());
+    scene->setSystemSignature<RenderSystem>(renderSignature);
+
+    auto physicsSystem = scene->registerSystem<PhysicsSystem>();
+    physicsSystem->setScene(scene.get());
+    ComponentMask physicsSignature;
+    physicsSignature.set(scene->getComponentType<Transform>());
+    physicsSignature.set(scene->getComponentType<RigidBody>());
+    scene->setSystemSignature<PhysicsSystem>(physicsSignature);
+    return scene;
+}
+
+} // namespace Benchmark
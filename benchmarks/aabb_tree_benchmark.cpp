@@ -0,0 +1,233 @@
+// AABB tree broadphase microbenchmark
+//
+// Collider sets with wildly varying sizes - a few large static environment
+// rectangles, medium moving bodies and many tiny fast arrows - at increasing
+// sizes:
+//   - all-pairs overlap test
+//   - SpatialHash (static boxes inserted once, moving boxes every frame)
+//   - AABBTree (static tree built once, moving proxies updated with
+//     moveProxy() every frame)
+// Both broadphases' overlap counts are compared with all-pairs; exits
+// non-zero if they differ. Also times ray casts through the tree against a
+// linear scan of every box.
+//
+// Usage: aabb_tree_benchmark [maxColliders] [frames]
+
+#include "BenchmarkCommon.h"
+#include "physics/AABBTree.h"
+#include "physics/SpatialHash.h"
+#include "systems/CoreSystems.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace Benchmark;
+
+struct Box {
+    Rect bounds;
+    Vector2 velocity;
+    bool isStatic;
+};
+
+// 2% environment, 28% bodies, 70% arrows, spread over an area that grows
+// with the count
+std::vector<Box> makeScene(size_t count, std::mt19937& rng) {
+    const float extent = std::sqrt(static_cast<float>(count)) * 40.0f;
+    std::uniform_real_distribution<float> position(0.0f, extent);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> environmentSize(200.0f, 900.0f);
+
+    std::vector<Box> boxes;
+    boxes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const size_t kind = i % 50;
+        if (kind == 0) {
+            boxes.push_back({Rect(position(rng), position(rng), environmentSize(rng), 24.0f), Vector2(), true});
+        } else if (kind < 15) {
+            boxes.push_back({Rect(position(rng), position(rng), 28.0f, 28.0f), Vector2(unit(rng), unit(rng)), false});
+        } else {
+            boxes.push_back({Rect(position(rng), position(rng), 6.0f, 2.0f), Vector2(unit(rng) * 8.0f, unit(rng)), false});
+        }
+    }
+    return boxes;
+}
+
+void moveBoxes(std::vector<Box>& boxes) {
+    for (Box& box : boxes) {
+        box.bounds.x += box.velocity.x;
+        box.bounds.y += box.velocity.y;
+    }
+}
+
+size_t allPairs(const std::vector<Box>& boxes) {
+    size_t overlaps = 0;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        for (size_t j = i + 1; j < boxes.size(); ++j) {
+            if (boxes[i].isStatic && boxes[j].isStatic) continue;
+            if (CollisionSystem::checkCollision(boxes[i].bounds, boxes[j].bounds)) ++overlaps;
+        }
+    }
+    return overlaps;
+}
+
+size_t gridPairs(SpatialHash& grid, const std::vector<Box>& boxes, std::vector<SpatialHash::Pair>& pairs) {
+    grid.clearDynamic();
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        if (!boxes[i].isStatic) grid.insertDynamic(i, boxes[i].bounds);
+    }
+    grid.findPairs(pairs);
+
+    size_t overlaps = 0;
+    for (const SpatialHash::Pair& pair : pairs) {
+        if (CollisionSystem::checkCollision(boxes[pair.a].bounds, boxes[pair.b].bounds)) ++overlaps;
+    }
+    return overlaps;
+}
+
+// Same scheme as CollisionSystem: query each moving box's own bounds and
+// keep dynamic pairs with a larger id only
+size_t treePairs(AABBTree& staticTree, AABBTree& dynamicTree, const std::vector<int32_t>& proxies,
+                 const std::vector<Box>& boxes) {
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        if (!boxes[i].isStatic) dynamicTree.moveProxy(proxies[i], boxes[i].bounds, boxes[i].velocity);
+    }
+
+    size_t overlaps = 0;
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        if (boxes[i].isStatic) continue;
+        const Rect& bounds = boxes[i].bounds;
+        dynamicTree.query(bounds, [&](uint32_t other) {
+            if (other > i && CollisionSystem::checkCollision(bounds, boxes[other].bounds)) ++overlaps;
+            return true;
+        });
+        staticTree.query(bounds, [&](uint32_t other) {
+            if (CollisionSystem::checkCollision(bounds, boxes[other].bounds)) ++overlaps;
+            return true;
+        });
+    }
+    return overlaps;
+}
+
+// Nearest box hit by a horizontal ray, or -1
+float rayDistance(const Rect& box, const Vector2& origin) {
+    if (origin.y < box.y || origin.y > box.y + box.height || box.x + box.width < origin.x) return -1.0f;
+    return std::max(0.0f, box.x - origin.x);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t maxColliders = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 20000;
+    const int frames = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+
+    printf("AABB tree benchmark: up to %zu colliders, %d frames\n", maxColliders, frames);
+    printf("  %-10s %10s %12s %14s %12s %8s %9s\n", "colliders", "overlaps", "all-pairs", "spatial hash", "AABB tree",
+           "height", "speedup");
+
+    bool ok = true;
+    std::mt19937 rng(4321);
+    for (size_t count = 1000; count <= maxColliders; count *= 2) {
+        if (count * 2 > maxColliders && count != maxColliders) {
+            count = maxColliders; // Always finish on the requested size
+        }
+        std::vector<Box> boxes = makeScene(count, rng);
+
+        SpatialHash grid(64.0f);
+        AABBTree staticTree(0.0f);
+        AABBTree dynamicTree(4.0f);
+        std::vector<int32_t> proxies(boxes.size(), AABBTree::NULL_NODE);
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].isStatic) {
+                grid.insertStatic(i, boxes[i].bounds);
+                staticTree.createProxy(boxes[i].bounds, i);
+            } else {
+                proxies[i] = dynamicTree.createProxy(boxes[i].bounds, i);
+            }
+        }
+
+        std::vector<SpatialHash::Pair> pairs;
+        double gridMs = 0.0;
+        double treeMs = 0.0;
+        size_t expected = 0;
+        for (int frame = 0; frame < frames; ++frame) {
+            moveBoxes(boxes);
+
+            if (frame == 0) {
+                expected = allPairs(boxes); // Quadratic; checked once
+            }
+
+            auto start = Clock::now();
+            const size_t gridFound = gridPairs(grid, boxes, pairs);
+            double ms = elapsedMs(start);
+            gridMs = frame == 0 ? ms : std::min(gridMs, ms);
+
+            start = Clock::now();
+            const size_t treeFound = treePairs(staticTree, dynamicTree, proxies, boxes);
+            ms = elapsedMs(start);
+            treeMs = frame == 0 ? ms : std::min(treeMs, ms);
+
+            if (frame == 0 && (gridFound != expected || treeFound != expected)) {
+                printf("ERROR: all-pairs found %zu overlaps, spatial hash %zu, AABB tree %zu\n", expected, gridFound,
+                       treeFound);
+                ok = false;
+            }
+        }
+
+        auto start = Clock::now();
+        allPairs(boxes);
+        const double allPairsMs = elapsedMs(start);
+
+        printf("  %-10zu %10zu %9.2f ms %11.3f ms %9.3f ms %8d %8.1fx\n", count, expected, allPairsMs, gridMs, treeMs,
+               dynamicTree.getHeight(), treeMs > 0.0 ? allPairsMs / treeMs : 0.0);
+
+        if (count == maxColliders) {
+            // Ray casts at the largest size: nearest hit through the tree
+            // against a scan of every box
+            const int rays = 2000;
+            std::uniform_real_distribution<float> height(0.0f, std::sqrt(static_cast<float>(count)) * 40.0f);
+            std::vector<Vector2> origins;
+            for (int i = 0; i < rays; ++i) origins.push_back(Vector2(-10.0f, height(rng)));
+
+            start = Clock::now();
+            double scanTotal = 0.0;
+            for (const Vector2& origin : origins) {
+                float nearest = -1.0f;
+                for (const Box& box : boxes) {
+                    const float distance = rayDistance(box.bounds, origin);
+                    if (distance >= 0.0f && (nearest < 0.0f || distance < nearest)) nearest = distance;
+                }
+                scanTotal += nearest;
+            }
+            const double scanMs = elapsedMs(start);
+
+            start = Clock::now();
+            double treeTotal = 0.0;
+            for (const Vector2& origin : origins) {
+                float nearest = -1.0f;
+                auto hit = [&](uint32_t id) {
+                    const float distance = rayDistance(boxes[id].bounds, origin);
+                    if (distance < 0.0f) return 1.0e9f;
+                    if (nearest < 0.0f || distance < nearest) nearest = distance;
+                    return nearest;
+                };
+                staticTree.raycast(origin, Vector2(1.0f, 0.0f), 1.0e9f, hit);
+                dynamicTree.raycast(origin, Vector2(1.0f, 0.0f), nearest < 0.0f ? 1.0e9f : nearest, hit);
+                treeTotal += nearest;
+            }
+            const double treeRayMs = elapsedMs(start);
+
+            printf("  %d ray casts: linear scan %.2f ms, AABB tree %.2f ms\n", rays, scanMs, treeRayMs);
+            if (scanTotal != treeTotal) {
+                printf("ERROR: ray cast results differ\n");
+                ok = false;
+            }
+            break;
+        }
+    }
+    return ok ? 0 : 1;
+}
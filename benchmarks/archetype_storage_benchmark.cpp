@@ -0,0 +1,159 @@
+// Archetype storage microbenchmark
+//
+// Runs the same physics-style workload through ComponentManager in both
+// storage modes: per-component sparse-set pools and archetype SoA chunks.
+// A third of the entities carry an extra Name and a quarter a Collider, so
+// the archetype side is split across several archetypes like a real scene.
+//
+// Usage: archetype_storage_benchmark [entityCount] [frames]
+
+#include "BenchmarkCommon.h"
+#include "components/ComponentManager.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace Benchmark;
+
+void integrate(Transform& transform, RigidBody& rigidBody, float deltaTime) {
+    rigidBody.velocity = rigidBody.velocity + (rigidBody.acceleration * deltaTime);
+    rigidBody.velocity = rigidBody.velocity * rigidBody.drag;
+    transform.position = transform.position + (rigidBody.velocity * deltaTime);
+    rigidBody.acceleration = Vector2(0, 0);
+}
+
+struct Result {
+    double populateMs = 0.0;
+    double updateMs = 0.0;
+    double churnMs = 0.0;
+    float checksum = 0.0f;
+};
+
+void registerComponents(ComponentManager& components) {
+    components.registerComponent<Name>();
+    components.registerComponent<Transform>();
+    components.registerComponent<RigidBody>();
+    components.registerComponent<Collider>();
+}
+
+void populate(ComponentManager& components, const std::vector<EntityID>& entities) {
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const EntityID entity = entities[i];
+        components.addComponent(entity, Transform(static_cast<float>(i), 0.0f));
+        RigidBody body;
+        body.velocity = Vector2(1.0f, 2.0f);
+        components.addComponent(entity, std::move(body));
+        if (i % 3 == 0) components.addComponent(entity, Name("Entity"));
+        if (i % 4 == 0) components.addComponent(entity, Collider(16.0f, 16.0f));
+    }
+}
+
+// Remove and re-add RigidBody on every tenth entity - a structural change that
+// moves the entity between archetypes in archetype mode
+void churn(ComponentManager& components, const std::vector<EntityID>& entities) {
+    for (size_t i = 0; i < entities.size(); i += 10) {
+        components.removeComponent<RigidBody>(entities[i]);
+    }
+    for (size_t i = 0; i < entities.size(); i += 10) {
+        components.addComponent(entities[i], RigidBody());
+    }
+}
+
+float checksum(ComponentManager& components, const std::vector<EntityID>& entities) {
+    float sum = 0.0f;
+    for (EntityID entity : entities) {
+        sum += components.getComponent<Transform>(entity).position.x;
+    }
+    return sum;
+}
+
+// Systems today: walk the entity set and look up each component per entity
+Result runSparseSet(const std::vector<EntityID>& entities, int frames) {
+    ComponentManager components;
+    registerComponents(components);
+    Result result;
+
+    auto start = Clock::now();
+    populate(components, entities);
+    result.populateMs = elapsedMs(start);
+
+    start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (EntityID entity : entities) {
+            integrate(components.getComponent<Transform>(entity),
+                      components.getComponent<RigidBody>(entity), 1.0f / 60.0f);
+        }
+    }
+    result.updateMs = elapsedMs(start);
+    result.checksum = checksum(components, entities);
+
+    start = Clock::now();
+    churn(components, entities);
+    result.churnMs = elapsedMs(start);
+    return result;
+}
+
+Result runArchetype(const std::vector<EntityID>& entities, int frames) {
+    ComponentManager components;
+    registerComponents(components);
+    components.setStorageMode(StorageMode::Archetype);
+    Result result;
+
+    auto start = Clock::now();
+    populate(components, entities);
+    result.populateMs = elapsedMs(start);
+
+    start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        components.forEachChunk<Transform, RigidBody>(
+            [](size_t count, const EntityID*, Transform* transforms, RigidBody* rigidBodies) {
+                for (size_t i = 0; i < count; ++i) {
+                    integrate(transforms[i], rigidBodies[i], 1.0f / 60.0f);
+                }
+            });
+    }
+    result.updateMs = elapsedMs(start);
+    result.checksum = checksum(components, entities);
+
+    start = Clock::now();
+    churn(components, entities);
+    result.churnMs = elapsedMs(start);
+    return result;
+}
+
+void printRow(const char* label, const Result& sparse, const Result& archetype, double Result::*field) {
+    const double before = sparse.*field;
+    const double after = archetype.*field;
+    printf("  %-10s %10.2f ms %10.2f ms %8.2fx\n", label, before, after, after > 0.0 ? before / after : 0.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t entityCount = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 50000;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 100;
+
+    std::vector<EntityID> entities(entityCount);
+    for (size_t i = 0; i < entityCount; ++i) {
+        entities[i] = Entity::makeHandle(static_cast<uint32_t>(i + 1), 0);
+    }
+
+    printf("Archetype storage benchmark: %zu entities, %d frames\n", entityCount, frames);
+
+    Result sparse = runSparseSet(entities, frames);
+    Result archetype = runArchetype(entities, frames);
+
+    printf("  %-10s %13s %13s %9s\n", "", "sparse-set", "archetype", "speedup");
+    printRow("populate", sparse, archetype, &Result::populateMs);
+    printRow("update", sparse, archetype, &Result::updateMs);
+    printRow("churn", sparse, archetype, &Result::churnMs);
+
+    if (sparse.checksum != archetype.checksum) {
+        printf("ERROR: checksum mismatch (%f vs %f)\n", sparse.checksum, archetype.checksum);
+        return 1;
+    }
+    return 0;
+}
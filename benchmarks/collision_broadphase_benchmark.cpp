@@ -0,0 +1,157 @@
+// Collision broadphase microbenchmark
+//
+// Level-like collider sets - three quarters static tiles on a grid, the rest
+// moving 24px bodies scattered over the same area - at increasing sizes:
+//   - all-pairs overlap test, as CollisionSystem did before the broadphase
+//   - SpatialHash with the static tiles inserted once and the moving bodies
+//     re-inserted every frame, followed by the same exact test
+//   - a full CollisionSystem::update on a Scene (events and response included)
+// The two overlap counts are compared; exits non-zero if they differ.
+//
+// Usage: collision_broadphase_benchmark [maxColliders] [frames]
+
+#include "BenchmarkCommon.h"
+#include "physics/SpatialHash.h"
+#include "scene/Scene.h"
+#include "systems/CoreSystems.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace Benchmark;
+
+struct Box {
+    Rect bounds;
+    bool isStatic;
+};
+
+// Tiles fill a square grid; bodies are spread over the same area
+std::vector<Box> makeLevel(size_t count, std::mt19937& rng) {
+    const size_t tiles = count * 3 / 4;
+    const size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(tiles))) + 1;
+    const float extent = static_cast<float>(side) * 48.0f;
+    std::uniform_real_distribution<float> position(0.0f, extent);
+
+    std::vector<Box> boxes;
+    boxes.reserve(count);
+    for (size_t i = 0; i < tiles; ++i) {
+        boxes.push_back({Rect(static_cast<float>(i % side) * 48.0f, static_cast<float>(i / side) * 48.0f, 32.0f, 32.0f), true});
+    }
+    while (boxes.size() < count) {
+        boxes.push_back({Rect(position(rng), position(rng), 24.0f, 24.0f), false});
+    }
+    return boxes;
+}
+
+void moveBodies(std::vector<Box>& boxes, int frame) {
+    const float step = (frame % 2 == 0) ? 1.5f : -1.5f;
+    for (Box& box : boxes) {
+        if (!box.isStatic) box.bounds.x += step;
+    }
+}
+
+size_t allPairs(const std::vector<Box>& boxes) {
+    size_t overlaps = 0;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        for (size_t j = i + 1; j < boxes.size(); ++j) {
+            if (boxes[i].isStatic && boxes[j].isStatic) continue;
+            if (CollisionSystem::checkCollision(boxes[i].bounds, boxes[j].bounds)) ++overlaps;
+        }
+    }
+    return overlaps;
+}
+
+size_t hashedPairs(SpatialHash& hash, const std::vector<Box>& boxes, std::vector<SpatialHash::Pair>& pairs) {
+    hash.clearDynamic();
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        if (!boxes[i].isStatic) hash.insertDynamic(i, boxes[i].bounds);
+    }
+    hash.findPairs(pairs);
+
+    size_t overlaps = 0;
+    for (const SpatialHash::Pair& pair : pairs) {
+        if (CollisionSystem::checkCollision(boxes[pair.a].bounds, boxes[pair.b].bounds)) ++overlaps;
+    }
+    return overlaps;
+}
+
+double collisionSystemFrame(const std::vector<Box>& boxes, int frames) {
+    Scene scene;
+    scene.initialize();
+    auto collisionSystem = scene.registerSystem<CollisionSystem>();
+    collisionSystem->setScene(&scene);
+    ComponentMask signature;
+    signature.set(scene.getComponentType<Transform>());
+    signature.set(scene.getComponentType<Collider>());
+    scene.setSystemSignature<CollisionSystem>(signature);
+
+    for (const Box& box : boxes) {
+        const EntityID entity = scene.createEntity();
+        scene.addComponent(entity, Transform(box.bounds.x, box.bounds.y));
+        Collider collider(box.bounds.width, box.bounds.height);
+        collider.isStatic = box.isStatic;
+        scene.addComponent(entity, collider);
+    }
+
+    collisionSystem->update(1.0f / 60.0f); // Builds the static set
+    return bestOf(frames, [&collisionSystem]() {
+        const auto start = Clock::now();
+        collisionSystem->update(1.0f / 60.0f);
+        return elapsedMs(start);
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t maxColliders = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 20000;
+    const int frames = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+
+    printf("Collision broadphase benchmark: up to %zu colliders, %d frames\n", maxColliders, frames);
+    printf("  %-10s %10s %14s %14s %9s %16s\n", "colliders", "overlaps", "all-pairs", "spatial hash", "speedup", "CollisionSystem");
+
+    bool ok = true;
+    std::mt19937 rng(1234);
+    for (size_t count = 1000; count <= maxColliders; count *= 2) {
+        if (count * 2 > maxColliders && count != maxColliders) {
+            count = maxColliders; // Always finish on the requested size
+        }
+        std::vector<Box> boxes = makeLevel(count, rng);
+
+        // All-pairs is quadratic; one frame is enough to see it
+        auto start = Clock::now();
+        const size_t expected = allPairs(boxes);
+        const double allPairsMs = elapsedMs(start);
+
+        SpatialHash hash(64.0f);
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].isStatic) hash.insertStatic(i, boxes[i].bounds);
+        }
+        std::vector<SpatialHash::Pair> pairs;
+        size_t found = hashedPairs(hash, boxes, pairs);
+        if (found != expected) {
+            printf("ERROR: spatial hash found %zu overlaps, all-pairs %zu\n", found, expected);
+            ok = false;
+        }
+
+        int frame = 0;
+        const double hashMs = bestOf(frames, [&]() {
+            moveBodies(boxes, frame++);
+            const auto hashStart = Clock::now();
+            found = hashedPairs(hash, boxes, pairs);
+            return elapsedMs(hashStart);
+        });
+
+        const double systemMs = collisionSystemFrame(boxes, frames);
+        printf("  %-10zu %10zu %11.2f ms %11.3f ms %8.1fx %13.3f ms\n", count, expected, allPairsMs, hashMs,
+               hashMs > 0.0 ? allPairsMs / hashMs : 0.0, systemMs);
+        if (count == maxColliders) break;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,185 @@
+// Pixel collision mask microbenchmark
+//
+// Irregular masks (blobs of random discs, some with holes) of 16 to 160
+// pixels a side, paired at random whole-pixel offsets where their boxes
+// overlap, times:
+//   - a per-pixel test over the overlap, reading bool grids the way
+//     CollisionEditorWindow stores a painted mask
+//   - CollisionMask::overlaps, shifted word ANDs, for every instruction set
+//     the CPU supports, and the overload that picks one itself
+// Every result is compared with the per-pixel one; exits non-zero if any
+// differ.
+//
+// Each round runs every variant once, so a slow patch on a busy machine
+// lands on all of them; the best round of each is kept.
+//
+// Usage: collision_mask_benchmark [pairs] [rounds]
+
+#include "BenchmarkCommon.h"
+#include "physics/CollisionMask.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace Benchmark;
+
+struct Shape {
+    int width;
+    int height;
+    std::vector<std::vector<bool>> pixels; // [y][x]
+    CollisionMask mask;
+};
+
+Shape makeShape(std::mt19937& rng) {
+    std::uniform_int_distribution<int> side(16, 160);
+    Shape shape;
+    shape.width = side(rng);
+    shape.height = side(rng);
+    shape.pixels.assign(shape.height, std::vector<bool>(shape.width, false));
+
+    // A few discs, and sometimes a hole punched through them
+    auto disc = [&shape](float cx, float cy, float radius, bool solid) {
+        for (int y = 0; y < shape.height; ++y) {
+            for (int x = 0; x < shape.width; ++x) {
+                const float dx = x + 0.5f - cx;
+                const float dy = y + 0.5f - cy;
+                if (dx * dx + dy * dy <= radius * radius) shape.pixels[y][x] = solid;
+            }
+        }
+    };
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const float smaller = static_cast<float>(std::min(shape.width, shape.height));
+    const int discs = 2 + static_cast<int>(unit(rng) * 4);
+    for (int i = 0; i < discs; ++i) {
+        disc(unit(rng) * shape.width, unit(rng) * shape.height, smaller * (0.15f + 0.3f * unit(rng)), true);
+    }
+    if (unit(rng) < 0.5f) {
+        disc(shape.width * 0.5f, shape.height * 0.5f, smaller * 0.2f, false);
+    }
+
+    shape.mask = CollisionMask(shape.width, shape.height);
+    for (int y = 0; y < shape.height; ++y) {
+        for (int x = 0; x < shape.width; ++x) {
+            shape.mask.set(x, y, shape.pixels[y][x]);
+        }
+    }
+    return shape;
+}
+
+struct Pair {
+    const Shape* a;
+    const Shape* b;
+    int dx; // b's top-left corner relative to a's
+    int dy;
+};
+
+bool perPixel(const Pair& pair) {
+    const Shape& a = *pair.a;
+    const Shape& b = *pair.b;
+    const int rowBegin = std::max(0, pair.dy);
+    const int rowEnd = std::min(a.height, pair.dy + b.height);
+    const int columnBegin = std::max(0, pair.dx);
+    const int columnEnd = std::min(a.width, pair.dx + b.width);
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        for (int x = columnBegin; x < columnEnd; ++x) {
+            if (a.pixels[y][x] && b.pixels[y - pair.dy][x - pair.dx]) return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t pairCount = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 200000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::mt19937 rng(1234);
+    std::vector<Shape> shapes;
+    for (int i = 0; i < 64; ++i) {
+        shapes.push_back(makeShape(rng));
+    }
+
+    // Offsets where the boxes overlap, so every pair reaches the pixel test
+    std::vector<Pair> pairs;
+    std::uniform_int_distribution<size_t> pick(0, shapes.size() - 1);
+    for (size_t i = 0; i < pairCount; ++i) {
+        const Shape& a = shapes[pick(rng)];
+        const Shape& b = shapes[pick(rng)];
+        std::uniform_int_distribution<int> dx(-b.width + 1, a.width - 1);
+        std::uniform_int_distribution<int> dy(-b.height + 1, a.height - 1);
+        pairs.push_back({&a, &b, dx(rng), dy(rng)});
+    }
+
+    printf("Collision mask benchmark: %zu pairs of overlapping boxes, best of %d rounds\n", pairs.size(), rounds);
+
+    // Variant 0 is the default overload, then one per supported instruction set
+    std::vector<InstructionSet> instructionSets;
+    for (InstructionSet instructionSet : {InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2}) {
+        if (Simd::isSupported(instructionSet)) {
+            instructionSets.push_back(instructionSet);
+        } else {
+            printf("  %-24s not supported\n", Simd::getName(instructionSet));
+        }
+    }
+    const int variantCount = 1 + static_cast<int>(instructionSets.size());
+
+    std::vector<char> expected(pairs.size());
+    std::vector<char> results(pairs.size());
+    double perPixelMs = 0.0;
+    std::vector<double> bestMs(variantCount, 0.0);
+    std::vector<char> identical(variantCount, 1);
+    for (int round = 0; round < rounds; ++round) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            expected[i] = perPixel(pairs[i]);
+        }
+        double ms = elapsedMs(start);
+        perPixelMs = round == 0 ? ms : std::min(perPixelMs, ms);
+
+        for (int variant = 0; variant < variantCount; ++variant) {
+            start = Clock::now();
+            if (variant == 0) {
+                for (size_t i = 0; i < pairs.size(); ++i) {
+                    const Pair& pair = pairs[i];
+                    results[i] = CollisionMask::overlaps(pair.a->mask, Vector2(0.0f, 0.0f), pair.b->mask,
+                                                         Vector2(static_cast<float>(pair.dx), static_cast<float>(pair.dy)));
+                }
+            } else {
+                const InstructionSet instructionSet = instructionSets[variant - 1];
+                for (size_t i = 0; i < pairs.size(); ++i) {
+                    const Pair& pair = pairs[i];
+                    results[i] = CollisionMask::overlaps(pair.a->mask, Vector2(0.0f, 0.0f), pair.b->mask,
+                                                         Vector2(static_cast<float>(pair.dx), static_cast<float>(pair.dy)),
+                                                         instructionSet);
+                }
+            }
+            ms = elapsedMs(start);
+            bestMs[variant] = round == 0 ? ms : std::min(bestMs[variant], ms);
+            identical[variant] = identical[variant] && results == expected;
+        }
+    }
+
+    size_t hits = 0;
+    for (char hit : expected) hits += hit ? 1 : 0;
+    printf("  %-24s %10.3f ms  %zu hits\n", "per-pixel bool grid", perPixelMs, hits);
+
+    bool ok = true;
+    for (int variant = 0; variant < variantCount; ++variant) {
+        ok = ok && identical[variant];
+        char label[64];
+        if (variant == 0) {
+            snprintf(label, sizeof(label), "bitset default");
+        } else {
+            snprintf(label, sizeof(label), "bitset %s", Simd::getName(instructionSets[variant - 1]));
+        }
+        printf("  %-24s %10.3f ms  %6.1fx  %s\n", label, bestMs[variant], perPixelMs / bestMs[variant],
+               identical[variant] ? "identical" : "DIFFERS");
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+// Component storage microbenchmark
+//
+// Compares the sparse-set ComponentArray that backs ComponentManager against
+// the previous hash-map based layout on a physics-style workload.
+//
+// Usage: component_storage_benchmark [entityCount] [frames]
+
+#include "BenchmarkCommon.h"
+#include "components/ComponentArray.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using namespace Benchmark;
+
+// Copy of the original ComponentArray layout (two unordered_maps in front of
+// a fixed array) kept here as the baseline
+template<typename T>
+class LegacyComponentArray {
+public:
+    explicit LegacyComponentArray(size_t capacity) : m_componentArray(capacity) {}
+
+    void insertData(EntityID entity, T&& component) {
+        m_entityToIndexMap[entity] = m_size;
+        m_indexToEntityMap[m_size] = entity;
+        m_componentArray[m_size] = std::forward<T>(component);
+        ++m_size;
+    }
+
+    void removeData(EntityID entity) {
+        auto it = m_entityToIndexMap.find(entity);
+        if (it == m_entityToIndexMap.end()) return;
+
+        const size_t indexOfRemovedEntity = it->second;
+        const size_t indexOfLastElement = m_size - 1;
+        if (indexOfRemovedEntity != indexOfLastElement) {
+            m_componentArray[indexOfRemovedEntity] = std::move(m_componentArray[indexOfLastElement]);
+            const EntityID entityOfLastElement = m_indexToEntityMap[indexOfLastElement];
+            m_entityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
+            m_indexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
+        }
+        m_entityToIndexMap.erase(entity);
+        m_indexToEntityMap.erase(indexOfLastElement);
+        --m_size;
+    }
+
+    T& getData(EntityID entity) {
+        return m_componentArray[m_entityToIndexMap.at(entity)];
+    }
+
+    bool hasData(EntityID entity) const {
+        return m_entityToIndexMap.find(entity) != m_entityToIndexMap.end();
+    }
+
+private:
+    std::vector<T> m_componentArray;
+    std::unordered_map<EntityID, size_t> m_entityToIndexMap;
+    std::unordered_map<size_t, EntityID> m_indexToEntityMap;
+    size_t m_size = 0;
+};
+
+void integrate(Transform& transform, RigidBody& rigidBody, float deltaTime) {
+    rigidBody.velocity = rigidBody.velocity + (rigidBody.acceleration * deltaTime);
+    rigidBody.velocity = rigidBody.velocity * rigidBody.drag;
+    transform.position = transform.position + (rigidBody.velocity * deltaTime);
+    rigidBody.acceleration = Vector2(0, 0);
+}
+
+struct Result {
+    double insertMs = 0.0;
+    double updateMs = 0.0;
+    double probeMs = 0.0;
+    double removeMs = 0.0;
+    float checksum = 0.0f;
+};
+
+template<typename TransformPool, typename BodyPool>
+Result runWorkload(TransformPool& transforms, BodyPool& bodies,
+                   const std::vector<EntityID>& entities, const std::vector<EntityID>& probes, int frames) {
+    Result result;
+
+    auto start = Clock::now();
+    for (EntityID entity : entities) {
+        transforms.insertData(entity, Transform(static_cast<float>(entity), 0.0f));
+        RigidBody body;
+        body.velocity = Vector2(1.0f, 2.0f);
+        bodies.insertData(entity, std::move(body));
+    }
+    result.insertMs = elapsedMs(start);
+
+    // Per-entity joins, the way systems walk their entity sets today
+    start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        for (EntityID entity : entities) {
+            integrate(transforms.getData(entity), bodies.getData(entity), 1.0f / 60.0f);
+        }
+    }
+    result.updateMs = elapsedMs(start);
+
+    start = Clock::now();
+    size_t hits = 0;
+    for (EntityID entity : probes) {
+        hits += transforms.hasData(entity) ? 1 : 0;
+    }
+    result.probeMs = elapsedMs(start);
+
+    for (EntityID entity : entities) {
+        result.checksum += transforms.getData(entity).position.x;
+    }
+    result.checksum += static_cast<float>(hits);
+
+    start = Clock::now();
+    for (size_t i = 0; i < entities.size(); i += 2) {
+        transforms.removeData(entities[i]);
+        bodies.removeData(entities[i]);
+    }
+    result.removeMs = elapsedMs(start);
+    return result;
+}
+
+// Same workload, but walking the dense RigidBody array directly
+double runSparseSetDense(const std::vector<EntityID>& entities, int frames, float& checksum) {
+    ComponentArray<Transform> transforms;
+    ComponentArray<RigidBody> bodies;
+    for (EntityID entity : entities) {
+        transforms.insertData(entity, Transform(static_cast<float>(entity), 0.0f));
+        RigidBody body;
+        body.velocity = Vector2(1.0f, 2.0f);
+        bodies.insertData(entity, std::move(body));
+    }
+
+    auto start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        const EntityID* owners = bodies.entities();
+        for (size_t chunk = 0; chunk < bodies.chunkCount(); ++chunk) {
+            RigidBody* body = bodies.chunkData(chunk);
+            const size_t count = bodies.chunkSize(chunk);
+            for (size_t i = 0; i < count; ++i) {
+                integrate(transforms.getData(owners[i]), body[i], 1.0f / 60.0f);
+            }
+            owners += count;
+        }
+    }
+    double updateMs = elapsedMs(start);
+
+    checksum = 0.0f;
+    for (EntityID entity : entities) {
+        checksum += transforms.getData(entity).position.x;
+    }
+    return updateMs;
+}
+
+void printRow(const char* label, const Result& legacy, const Result& sparse, double Result::*field) {
+    const double before = legacy.*field;
+    const double after = sparse.*field;
+    printf("  %-10s %10.2f ms %10.2f ms %8.2fx\n", label, before, after, after > 0.0 ? before / after : 0.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t entityCount = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 50000;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 100;
+
+    // Shuffled IDs so the workload is not accidentally sequential
+    std::vector<EntityID> entities(entityCount);
+    for (size_t i = 0; i < entityCount; ++i) {
+        entities[i] = static_cast<EntityID>(i + 1);
+    }
+    std::mt19937 rng(12345);
+    std::shuffle(entities.begin(), entities.end(), rng);
+
+    std::vector<EntityID> probes(entityCount * 4);
+    std::uniform_int_distribution<EntityID> dist(1, static_cast<EntityID>(entityCount * 2));
+    for (auto& probe : probes) {
+        probe = dist(rng);
+    }
+
+    printf("Component storage benchmark: %zu entities, %d frames\n", entityCount, frames);
+
+    LegacyComponentArray<Transform> legacyTransforms(entityCount);
+    LegacyComponentArray<RigidBody> legacyBodies(entityCount);
+    Result legacy = runWorkload(legacyTransforms, legacyBodies, entities, probes, frames);
+
+    ComponentArray<Transform> transforms;
+    ComponentArray<RigidBody> bodies;
+    Result sparse = runWorkload(transforms, bodies, entities, probes, frames);
+
+    float denseChecksum = 0.0f;
+    double denseMs = runSparseSetDense(entities, frames, denseChecksum);
+
+    printf("  %-10s %13s %13s %9s\n", "", "hash-map", "sparse-set", "speedup");
+    printRow("insert", legacy, sparse, &Result::insertMs);
+    printRow("update", legacy, sparse, &Result::updateMs);
+    printRow("probe", legacy, sparse, &Result::probeMs);
+    printRow("remove", legacy, sparse, &Result::removeMs);
+    printf("  %-10s %10.2f ms %10.2f ms %8.2fx  (dense iteration)\n", "update",
+           legacy.updateMs, denseMs, denseMs > 0.0 ? legacy.updateMs / denseMs : 0.0);
+
+    if (legacy.checksum != sparse.checksum) {
+        printf("ERROR: checksum mismatch (%f vs %f)\n", legacy.checksum, sparse.checksum);
+        return 1;
+    }
+    return 0;
+}
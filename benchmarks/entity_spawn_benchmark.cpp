@@ -0,0 +1,69 @@
+// Entity spawning microbenchmark
+//
+// Spawns tile-like entities (Transform + Sprite + Name) into a Scene with the
+// built-in systems registered, once through per-entity createEntity /
+// addComponent calls and once through Scene::createEntities, in both storage
+// modes.
+//
+// Each variant runs several times on a fresh scene, alternating with the
+// other, and the best time is kept.
+//
+// Usage: entity_spawn_benchmark [entityCount] [repeats]
+
+#include "BenchmarkCommon.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+using namespace Benchmark;
+
+double spawnOneByOne(StorageMode mode, size_t count) {
+    auto scene = makeScene(mode);
+    const auto start = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        const EntityID entity = scene->createEntity();
+        scene->addComponent(entity, Transform(static_cast<float>(i), 0.0f));
+        scene->addComponent(entity, Sprite());
+        scene->setEntityName(entity, "Tile_" + std::to_string(i));
+    }
+    return elapsedMs(start);
+}
+
+double spawnBatch(StorageMode mode, size_t count) {
+    auto scene = makeScene(mode);
+    const auto start = Clock::now();
+    const std::vector<EntityID> entities = scene->createEntities(count, Transform(), Sprite(), Name());
+    for (size_t i = 0; i < count; ++i) {
+        scene->getComponent<Transform>(entities[i]).position.x = static_cast<float>(i);
+        // Named the same way as spawnOneByOne, so only spawning differs
+        scene->getComponent<Name>(entities[i]).name = "Tile_" + std::to_string(i);
+    }
+    return elapsedMs(start);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t entityCount = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 100000;
+    const int repeats = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+    printf("Entity spawn benchmark: %zu entities\n", entityCount);
+    printf("  %-12s %14s %14s %9s\n", "", "one-by-one", "batch", "speedup");
+    for (StorageMode mode : {StorageMode::SparseSet, StorageMode::Archetype}) {
+        // Alternate the variants so both see the same machine conditions
+        double single = spawnOneByOne(mode, entityCount);
+        double batch = spawnBatch(mode, entityCount);
+        for (int i = 1; i < repeats; ++i) {
+            single = std::min(single, spawnOneByOne(mode, entityCount));
+            batch = std::min(batch, spawnBatch(mode, entityCount));
+        }
+        printf("  %-12s %11.2f ms %11.2f ms %8.2fx\n",
+               mode == StorageMode::SparseSet ? "sparse-set" : "archetype",
+               single, batch, batch > 0.0 ? single / batch : 0.0);
+    }
+    return 0;
+}
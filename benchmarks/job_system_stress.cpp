@@ -0,0 +1,173 @@
+// Job system stress test
+//
+// Runs headless (no window, renderer or Engine) against a private JobSystem:
+//   - bursts of jobs that submit and wait on nested child jobs
+//   - parallel_for over an index range, checked element by element
+//   - parallel_for over a Transform/RigidBody view in both storage modes,
+//     checked against the same integration run serially
+// and prints per-worker utilisation. Exits non-zero on any mismatch.
+//
+// Usage: job_system_stress [workerCount] [entityCount] [rounds]
+
+#include "BenchmarkCommon.h"
+#include "core/JobSystem.h"
+#include "components/ComponentManager.h"
+#include "components/EntityManager.h"
+#include "components/View.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+using namespace Benchmark;
+
+void integrate(Transform& transform, RigidBody& rigidBody, float deltaTime) {
+    rigidBody.velocity = rigidBody.velocity + (rigidBody.acceleration * deltaTime);
+    rigidBody.velocity = rigidBody.velocity * rigidBody.drag;
+    transform.position = transform.position + (rigidBody.velocity * deltaTime);
+    rigidBody.acceleration = Vector2(0, 0);
+}
+
+bool nestedJobs(JobSystem& jobs, int rounds) {
+    const size_t parents = 64;
+    const size_t children = 32;
+
+    for (int round = 0; round < rounds; ++round) {
+        std::atomic<size_t> executed{0};
+        JobCounter parentCounter;
+        for (size_t parent = 0; parent < parents; ++parent) {
+            jobs.submit([&jobs, &executed]() {
+                JobCounter childCounter;
+                for (size_t child = 0; child < children; ++child) {
+                    jobs.submit([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); }, &childCounter);
+                }
+                jobs.wait(childCounter);
+            }, &parentCounter);
+        }
+        jobs.wait(parentCounter);
+
+        if (executed != parents * children) {
+            printf("ERROR: nested jobs ran %zu of %zu children\n", executed.load(), parents * children);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool rangeJobs(JobSystem& jobs, int rounds) {
+    std::vector<uint64_t> values(1 << 20);
+    for (int round = 0; round < rounds; ++round) {
+        jobs.parallel_for(0, values.size(), 4096, [&values, round](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                values[i] = i * 3 + static_cast<uint64_t>(round);
+            }
+        });
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i] != i * 3 + static_cast<uint64_t>(round)) {
+                printf("ERROR: parallel_for skipped index %zu\n", i);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Builds a scene-like component set; every fifth entity has no RigidBody so
+// the view has to skip candidates
+void populate(ComponentManager& components, EntityManager& entityManager, size_t entityCount) {
+    components.registerComponent<Transform>();
+    components.registerComponent<RigidBody>();
+
+    for (size_t i = 0; i < entityCount; ++i) {
+        const EntityID entity = entityManager.createEntity();
+        ComponentMask signature;
+
+        components.addComponent(entity, Transform(static_cast<float>(i), 0.0f));
+        signature.set(components.getComponentType<Transform>());
+        if (i % 5 != 0) {
+            RigidBody body;
+            body.velocity = Vector2(static_cast<float>(i % 7), 2.0f);
+            components.addComponent(entity, std::move(body));
+            signature.set(components.getComponentType<RigidBody>());
+        }
+        entityManager.setSignature(entity, signature);
+    }
+}
+
+bool viewJobs(JobSystem& jobs, StorageMode mode, size_t entityCount, int rounds, double& parallelMs) {
+    ComponentManager serialComponents;
+    ComponentManager parallelComponents;
+    EntityManager serialEntities;
+    EntityManager parallelEntities;
+    serialComponents.setStorageMode(mode);
+    parallelComponents.setStorageMode(mode);
+    populate(serialComponents, serialEntities, entityCount);
+    populate(parallelComponents, parallelEntities, entityCount);
+
+    for (int round = 0; round < rounds; ++round) {
+        View<Transform, RigidBody>(serialComponents, serialEntities).each(
+            [](EntityID, Transform& transform, RigidBody& rigidBody) {
+                integrate(transform, rigidBody, 1.0f / 60.0f);
+            });
+    }
+
+    const auto start = Clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        View<Transform, RigidBody> bodies(parallelComponents, parallelEntities);
+        jobs.parallel_for(bodies, 256, [](EntityID, Transform& transform, RigidBody& rigidBody) {
+            integrate(transform, rigidBody, 1.0f / 60.0f);
+        });
+    }
+    parallelMs = elapsedMs(start);
+
+    for (uint32_t index = 1; index <= entityCount; ++index) {
+        const EntityID entity = parallelEntities.getEntityAtIndex(index);
+        const Vector2 expected = serialComponents.getComponent<Transform>(entity).position;
+        const Vector2 actual = parallelComponents.getComponent<Transform>(entity).position;
+        if (expected.x != actual.x || expected.y != actual.y) {
+            printf("ERROR: view parallel_for diverged at entity %u\n", index);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t workerCount = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 0;
+    const size_t entityCount = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 100000;
+    const int rounds = argc > 3 ? std::atoi(argv[3]) : 50;
+
+    JobSystem jobs(workerCount);
+    printf("Job system stress test: %zu workers, %zu entities, %d rounds\n",
+           jobs.getWorkerCount(), entityCount, rounds);
+
+    bool ok = true;
+    auto start = Clock::now();
+    ok = nestedJobs(jobs, rounds) && ok;
+    printf("  %-22s %10.2f ms\n", "nested jobs", elapsedMs(start));
+
+    start = Clock::now();
+    ok = rangeJobs(jobs, rounds) && ok;
+    printf("  %-22s %10.2f ms\n", "parallel_for range", elapsedMs(start));
+
+    double parallelMs = 0.0;
+    ok = viewJobs(jobs, StorageMode::SparseSet, entityCount, rounds, parallelMs) && ok;
+    printf("  %-22s %10.2f ms\n", "view (sparse-set)", parallelMs);
+    ok = viewJobs(jobs, StorageMode::Archetype, entityCount, rounds, parallelMs) && ok;
+    printf("  %-22s %10.2f ms\n", "view (archetype)", parallelMs);
+
+    const std::vector<JobWorkerStats> stats = jobs.getWorkerStats();
+    printf("  %-8s %10s %10s %10s %12s\n", "worker", "jobs", "stolen", "busy s", "utilisation");
+    for (size_t i = 0; i < stats.size(); ++i) {
+        printf("  %-8zu %10llu %10llu %10.3f %11.1f%%\n", i,
+               static_cast<unsigned long long>(stats[i].jobsExecuted),
+               static_cast<unsigned long long>(stats[i].jobsStolen),
+               stats[i].busySeconds, stats[i].utilisation * 100.0);
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,277 @@
+// Rigid body integration microbenchmark
+//
+// Bodies with random velocities, forces, drag and gravity flags, times:
+//   - the old per-entity integration through Vector2 operators on the
+//     Transform and RigidBody components
+//   - BodyIntegrator alone over SoA streams, for every instruction set the
+//     CPU supports, deterministic and (AVX2) fused
+//   - PhysicsSystem::update in both storage modes for each instruction set,
+//     gathering the streams from the components and scattering them back,
+//     against the old per-entity update over the same view
+// Deterministic results of every instruction set are compared bit-for-bit
+// with the old per-entity integration; exits non-zero if any differ.
+//
+// Each variant runs several frames and the best frame is kept.
+//
+// Usage: physics_integration_benchmark [bodyCount] [frames]
+
+#include "BenchmarkCommon.h"
+#include "core/Engine.h"
+#include "core/JobSystem.h"
+#include "physics/BodyIntegrator.h"
+#include "scene/Scene.h"
+#include "systems/CoreSystems.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace Benchmark;
+
+const float DELTA_TIME = 1.0f / 60.0f;
+const float GRAVITY = 980.0f;
+
+struct Body {
+    Transform transform;
+    RigidBody rigidBody;
+};
+
+std::vector<Body> makeBodies(size_t count) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(0.0f, 4096.0f);
+    std::uniform_real_distribution<float> velocity(-300.0f, 300.0f);
+    std::uniform_real_distribution<float> drag(0.9f, 1.0f);
+
+    std::vector<Body> bodies(count);
+    for (Body& body : bodies) {
+        body.transform.position = Vector2(position(rng), position(rng));
+        body.rigidBody.velocity = Vector2(velocity(rng), velocity(rng));
+        body.rigidBody.drag = drag(rng);
+        body.rigidBody.useGravity = rng() % 2 == 0;
+    }
+    return bodies;
+}
+
+// Forces change every frame, as game code would apply them
+void applyForces(std::vector<Body>& bodies, int frame) {
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        const float force = static_cast<float>((i + frame) % 97) - 48.0f;
+        bodies[i].rigidBody.addForce(Vector2(force, -force * 0.5f));
+    }
+}
+
+// PhysicsSystem's integration before BodyIntegrator
+void integrateBody(Transform& transform, RigidBody& rigidBody, float deltaTime) {
+    if (rigidBody.useGravity) {
+        rigidBody.acceleration.y += GRAVITY * deltaTime;
+    }
+    rigidBody.velocity = rigidBody.velocity + (rigidBody.acceleration * deltaTime);
+    rigidBody.velocity = rigidBody.velocity * rigidBody.drag;
+    transform.position = transform.position + (rigidBody.velocity * deltaTime);
+    rigidBody.acceleration = Vector2(0, 0);
+}
+
+struct SoA {
+    std::vector<float> positionX, positionY, velocityX, velocityY, accelerationX, accelerationY, drag;
+    std::vector<uint32_t> gravityMask;
+
+    explicit SoA(const std::vector<Body>& bodies) {
+        for (const Body& body : bodies) {
+            positionX.push_back(body.transform.position.x);
+            positionY.push_back(body.transform.position.y);
+            velocityX.push_back(body.rigidBody.velocity.x);
+            velocityY.push_back(body.rigidBody.velocity.y);
+            accelerationX.push_back(body.rigidBody.acceleration.x);
+            accelerationY.push_back(body.rigidBody.acceleration.y);
+            drag.push_back(body.rigidBody.drag);
+            gravityMask.push_back(body.rigidBody.useGravity ? ~0u : 0u);
+        }
+    }
+
+    void applyForces(int frame) {
+        for (size_t i = 0; i < positionX.size(); ++i) {
+            const float force = static_cast<float>((i + frame) % 97) - 48.0f;
+            accelerationX[i] += force; // addForce() with a mass of 1
+            accelerationY[i] += -force * 0.5f;
+        }
+    }
+
+    BodyIntegrator::Streams streams() {
+        BodyIntegrator::Streams s;
+        s.positionX = positionX.data();
+        s.positionY = positionY.data();
+        s.velocityX = velocityX.data();
+        s.velocityY = velocityY.data();
+        s.accelerationX = accelerationX.data();
+        s.accelerationY = accelerationY.data();
+        s.drag = drag.data();
+        s.gravityMask = gravityMask.data();
+        s.count = positionX.size();
+        return s;
+    }
+};
+
+bool sameBits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+bool matches(const SoA& soa, const std::vector<Body>& expected) {
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (!sameBits(soa.positionX[i], expected[i].transform.position.x) ||
+            !sameBits(soa.positionY[i], expected[i].transform.position.y) ||
+            !sameBits(soa.velocityX[i], expected[i].rigidBody.velocity.x) ||
+            !sameBits(soa.velocityY[i], expected[i].rigidBody.velocity.y)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::unique_ptr<Scene> makeScene(StorageMode mode, const std::vector<Body>& bodies, PhysicsSystem*& physics,
+                                 std::vector<EntityID>& entities) {
+    auto scene = std::make_unique<Scene>();
+    scene->initialize();
+    scene->setStorageMode(mode);
+
+    auto system = scene->registerSystem<PhysicsSystem>();
+    system->setScene(scene.get());
+    ComponentMask signature;
+    signature.set(scene->getComponentType<Transform>());
+    signature.set(scene->getComponentType<RigidBody>());
+    scene->setSystemSignature<PhysicsSystem>(signature);
+    physics = system.get();
+
+    entities = scene->createEntities(bodies.size(), Transform(), RigidBody());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        scene->getComponent<Transform>(entities[i]) = bodies[i].transform;
+        scene->getComponent<RigidBody>(entities[i]) = bodies[i].rigidBody;
+    }
+    return scene;
+}
+
+bool sceneMatches(const Scene& scene, const std::vector<EntityID>& entities, const std::vector<Body>& expected) {
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const Transform& transform = scene.getComponent<Transform>(entities[i]);
+        const RigidBody& rigidBody = scene.getComponent<RigidBody>(entities[i]);
+        if (!sameBits(transform.position.x, expected[i].transform.position.x) ||
+            !sameBits(transform.position.y, expected[i].transform.position.y) ||
+            !sameBits(rigidBody.velocity.x, expected[i].rigidBody.velocity.x) ||
+            !sameBits(rigidBody.velocity.y, expected[i].rigidBody.velocity.y)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 100000;
+    const int frames = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+
+    printf("Physics integration benchmark: %zu bodies, %d frames\n", count, frames);
+    const std::vector<Body> initial = makeBodies(count);
+
+    // Reference: the old per-entity integration
+    std::vector<Body> expected = initial;
+    int oldFrame = 0;
+    const double oldMs = bestOf(frames, [&]() {
+        applyForces(expected, oldFrame++);
+        const auto start = Clock::now();
+        for (Body& body : expected) {
+            integrateBody(body.transform, body.rigidBody, DELTA_TIME);
+        }
+        return elapsedMs(start);
+    });
+    printf("  %-42s %9.3f ms\n", "per-body Vector2 (old)", oldMs);
+
+    bool ok = true;
+    const InstructionSet sets[] = {InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2};
+
+    // The integrator alone over SoA streams
+    for (const auto set : sets) {
+        if (!Simd::isSupported(set)) continue;
+        for (const bool deterministic : {true, false}) {
+            if (!deterministic && set != InstructionSet::AVX2) continue;
+
+            BodyIntegrator integrator(deterministic);
+            integrator.setInstructionSet(set);
+            SoA soa(initial);
+            int frame = 0;
+            const double best = bestOf(frames, [&]() {
+                soa.applyForces(frame++);
+                const auto start = Clock::now();
+                integrator.integrate(soa.streams(), DELTA_TIME, GRAVITY);
+                return elapsedMs(start);
+            });
+
+            const bool identical = matches(soa, expected);
+            char label[64];
+            snprintf(label, sizeof(label), "SoA %s%s", Simd::getName(set), deterministic ? "" : " (fused)");
+            printf("  %-42s %9.3f ms %8.1fx  %s\n", label, best, best > 0.0 ? oldMs / best : 0.0,
+                   identical ? "bit-identical" : "differs");
+            if (deterministic && !identical) {
+                printf("ERROR: deterministic %s results differ from the old integration\n", Simd::getName(set));
+                ok = false;
+            }
+        }
+    }
+
+    // The whole system: gather, integrate, scatter, spread over the job
+    // system; compared with the old per-entity update over the same view
+    for (const StorageMode mode : {StorageMode::SparseSet, StorageMode::Archetype}) {
+        const char* modeName = mode == StorageMode::Archetype ? "archetype" : "sparse-set";
+        double sceneOldMs = 0.0;
+        for (int variant = -1; variant < 3; ++variant) {
+            const bool old = variant < 0;
+            if (!old && !Simd::isSupported(sets[variant])) continue;
+
+            PhysicsSystem* physics = nullptr;
+            std::vector<EntityID> entities;
+            auto scene = makeScene(mode, initial, physics, entities);
+            if (!old) {
+                physics->getIntegrator().setInstructionSet(sets[variant]);
+            }
+            int frame = 0;
+            const double best = bestOf(frames, [&]() {
+                for (size_t body = 0; body < entities.size(); ++body) {
+                    const float force = static_cast<float>((body + frame) % 97) - 48.0f;
+                    scene->getComponent<RigidBody>(entities[body]).addForce(Vector2(force, -force * 0.5f));
+                }
+                ++frame;
+
+                const auto start = Clock::now();
+                if (old) {
+                    auto bodies = scene->view<Transform, RigidBody>().exclude<Static>();
+                    Engine::getInstance().getJobSystem().parallel_for(bodies, 256,
+                        [](EntityID, Transform& transform, RigidBody& rigidBody) {
+                            integrateBody(transform, rigidBody, DELTA_TIME);
+                        });
+                } else {
+                    physics->update(DELTA_TIME);
+                }
+                return elapsedMs(start);
+            });
+            if (old) {
+                sceneOldMs = best;
+            }
+
+            const bool identical = sceneMatches(*scene, entities, expected);
+            char label[64];
+            snprintf(label, sizeof(label), "PhysicsSystem %s %s", modeName,
+                     old ? "per-entity (old)" : Simd::getName(sets[variant]));
+            printf("  %-42s %9.3f ms %8.1fx  %s\n", label, best, best > 0.0 ? sceneOldMs / best : 0.0,
+                   identical ? "bit-identical" : "differs");
+            if (!identical) {
+                printf("ERROR: PhysicsSystem results differ from the old integration\n");
+                ok = false;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// Scene snapshot microbenchmark
+//
+// Builds a level-like scene (Transform + Sprite + Name on every entity, a
+// RigidBody on every fourth, Static on the rest) with the built-in systems
+// registered, then times in both storage modes:
+//   - copying it entity by entity through createEntity / addComponent, the
+//     way the editor's play mode used to
+//   - Scene::copyFrom into a fresh scene
+//   - Scene::snapshot into a reused SceneSnapshot and Scene::restore from it,
+//     the per-frame cost of rollback
+// Restored scenes are spot-checked against the source. Exits non-zero on any
+// mismatch.
+//
+// Each variant runs several times and the best time is kept.
+//
+// Usage: scene_snapshot_benchmark [entityCount] [repeats]
+
+#include "BenchmarkCommon.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace {
+
+using namespace Benchmark;
+
+std::unique_ptr<Scene> makeLevel(StorageMode mode, size_t count) {
+    auto scene = makeScene(mode);
+    const std::vector<EntityID> entities = scene->createEntities(count, Transform(), Sprite(), Name());
+    std::vector<EntityID> bodies;
+    std::vector<EntityID> walls;
+    char name[32];
+    for (size_t i = 0; i < count; ++i) {
+        scene->getComponent<Transform>(entities[i]).position = Vector2(static_cast<float>(i % 256) * 32.0f,
+                                                                       static_cast<float>(i / 256) * 32.0f);
+        snprintf(name, sizeof(name), "Tile_%zu", i);
+        scene->getComponent<Name>(entities[i]).name = name;
+        (i % 4 == 0 ? bodies : walls).push_back(entities[i]);
+    }
+    scene->addComponents(bodies, RigidBody());
+    scene->addComponents(walls, Static());
+    return scene;
+}
+
+// The editor's old play-mode copy: new entities, one component at a time
+double copyPerEntity(const Scene& source, StorageMode mode) {
+    auto copy = makeScene(mode);
+    const auto start = Clock::now();
+    for (EntityID entity : source.getAllLivingEntities()) {
+        const EntityID newEntity = copy->createEntity();
+        copy->addComponent(newEntity, source.getComponent<Name>(entity));
+        copy->addComponent(newEntity, source.getComponent<Transform>(entity));
+        copy->addComponent(newEntity, source.getComponent<Sprite>(entity));
+        if (source.hasComponent<RigidBody>(entity)) {
+            copy->addComponent(newEntity, source.getComponent<RigidBody>(entity));
+        }
+        if (source.hasComponent<Static>(entity)) {
+            copy->addComponent(newEntity, Static());
+        }
+    }
+    return elapsedMs(start);
+}
+
+double copyWholesale(const Scene& source, StorageMode mode) {
+    auto copy = makeScene(mode);
+    const auto start = Clock::now();
+    copy->copyFrom(source);
+    return elapsedMs(start);
+}
+
+bool matches(const Scene& scene, const Scene& reference) {
+    const std::vector<EntityID> entities = reference.getAllLivingEntities();
+    if (scene.getAllLivingEntities().size() != entities.size()) return false;
+    for (size_t i = 0; i < entities.size(); i += 97) {
+        const EntityID entity = entities[i];
+        if (!scene.isAlive(entity)) return false;
+        const Vector2 expected = reference.getComponent<Transform>(entity).position;
+        const Vector2 actual = scene.getComponent<Transform>(entity).position;
+        if (expected.x != actual.x || expected.y != actual.y) return false;
+        if (scene.getEntityName(entity) != reference.getEntityName(entity)) return false;
+        if (scene.hasComponent<Static>(entity) != reference.hasComponent<Static>(entity)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t entityCount = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 50000;
+    const int repeats = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+
+    printf("Scene snapshot benchmark: %zu entities\n", entityCount);
+    printf("  %-12s %14s %14s %14s %14s\n", "", "per-entity", "copyFrom", "snapshot", "restore");
+    bool ok = true;
+    for (StorageMode mode : {StorageMode::SparseSet, StorageMode::Archetype}) {
+        auto level = makeLevel(mode, entityCount);
+        auto reference = makeLevel(mode, entityCount);
+
+        const double perEntity = bestOf(repeats, [&]() { return copyPerEntity(*level, mode); });
+        const double wholesale = bestOf(repeats, [&]() { return copyWholesale(*level, mode); });
+
+        // Rollback: snapshot, simulate a frame, restore - into the same buffers every time
+        SceneSnapshot snapshot;
+        const double snapshotMs = bestOf(repeats, [&]() {
+            const auto start = Clock::now();
+            level->snapshot(snapshot);
+            return elapsedMs(start);
+        });
+        const double restoreMs = bestOf(repeats, [&]() {
+            level->update(1.0f / 60.0f);
+            const auto start = Clock::now();
+            level->restore(snapshot);
+            return elapsedMs(start);
+        });
+
+        const bool restored = matches(*level, *reference);
+        if (!restored) {
+            printf("ERROR: restored scene differs from the source\n");
+        }
+        ok = restored && ok;
+
+        printf("  %-12s %11.2f ms %11.2f ms %11.2f ms %11.2f ms\n",
+               mode == StorageMode::SparseSet ? "sparse-set" : "archetype",
+               perEntity, wholesale, snapshotMs, restoreMs);
+    }
+    return ok ? 0 : 1;
+}
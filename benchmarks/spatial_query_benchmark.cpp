@@ -0,0 +1,211 @@
+// Scene spatial query microbenchmark
+//
+// A scene of colliders of mixed sizes, times:
+//   - refreshSpatialIndex(), building the index and after a tenth moved
+//   - queryAABB, queryRadius, nearest(8) and raycast through the index
+//   - the same queries as a linear scan over view<Transform, Collider>(),
+//     the way PlayerSystem found overlapping colliders before
+// Every indexed result is compared with the scan's; exits non-zero if any
+// differ.
+//
+// Usage: spatial_query_benchmark [colliders] [queries]
+
+#include "BenchmarkCommon.h"
+#include "scene/Scene.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace Benchmark;
+
+float distanceSquared(const Vector2& point, const Rect& bounds) {
+    const float dx = std::max(std::max(bounds.x - point.x, point.x - (bounds.x + bounds.width)), 0.0f);
+    const float dy = std::max(std::max(bounds.y - point.y, point.y - (bounds.y + bounds.height)), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+bool overlaps(const Rect& a, const Rect& b) {
+    return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+// Entry distance of a unit-direction ray, or a negative value for a miss
+float rayDistance(const Vector2& origin, const Vector2& direction, float maxDistance, const Rect& bounds) {
+    float enter = 0.0f;
+    float exit = maxDistance;
+    const float origins[2] = {origin.x, origin.y};
+    const float directions[2] = {direction.x, direction.y};
+    const float mins[2] = {bounds.x, bounds.y};
+    const float maxs[2] = {bounds.x + bounds.width, bounds.y + bounds.height};
+    for (int axis = 0; axis < 2; ++axis) {
+        if (directions[axis] == 0.0f) {
+            if (origins[axis] < mins[axis] || origins[axis] > maxs[axis]) return -1.0f;
+            continue;
+        }
+        float near = (mins[axis] - origins[axis]) / directions[axis];
+        float far = (maxs[axis] - origins[axis]) / directions[axis];
+        if (near > far) std::swap(near, far);
+        enter = std::max(enter, near);
+        exit = std::min(exit, far);
+        if (enter > exit) return -1.0f;
+    }
+    return enter;
+}
+
+struct Query {
+    Rect area;
+    Vector2 point;
+    float radius;
+    Vector2 direction;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 20000;
+    const size_t queryCount = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 2000;
+    const float extent = std::sqrt(static_cast<float>(count)) * 48.0f;
+    const float rayLength = 400.0f;
+
+    printf("Spatial query benchmark: %zu colliders, %zu queries of each kind\n", count, queryCount);
+
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> position(0.0f, extent);
+    std::uniform_real_distribution<float> size(8.0f, 64.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+    Scene scene;
+    scene.initialize();
+    std::vector<EntityID> entities;
+    entities.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const EntityID entity = scene.createEntity();
+        scene.addComponent(entity, Transform(position(rng), position(rng)));
+        scene.addComponent(entity, Collider(size(rng), size(rng)));
+        entities.push_back(entity);
+    }
+
+    auto start = Clock::now();
+    scene.refreshSpatialIndex();
+    printf("  %-34s %9.3f ms\n", "initial build", elapsedMs(start));
+
+    for (size_t i = 0; i < entities.size(); i += 10) {
+        Transform& transform = scene.getComponent<Transform>(entities[i]);
+        transform.position = transform.position + Vector2(3.0f, -2.0f);
+    }
+    start = Clock::now();
+    scene.refreshSpatialIndex();
+    printf("  %-34s %9.3f ms\n", "refresh, 10% moved", elapsedMs(start));
+
+    std::vector<Query> queries(queryCount);
+    for (Query& query : queries) {
+        query.area = Rect(position(rng), position(rng), 96.0f, 96.0f);
+        query.point = Vector2(position(rng), position(rng));
+        query.radius = 120.0f;
+        const float a = angle(rng);
+        query.direction = Vector2(std::cos(a), std::sin(a));
+    }
+
+    bool ok = true;
+    auto report = [&](const char* name, double indexedMs, double scanMs, bool identical) {
+        printf("  %-34s %9.3f ms  scan %9.3f ms %8.1fx  %s\n", name, indexedMs, scanMs,
+               indexedMs > 0.0 ? scanMs / indexedMs : 0.0, identical ? "identical" : "differs");
+        if (!identical) {
+            printf("ERROR: %s results differ from the scan\n", name);
+            ok = false;
+        }
+    };
+    auto scan = [&](auto&& visit) {
+        scene.view<const Transform, const Collider>().each(
+            [&](EntityID entity, const Transform& transform, const Collider& collider) {
+                visit(entity, collider.getBounds(transform.position));
+            });
+    };
+
+    // queryAABB
+    {
+        size_t indexedHits = 0, scanHits = 0;
+        start = Clock::now();
+        for (const Query& query : queries) {
+            scene.queryAABB(query.area, [&](EntityID, const Rect&) { ++indexedHits; });
+        }
+        const double indexedMs = elapsedMs(start);
+        start = Clock::now();
+        for (const Query& query : queries) {
+            scan([&](EntityID, const Rect& bounds) { scanHits += overlaps(bounds, query.area) ? 1 : 0; });
+        }
+        report("queryAABB", indexedMs, elapsedMs(start), indexedHits == scanHits);
+    }
+
+    // queryRadius
+    {
+        size_t indexedHits = 0, scanHits = 0;
+        start = Clock::now();
+        for (const Query& query : queries) {
+            scene.queryRadius(query.point, query.radius, [&](EntityID, const Rect&) { ++indexedHits; });
+        }
+        const double indexedMs = elapsedMs(start);
+        start = Clock::now();
+        for (const Query& query : queries) {
+            const float radiusSquared = query.radius * query.radius;
+            scan([&](EntityID, const Rect& bounds) {
+                scanHits += distanceSquared(query.point, bounds) <= radiusSquared ? 1 : 0;
+            });
+        }
+        report("queryRadius", indexedMs, elapsedMs(start), indexedHits == scanHits);
+    }
+
+    // nearest(8)
+    {
+        const size_t k = 8;
+        std::vector<NearestHit> results;
+        std::vector<float> indexed, scanned;
+        start = Clock::now();
+        for (const Query& query : queries) {
+            scene.nearest(query.point, k, results);
+            for (const NearestHit& hit : results) indexed.push_back(hit.distance);
+        }
+        const double indexedMs = elapsedMs(start);
+        std::vector<float> distances;
+        start = Clock::now();
+        for (const Query& query : queries) {
+            distances.clear();
+            scan([&](EntityID, const Rect& bounds) { distances.push_back(distanceSquared(query.point, bounds)); });
+            std::partial_sort(distances.begin(), distances.begin() + std::min(k, distances.size()), distances.end());
+            for (size_t i = 0; i < std::min(k, distances.size()); ++i) scanned.push_back(std::sqrt(distances[i]));
+        }
+        report("nearest(8)", indexedMs, elapsedMs(start), indexed == scanned);
+    }
+
+    // raycast
+    {
+        std::vector<float> indexed, scanned;
+        RaycastHit hit;
+        start = Clock::now();
+        for (const Query& query : queries) {
+            indexed.push_back(scene.raycast(query.point, query.direction, rayLength, hit) ? hit.distance : -1.0f);
+        }
+        const double indexedMs = elapsedMs(start);
+        start = Clock::now();
+        for (const Query& query : queries) {
+            float best = -1.0f;
+            scan([&](EntityID, const Rect& bounds) {
+                const float distance = rayDistance(query.point, query.direction, rayLength, bounds);
+                if (distance >= 0.0f && (best < 0.0f || distance < best)) best = distance;
+            });
+            scanned.push_back(best);
+        }
+        const double scanMs = elapsedMs(start);
+        bool identical = indexed.size() == scanned.size();
+        for (size_t i = 0; identical && i < indexed.size(); ++i) {
+            identical = std::fabs(indexed[i] - scanned[i]) <= 1.0e-3f;
+        }
+        report("raycast", indexedMs, scanMs, identical);
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,708 @@
+#pragma once
+
+#include "Components.h"
+#include "ComponentArray.h"
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <string>
+#include <typeinfo>
+#include <type_traits>
+#include <utility>
+#include <stdexcept>
+
+// Type-erased description of a component type, so archetype chunks can move,
+// copy and destroy components without knowing their static type
+struct ComponentTypeInfo {
+    const char* name = nullptr;
+    size_t size = 0;
+    size_t alignment = 0;
+    bool triviallyCopyable = false; // Rows can be copied with memcpy
+    void (*moveConstruct)(void* destination, void* source) = nullptr;
+    void (*destroy)(void* object) = nullptr;
+    // moveConstruct followed by destroying source, in one call
+    void (*relocate)(void* destination, void* source) = nullptr;
+    // nullptr if T is not copyable
+    void (*copyConstruct)(void* destination, const void* source) = nullptr;
+    void (*copyAssign)(void* destination, const void* source) = nullptr;
+
+    template<typename T>
+    static ComponentTypeInfo of() {
+        ComponentTypeInfo info;
+        info.name = typeid(T).name();
+        info.size = sizeof(T);
+        info.alignment = alignof(T);
+        info.triviallyCopyable = std::is_trivially_copyable_v<T>;
+        info.moveConstruct = [](void* destination, void* source) {
+            new (destination) T(std::move(*static_cast<T*>(source)));
+        };
+        info.destroy = [](void* object) {
+            static_cast<T*>(object)->~T();
+        };
+        info.relocate = [](void* destination, void* source) {
+            T* from = static_cast<T*>(source);
+            new (destination) T(std::move(*from));
+            from->~T();
+        };
+        if constexpr (std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T>) {
+            info.copyConstruct = [](void* destination, const void* source) {
+                new (destination) T(*static_cast<const T*>(source));
+            };
+            info.copyAssign = [](void* destination, const void* source) {
+                *static_cast<T*>(destination) = *static_cast<const T*>(source);
+            };
+        }
+        return info;
+    }
+};
+
+// All entities that share one ComponentMask.
+//
+// Rows live in fixed ~16 KB chunks laid out as structure-of-arrays: an
+// EntityID column followed by one column per component type, each aligned for
+// its type. Removing a row moves the last row into the gap, so every chunk but
+// the last is always full and columns can be streamed without lookups.
+// Every column also keeps a row-indexed array of ComponentTicks.
+class Archetype {
+public:
+    static constexpr uint32_t INVALID_COLUMN = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t NO_EDGE = std::numeric_limits<uint32_t>::max();
+
+    Archetype(const ComponentMask& mask, const std::vector<ComponentTypeInfo>& typeInfos)
+        : m_mask(mask) {
+        m_columnOf.fill(INVALID_COLUMN);
+        m_addEdges.fill(NO_EDGE);
+        m_removeEdges.fill(NO_EDGE);
+
+        size_t bytesPerRow = sizeof(EntityID);
+        for (ComponentType type = 0; type < MAX_COMPONENTS; ++type) {
+            if (!mask.test(type)) continue;
+            m_columnOf[type] = static_cast<uint32_t>(m_columns.size());
+            m_columns.push_back({type, typeInfos[type], 0, {}});
+            bytesPerRow += typeInfos[type].size;
+        }
+
+        // Fit as many rows as possible into one chunk, then lay out the columns
+        m_chunkCapacity = std::max<size_t>(1, ComponentStorage::CHUNK_BYTES / bytesPerRow);
+        while (m_chunkCapacity > 1 && layoutColumns(m_chunkCapacity) > ComponentStorage::CHUNK_BYTES) {
+            --m_chunkCapacity;
+        }
+        m_chunkBytes = layoutColumns(m_chunkCapacity);
+    }
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    ~Archetype() {
+        clear();
+    }
+
+    const ComponentMask& getMask() const { return m_mask; }
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    bool hasColumn(ComponentType type) const { return m_columnOf[type] != INVALID_COLUMN; }
+
+    // Reserves a row for an entity. Component columns are left unconstructed;
+    // the caller must construct every column of the new row and set its ticks.
+    uint32_t allocateRow(EntityID entity) {
+        const uint32_t row = static_cast<uint32_t>(m_count);
+        if (row / m_chunkCapacity >= m_chunks.size()) {
+            m_chunks.push_back(allocateChunk());
+        }
+        entityColumn(row / m_chunkCapacity)[row % m_chunkCapacity] = entity;
+        for (Column& column : m_columns) {
+            column.ticks.emplace_back();
+        }
+        ++m_count;
+        return row;
+    }
+
+    // Allocates chunks up front so the next rows up to `rows` need no allocation
+    void reserve(size_t rows) {
+        while (m_chunks.size() * m_chunkCapacity < rows) {
+            m_chunks.push_back(allocateChunk());
+        }
+        for (Column& column : m_columns) {
+            column.ticks.reserve(rows);
+        }
+    }
+
+    // Destroys every component in a row and fills the gap with the last row.
+    // Returns the entity that now occupies the row, or Entity::Null if the
+    // removed row was the last one.
+    EntityID removeRow(uint32_t row) {
+        const RowSlot removed = slotOf(row);
+        for (Column& column : m_columns) {
+            column.info.destroy(removed.address(column));
+        }
+        return fillGap(row, removed);
+    }
+
+    // Moves a row into target's already allocated targetRow: the components
+    // both archetypes share are relocated along with their ticks, the rest are
+    // destroyed, and the gap is filled as by removeRow(), whose result it returns
+    EntityID moveRowTo(uint32_t row, Archetype& target, uint32_t targetRow) {
+        const RowSlot from = slotOf(row);
+        const RowSlot to = target.slotOf(targetRow);
+        // Both column lists are sorted by type, so one merge walk pairs them up
+        size_t t = 0;
+        for (Column& column : m_columns) {
+            while (t < target.m_columns.size() && target.m_columns[t].type < column.type) ++t;
+            if (t < target.m_columns.size() && target.m_columns[t].type == column.type) {
+                Column& targetColumn = target.m_columns[t];
+                column.info.relocate(to.address(targetColumn), from.address(column));
+                targetColumn.ticks[targetRow] = column.ticks[row];
+            } else {
+                column.info.destroy(from.address(column));
+            }
+        }
+        return fillGap(row, from);
+    }
+
+    EntityID entityAt(uint32_t row) const {
+        return entityColumn(row / m_chunkCapacity)[row % m_chunkCapacity];
+    }
+
+    void* componentAddress(ComponentType type, uint32_t row) const {
+        return columnAddress(m_columns[m_columnOf[type]], row);
+    }
+
+    ComponentTicks& ticks(ComponentType type, uint32_t row) { return m_columns[m_columnOf[type]].ticks[row]; }
+    const ComponentTicks& ticks(ComponentType type, uint32_t row) const {
+        return m_columns[m_columnOf[type]].ticks[row];
+    }
+
+    // Ticks of a whole column, indexed by row across all chunks
+    ComponentTicks* columnTicks(ComponentType type) { return m_columns[m_columnOf[type]].ticks.data(); }
+    const ComponentTicks* columnTicks(ComponentType type) const { return m_columns[m_columnOf[type]].ticks.data(); }
+
+    // Stamps every column of a row as added and written at tick
+    void stampRow(uint32_t row, ChangeTick tick) {
+        for (Column& column : m_columns) {
+            column.ticks[row] = {tick, tick};
+        }
+    }
+
+    // Chunk-wise access: chunk c holds chunkSize(c) rows, and every column of
+    // that chunk is a contiguous array of that many components
+    size_t chunkCount() const { return (m_count + m_chunkCapacity - 1) / m_chunkCapacity; }
+    size_t chunkSize(size_t chunk) const {
+        return std::min(m_chunkCapacity, m_count - chunk * m_chunkCapacity);
+    }
+    size_t chunkCapacity() const { return m_chunkCapacity; }
+    size_t allocatedChunkCount() const { return m_chunks.size(); }
+    size_t allocatedBytes() const {
+        size_t bytes = m_chunks.size() * m_chunkBytes;
+        for (const Column& column : m_columns) {
+            bytes += column.ticks.capacity() * sizeof(ComponentTicks);
+        }
+        return bytes;
+    }
+
+    const EntityID* chunkEntities(size_t chunk) const { return entityColumn(chunk); }
+    void* chunkColumn(size_t chunk, ComponentType type) const {
+        return chunkBytes(chunk) + m_columns[m_columnOf[type]].offset;
+    }
+
+    void clear() {
+        for (uint32_t row = 0; row < m_count; ++row) {
+            for (const Column& column : m_columns) {
+                column.info.destroy(columnAddress(column, row));
+            }
+        }
+        for (Column& column : m_columns) {
+            column.ticks.clear();
+        }
+        m_count = 0;
+        m_chunks.clear();
+    }
+
+    // Makes this archetype (same mask and layout) hold a copy of source's rows.
+    // Rows that already exist are assigned rather than rebuilt and chunks are
+    // reused; trivially copyable columns are copied a chunk at a time.
+    void copyFrom(const Archetype& source) {
+        for (const Column& column : m_columns) {
+            if (!column.info.copyConstruct) {
+                throw std::runtime_error("Component type is not copyable");
+            }
+        }
+
+        const size_t oldCount = m_count;
+        const size_t newCount = source.m_count;
+        for (size_t row = newCount; row < oldCount; ++row) {
+            for (const Column& column : m_columns) {
+                column.info.destroy(columnAddress(column, static_cast<uint32_t>(row)));
+            }
+        }
+
+        const size_t neededChunks = (newCount + m_chunkCapacity - 1) / m_chunkCapacity;
+        while (m_chunks.size() < neededChunks) {
+            m_chunks.push_back(allocateChunk());
+        }
+        while (m_chunks.size() > neededChunks + 1) {
+            m_chunks.pop_back();
+        }
+
+        for (size_t chunk = 0; chunk < neededChunks; ++chunk) {
+            const size_t firstRow = chunk * m_chunkCapacity;
+            const size_t rows = std::min(m_chunkCapacity, newCount - firstRow);
+            std::memcpy(entityColumn(chunk), source.entityColumn(chunk), rows * sizeof(EntityID));
+
+            for (size_t c = 0; c < m_columns.size(); ++c) {
+                const Column& column = m_columns[c];
+                unsigned char* destination = chunkBytes(chunk) + column.offset;
+                const unsigned char* from = source.chunkBytes(chunk) + source.m_columns[c].offset;
+                if (column.info.triviallyCopyable) {
+                    std::memcpy(destination, from, rows * column.info.size);
+                    continue;
+                }
+                for (size_t row = 0; row < rows; ++row) {
+                    const size_t offset = row * column.info.size;
+                    if (firstRow + row < oldCount) {
+                        column.info.copyAssign(destination + offset, from + offset);
+                    } else {
+                        column.info.copyConstruct(destination + offset, from + offset);
+                    }
+                }
+            }
+        }
+
+        for (size_t c = 0; c < m_columns.size(); ++c) {
+            m_columns[c].ticks = source.m_columns[c].ticks;
+        }
+        m_addEdges = source.m_addEdges;
+        m_removeEdges = source.m_removeEdges;
+        m_count = newCount;
+    }
+
+    // Stamps every component as added and written at tick
+    void stampAll(ChangeTick tick) {
+        for (Column& column : m_columns) {
+            std::fill(column.ticks.begin(), column.ticks.end(), ComponentTicks{tick, tick});
+        }
+    }
+
+    // Cached transitions to the archetype with one more / one fewer component
+    uint32_t& addEdge(ComponentType type) { return m_addEdges[type]; }
+    uint32_t& removeEdge(ComponentType type) { return m_removeEdges[type]; }
+
+private:
+    static constexpr size_t CHUNK_ALIGNMENT = 64;
+
+    struct alignas(CHUNK_ALIGNMENT) Block {
+        unsigned char bytes[CHUNK_ALIGNMENT];
+    };
+
+    struct Column {
+        ComponentType type;
+        ComponentTypeInfo info;
+        size_t offset;
+        std::vector<ComponentTicks> ticks;
+    };
+
+    // A row resolved to its chunk and slot, so the divide by the chunk
+    // capacity is paid once per row instead of once per column
+    struct RowSlot {
+        unsigned char* chunk;
+        size_t slot;
+
+        void* address(const Column& column) const { return chunk + column.offset + slot * column.info.size; }
+        EntityID& entity() const { return reinterpret_cast<EntityID*>(chunk)[slot]; }
+    };
+
+    RowSlot slotOf(uint32_t row) const {
+        return {chunkBytes(row / m_chunkCapacity), row % m_chunkCapacity};
+    }
+
+    // Relocates the last row into a row whose components are already gone
+    // and drops the last row; see removeRow()
+    EntityID fillGap(uint32_t row, const RowSlot& gap) {
+        const uint32_t lastRow = static_cast<uint32_t>(m_count - 1);
+        EntityID movedEntity = Entity::Null;
+        if (row != lastRow) {
+            const RowSlot last = slotOf(lastRow);
+            for (Column& column : m_columns) {
+                column.info.relocate(gap.address(column), last.address(column));
+                column.ticks[row] = column.ticks[lastRow];
+            }
+            movedEntity = last.entity();
+            gap.entity() = movedEntity;
+        }
+        for (Column& column : m_columns) {
+            column.ticks.pop_back();
+        }
+
+        --m_count;
+        // Keep one spare chunk so an archetype hovering at a chunk boundary
+        // does not allocate on every insert
+        const size_t neededChunks = chunkCount();
+        while (m_chunks.size() > neededChunks + 1) {
+            m_chunks.pop_back();
+        }
+        return movedEntity;
+    }
+
+    static size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Assigns column offsets for the given row capacity and returns the chunk size
+    size_t layoutColumns(size_t capacity) {
+        size_t offset = capacity * sizeof(EntityID);
+        for (Column& column : m_columns) {
+            offset = alignUp(offset, column.info.alignment);
+            column.offset = offset;
+            offset += capacity * column.info.size;
+        }
+        return alignUp(offset, CHUNK_ALIGNMENT);
+    }
+
+    std::unique_ptr<Block[]> allocateChunk() const {
+        return std::unique_ptr<Block[]>(new Block[m_chunkBytes / CHUNK_ALIGNMENT]); // Left uninitialised
+    }
+
+    unsigned char* chunkBytes(size_t chunk) const {
+        return reinterpret_cast<unsigned char*>(m_chunks[chunk].get());
+    }
+
+    EntityID* entityColumn(size_t chunk) const {
+        return reinterpret_cast<EntityID*>(chunkBytes(chunk));
+    }
+
+    void* columnAddress(const Column& column, uint32_t row) const {
+        unsigned char* chunk = chunkBytes(row / m_chunkCapacity);
+        return chunk + column.offset + (row % m_chunkCapacity) * column.info.size;
+    }
+
+    ComponentMask m_mask;
+    std::vector<Column> m_columns;
+    std::array<uint32_t, MAX_COMPONENTS> m_columnOf;
+    std::array<uint32_t, MAX_COMPONENTS> m_addEdges;
+    std::array<uint32_t, MAX_COMPONENTS> m_removeEdges;
+    std::vector<std::unique_ptr<Block[]>> m_chunks;
+    size_t m_chunkCapacity = 1;
+    size_t m_chunkBytes = 0;
+    size_t m_count = 0;
+};
+
+// Archetype-based component storage, the alternative to one ComponentArray per
+// type. Each entity lives in exactly one archetype row; adding or removing a
+// component moves the entity to the archetype of its new mask.
+//
+// References returned by get() are invalidated by any structural change
+// (adding/removing components or destroying entities) in the same archetype.
+class ArchetypeStorage {
+public:
+    void registerType(ComponentType type, const ComponentTypeInfo& info) {
+        if (type >= MAX_COMPONENTS) {
+            throw std::runtime_error("Too many component types registered");
+        }
+        if (info.alignment > 64) {
+            throw std::runtime_error("Component alignment exceeds archetype chunk alignment");
+        }
+        if (m_typeInfos.size() <= type) {
+            m_typeInfos.resize(type + 1);
+        }
+        m_typeInfos[type] = info;
+    }
+
+    void setClock(const ChangeClock* clock) { m_clock = clock; }
+
+    template<typename T>
+    void insert(EntityID entity, ComponentType type, T&& component) {
+        const uint32_t sourceIndex = archetypeOf(entity);
+        EntityRecord& record = recordFor(entity);
+        if (sourceIndex == NO_ARCHETYPE && record.archetype != NO_ARCHETYPE) {
+            throw std::runtime_error("Stale entity handle");
+        }
+
+        if (sourceIndex != NO_ARCHETYPE && m_archetypes[sourceIndex]->hasColumn(type)) {
+            // Entity already owns this component - overwrite in place
+            *static_cast<T*>(m_archetypes[sourceIndex]->componentAddress(type, record.row)) = std::forward<T>(component);
+            m_archetypes[sourceIndex]->ticks(type, record.row).changed = now();
+            return;
+        }
+
+        ComponentMask mask;
+        if (sourceIndex != NO_ARCHETYPE) {
+            mask = m_archetypes[sourceIndex]->getMask();
+        }
+        mask.set(type);
+        const uint32_t targetIndex = findTransition(sourceIndex, type, mask, true);
+        Archetype& target = *m_archetypes[targetIndex];
+
+        const uint32_t targetRow = target.allocateRow(entity);
+        new (target.componentAddress(type, targetRow)) T(std::forward<T>(component));
+        const ChangeTick tick = now();
+        target.ticks(type, targetRow) = {tick, tick};
+        if (sourceIndex != NO_ARCHETYPE) {
+            moveRow(*m_archetypes[sourceIndex], record.row, target, targetRow);
+        }
+        record = {targetIndex, targetRow};
+    }
+
+    // Places entities that have no components yet straight into the archetype
+    // for mask, skipping the intermediate archetypes insert() would walk.
+    // construct(archetype, row) must construct every column of the row.
+    template<typename Construct>
+    void insertNew(const EntityID* entities, size_t count, const ComponentMask& mask, Construct&& construct) {
+        if (count == 0) return;
+        const uint32_t targetIndex = findOrCreateArchetype(mask);
+        Archetype& target = *m_archetypes[targetIndex];
+        target.reserve(target.size() + count);
+
+        uint32_t highestIndex = 0;
+        for (size_t i = 0; i < count; ++i) {
+            highestIndex = std::max(highestIndex, Entity::index(entities[i]));
+        }
+        if (highestIndex >= m_records.size()) {
+            m_records.resize(highestIndex + 1);
+        }
+
+        const ChangeTick tick = now();
+        for (size_t i = 0; i < count; ++i) {
+            EntityRecord& record = m_records[Entity::index(entities[i])];
+            if (record.archetype != NO_ARCHETYPE) {
+                throw std::runtime_error(archetypeOf(entities[i]) == NO_ARCHETYPE
+                    ? "Stale entity handle" : "Entity already has components");
+            }
+            const uint32_t row = target.allocateRow(entities[i]);
+            construct(target, row);
+            target.stampRow(row, tick);
+            record = {targetIndex, row};
+        }
+    }
+
+    // True if the entity has at least one component
+    bool contains(EntityID entity) const {
+        return archetypeOf(entity) != NO_ARCHETYPE;
+    }
+
+    // Returns false if the entity did not have the component
+    bool remove(EntityID entity, ComponentType type) {
+        const uint32_t sourceIndex = archetypeOf(entity);
+        if (sourceIndex == NO_ARCHETYPE || !m_archetypes[sourceIndex]->hasColumn(type)) return false;
+
+        EntityRecord& record = recordFor(entity);
+        ComponentMask mask = m_archetypes[sourceIndex]->getMask();
+        mask.reset(type);
+
+        if (mask.none()) {
+            eraseRow(*m_archetypes[sourceIndex], record.row);
+            record = {NO_ARCHETYPE, 0};
+            return true;
+        }
+
+        const uint32_t targetIndex = findTransition(sourceIndex, type, mask, false);
+        Archetype& target = *m_archetypes[targetIndex];
+        const uint32_t targetRow = target.allocateRow(entity);
+        moveRow(*m_archetypes[sourceIndex], record.row, target, targetRow);
+        record = {targetIndex, targetRow};
+        return true;
+    }
+
+    // nullptr if the entity does not have the component
+    void* find(EntityID entity, ComponentType type) const {
+        const uint32_t archetypeIndex = archetypeOf(entity);
+        if (archetypeIndex == NO_ARCHETYPE || !m_archetypes[archetypeIndex]->hasColumn(type)) {
+            return nullptr;
+        }
+        return m_archetypes[archetypeIndex]->componentAddress(type, m_records[Entity::index(entity)].row);
+    }
+
+    // find() that also stamps the component as written at tick, from the
+    // same lookup
+    void* findAndStamp(EntityID entity, ComponentType type, ChangeTick tick) {
+        const uint32_t archetypeIndex = archetypeOf(entity);
+        if (archetypeIndex == NO_ARCHETYPE || !m_archetypes[archetypeIndex]->hasColumn(type)) {
+            return nullptr;
+        }
+        Archetype& archetype = *m_archetypes[archetypeIndex];
+        const uint32_t row = m_records[Entity::index(entity)].row;
+        archetype.ticks(type, row).changed = tick;
+        return archetype.componentAddress(type, row);
+    }
+
+    // nullptr if the entity does not have the component
+    const ComponentTicks* findTicks(EntityID entity, ComponentType type) const {
+        const uint32_t archetypeIndex = archetypeOf(entity);
+        if (archetypeIndex == NO_ARCHETYPE || !m_archetypes[archetypeIndex]->hasColumn(type)) {
+            return nullptr;
+        }
+        return &m_archetypes[archetypeIndex]->ticks(type, m_records[Entity::index(entity)].row);
+    }
+
+    // Stamps the component as written now; false if the entity has none
+    bool markChanged(EntityID entity, ComponentType type) {
+        const uint32_t archetypeIndex = archetypeOf(entity);
+        if (archetypeIndex == NO_ARCHETYPE || !m_archetypes[archetypeIndex]->hasColumn(type)) {
+            return false;
+        }
+        m_archetypes[archetypeIndex]->ticks(type, m_records[Entity::index(entity)].row).changed = now();
+        return true;
+    }
+
+    // Returns the mask of the components the entity had
+    ComponentMask entityDestroyed(EntityID entity) {
+        const uint32_t archetypeIndex = archetypeOf(entity);
+        if (archetypeIndex == NO_ARCHETYPE) return ComponentMask();
+
+        const ComponentMask mask = m_archetypes[archetypeIndex]->getMask();
+        EntityRecord& record = recordFor(entity);
+        eraseRow(*m_archetypes[archetypeIndex], record.row);
+        record = {NO_ARCHETYPE, 0};
+        return mask;
+    }
+
+    // Calls func(archetype) for every non-empty archetype containing all of mask
+    template<typename Func>
+    void forEachArchetype(const ComponentMask& mask, Func&& func) const {
+        for (const auto& archetype : m_archetypes) {
+            if (!archetype->empty() && (archetype->getMask() & mask) == mask) {
+                func(*archetype);
+            }
+        }
+    }
+
+    size_t archetypeCount() const { return m_archetypes.size(); }
+
+    bool empty() const {
+        for (const auto& archetype : m_archetypes) {
+            if (!archetype->empty()) return false;
+        }
+        return true;
+    }
+
+    void clear() {
+        m_archetypes.clear();
+        m_records.clear();
+    }
+
+    // Makes this storage a copy of source. Archetypes at the same position
+    // with the same mask are overwritten in place, so repeated copies from a
+    // similar storage reuse their chunks.
+    void copyFrom(const ArchetypeStorage& source) {
+        m_typeInfos = source.m_typeInfos;
+        m_archetypes.resize(source.m_archetypes.size());
+        for (size_t i = 0; i < m_archetypes.size(); ++i) {
+            const Archetype& from = *source.m_archetypes[i];
+            if (!m_archetypes[i] || m_archetypes[i]->getMask() != from.getMask()) {
+                m_archetypes[i] = std::make_unique<Archetype>(from.getMask(), m_typeInfos);
+            }
+            m_archetypes[i]->copyFrom(from);
+        }
+        m_records = source.m_records;
+    }
+
+    void stampAll(ChangeTick tick) {
+        for (auto& archetype : m_archetypes) {
+            archetype->stampAll(tick);
+        }
+    }
+
+    // Per-type usage summed over every archetype that stores the type
+    ComponentPoolStats getMemoryStats(ComponentType type) const {
+        ComponentPoolStats stats;
+        if (type < m_typeInfos.size()) {
+            stats.typeName = m_typeInfos[type].name ? m_typeInfos[type].name : "";
+            stats.componentSize = m_typeInfos[type].size;
+        }
+        for (const auto& archetype : m_archetypes) {
+            if (!archetype->hasColumn(type)) continue;
+            stats.count += archetype->size();
+            stats.capacity += archetype->allocatedChunkCount() * archetype->chunkCapacity();
+            stats.chunkCount += archetype->allocatedChunkCount();
+            stats.bytesAllocated += archetype->allocatedChunkCount() * archetype->chunkCapacity() * stats.componentSize;
+        }
+        return stats;
+    }
+
+    size_t getMemoryUsage() const {
+        size_t bytes = m_records.capacity() * sizeof(EntityRecord);
+        for (const auto& archetype : m_archetypes) {
+            bytes += sizeof(Archetype) + archetype->allocatedBytes();
+        }
+        return bytes;
+    }
+
+private:
+    static constexpr uint32_t NO_ARCHETYPE = std::numeric_limits<uint32_t>::max();
+
+    struct EntityRecord {
+        uint32_t archetype = NO_ARCHETYPE;
+        uint32_t row = 0;
+    };
+
+    // Archetype currently holding the entity, or NO_ARCHETYPE (also for stale handles)
+    uint32_t archetypeOf(EntityID entity) const {
+        const uint32_t index = Entity::index(entity);
+        if (index >= m_records.size()) return NO_ARCHETYPE;
+        const EntityRecord& record = m_records[index];
+        if (record.archetype == NO_ARCHETYPE ||
+            m_archetypes[record.archetype]->entityAt(record.row) != entity) {
+            return NO_ARCHETYPE;
+        }
+        return record.archetype;
+    }
+
+    EntityRecord& recordFor(EntityID entity) {
+        const uint32_t index = Entity::index(entity);
+        if (index >= m_records.size()) {
+            m_records.resize(index + 1);
+        }
+        return m_records[index];
+    }
+
+    // Follows (or creates) the graph edge from source along one component
+    uint32_t findTransition(uint32_t sourceIndex, ComponentType type, const ComponentMask& mask, bool adding) {
+        if (sourceIndex != NO_ARCHETYPE) {
+            Archetype& source = *m_archetypes[sourceIndex];
+            uint32_t& edge = adding ? source.addEdge(type) : source.removeEdge(type);
+            if (edge == Archetype::NO_EDGE) {
+                edge = findOrCreateArchetype(mask);
+            }
+            return edge;
+        }
+        return findOrCreateArchetype(mask);
+    }
+
+    uint32_t findOrCreateArchetype(const ComponentMask& mask) {
+        for (uint32_t i = 0; i < m_archetypes.size(); ++i) {
+            if (m_archetypes[i]->getMask() == mask) return i;
+        }
+        for (ComponentType type = 0; type < MAX_COMPONENTS; ++type) {
+            if (mask.test(type) && (type >= m_typeInfos.size() || !m_typeInfos[type].moveConstruct)) {
+                throw std::runtime_error("Component not registered for archetype storage");
+            }
+        }
+        m_archetypes.push_back(std::make_unique<Archetype>(mask, m_typeInfos));
+        return static_cast<uint32_t>(m_archetypes.size() - 1);
+    }
+
+    // Moves the components both archetypes share (with their ticks) into an
+    // already allocated target row, then removes the source row
+    void moveRow(Archetype& source, uint32_t sourceRow, Archetype& target, uint32_t targetRow) {
+        const EntityID movedEntity = source.moveRowTo(sourceRow, target, targetRow);
+        if (movedEntity != Entity::Null) {
+            m_records[Entity::index(movedEntity)].row = sourceRow;
+        }
+    }
+
+    void eraseRow(Archetype& archetype, uint32_t row) {
+        const EntityID movedEntity = archetype.removeRow(row);
+        if (movedEntity != Entity::Null) {
+            m_records[Entity::index(movedEntity)].row = row;
+        }
+    }
+
+    ChangeTick now() const { return m_clock ? m_clock->now() : 0; }
+
+    std::vector<ComponentTypeInfo> m_typeInfos;
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::vector<EntityRecord> m_records;
+    const ChangeClock* m_clock = nullptr;
+};
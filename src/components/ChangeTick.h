@@ -0,0 +1,28 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Change detection stamps. A ChangeClock hands out monotonically increasing
+// ticks; every component carries the tick it was added at and the tick it was
+// last written at. A consumer remembers the tick it last looked at and asks
+// for components whose tick is newer (see View::changed / View::added).
+// Ticks are 32-bit and assumed not to wrap within a session.
+using ChangeTick = uint32_t;
+
+struct ComponentTicks {
+    ChangeTick added = 0;
+    ChangeTick changed = 0;
+};
+
+class ChangeClock {
+public:
+    ChangeTick now() const { return m_tick.load(std::memory_order_relaxed); }
+
+    // Returns the current tick and moves the clock past it, so writes made
+    // after this call are newer than the returned tick
+    ChangeTick advance() { return m_tick.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+    std::atomic<ChangeTick> m_tick{1}; // 0 means "never", so everything is newer than it
+};
@@ -0,0 +1,431 @@
+#pragma once
+
+#include "Components.h"
+#include "ChangeTick.h"
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <string>
+#include <typeinfo>
+#include <type_traits>
+#include <stdexcept>
+
+// Memory usage of a single component pool (see ComponentManager::getMemoryReport)
+struct ComponentPoolStats {
+    std::string typeName;
+    size_t componentSize = 0;     // sizeof(T)
+    size_t count = 0;             // Live components
+    size_t capacity = 0;          // Components that fit in the allocated chunks
+    size_t chunkCount = 0;
+    size_t sparsePageCount = 0;
+    size_t bytesAllocated = 0;    // Chunks + sparse pages + dense entity list and ticks
+};
+
+// Type-erased interface so the ComponentManager can notify every pool
+class IComponentArray {
+public:
+    virtual ~IComponentArray() = default;
+    // Returns true if the entity had a component in this pool
+    virtual bool entityDestroyed(EntityID entity) = 0;
+    virtual ComponentPoolStats getMemoryStats() const = 0;
+    // nullptr if the entity has no component in this pool
+    virtual const ComponentTicks* findTicks(EntityID entity) const = 0;
+    virtual void setClock(const ChangeClock* clock) = 0;
+
+    // Snapshot support. copyFrom() requires a pool of the same type and
+    // throws if the type is not copyable.
+    virtual std::unique_ptr<IComponentArray> clone() const = 0;
+    virtual void copyFrom(const IComponentArray& source) = 0;
+    // Stamps every component as added and written at tick
+    virtual void stampAll(ChangeTick tick) = 0;
+};
+
+namespace ComponentStorage {
+    // Target size of one dense chunk
+    constexpr size_t CHUNK_BYTES = 16 * 1024;
+
+    // Largest power of two that keeps a chunk within CHUNK_BYTES (at least 1)
+    constexpr size_t chunkCapacityFor(size_t elementSize) {
+        size_t capacity = 1;
+        while (capacity * 2 * elementSize <= CHUNK_BYTES) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    constexpr size_t log2(size_t value) {
+        size_t shift = 0;
+        while ((size_t(1) << shift) < value) {
+            ++shift;
+        }
+        return shift;
+    }
+}
+
+// Sparse-set component storage.
+//
+// The sparse side maps an entity ID to a slot in the dense arrays and is split
+// into fixed-size pages that are only allocated once an entity in that range
+// receives the component. The dense side keeps components packed in ~16 KB
+// chunks that are allocated as the pool grows and released as it shrinks, so
+// an unused pool costs nothing and references stay valid while it grows.
+// Each component's ComponentTicks sit in a parallel array; inserts stamp them
+// from the clock set with setClock().
+template<typename T>
+class ComponentArray : public IComponentArray {
+public:
+    static constexpr size_t PAGE_SIZE = 4096;
+    static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t CHUNK_CAPACITY = ComponentStorage::chunkCapacityFor(sizeof(T));
+    static constexpr size_t CHUNK_SHIFT = ComponentStorage::log2(CHUNK_CAPACITY);
+    static constexpr size_t CHUNK_MASK = CHUNK_CAPACITY - 1;
+
+    ComponentArray() = default;
+    ComponentArray(const ComponentArray&) = delete;
+    ComponentArray& operator=(const ComponentArray&) = delete;
+
+    ~ComponentArray() override {
+        clear();
+    }
+
+    void setClock(const ChangeClock* clock) override { m_clock = clock; }
+
+    void insertData(EntityID entity, T&& component) {
+        uint32_t& slot = sparseSlot(entity);
+        if (slot != INVALID_INDEX) {
+            if (m_denseEntities[slot] != entity) {
+                throw std::runtime_error("Stale entity handle");
+            }
+            // Entity already owns this component - overwrite in place
+            componentAt(slot) = std::forward<T>(component);
+            m_ticks[slot].changed = now();
+            return;
+        }
+
+        const uint32_t index = static_cast<uint32_t>(m_denseEntities.size());
+        if ((index >> CHUNK_SHIFT) >= m_chunks.size()) {
+            m_chunks.push_back(std::unique_ptr<Chunk>(new Chunk)); // Left uninitialised
+        }
+        new (slotAddress(index)) T(std::forward<T>(component));
+        m_denseEntities.push_back(entity);
+        const ChangeTick tick = now();
+        m_ticks.push_back({tick, tick});
+        slot = index;
+    }
+
+    // Gives every entity a copy of prototype in one pass: the sparse page is
+    // looked up once per run of entities that share it, new owners are
+    // appended to the dense range, then their ticks and components are filled
+    // in a chunk at a time. Entities that already own the component are
+    // overwritten in place, as by insertData().
+    void insertBatch(const EntityID* entities, size_t count, const T& prototype) {
+        reserve(size() + count);
+        const uint32_t first = static_cast<uint32_t>(size());
+        const ChangeTick tick = now();
+
+        SparsePage* page = nullptr;
+        size_t pageIndex = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const EntityID entity = entities[i];
+            const uint32_t entityIndex = Entity::index(entity);
+            if (!page || entityIndex / PAGE_SIZE != pageIndex) {
+                pageIndex = entityIndex / PAGE_SIZE;
+                page = &sparsePage(pageIndex);
+            }
+            uint32_t& slot = (*page)[entityIndex % PAGE_SIZE];
+            if (slot == INVALID_INDEX) {
+                slot = static_cast<uint32_t>(m_denseEntities.size());
+                m_denseEntities.push_back(entity);
+                continue;
+            }
+            if (m_denseEntities[slot] != entity) {
+                // Unclaim the slots taken so far so the pool stays consistent
+                for (size_t index = first; index < m_denseEntities.size(); ++index) {
+                    sparseSlot(m_denseEntities[index]) = INVALID_INDEX;
+                }
+                m_denseEntities.resize(first);
+                throw std::runtime_error("Stale entity handle");
+            }
+            if (slot < first) {
+                componentAt(slot) = prototype;
+                m_ticks[slot].changed = tick;
+            }
+            // Otherwise a repeat of an entity already added by this batch
+        }
+
+        m_ticks.resize(m_denseEntities.size(), ComponentTicks{tick, tick});
+        for (size_t index = first; index < m_denseEntities.size();) {
+            const size_t run = std::min(CHUNK_CAPACITY - (index & CHUNK_MASK), m_denseEntities.size() - index);
+            std::uninitialized_fill_n(slotAddress(index), run, prototype);
+            index += run;
+        }
+    }
+
+    // Allocates dense chunks and entity-list space for `capacity` components
+    void reserve(size_t capacity) {
+        if (capacity > m_denseEntities.capacity()) {
+            m_denseEntities.reserve(std::max(capacity, m_denseEntities.capacity() * 2));
+            m_ticks.reserve(m_denseEntities.capacity());
+        }
+        while (m_chunks.size() * CHUNK_CAPACITY < capacity) {
+            m_chunks.push_back(std::unique_ptr<Chunk>(new Chunk)); // Left uninitialised
+        }
+    }
+
+    // Returns false if the entity did not have the component
+    bool removeData(EntityID entity) {
+        const uint32_t indexOfRemovedEntity = findIndex(entity);
+        if (indexOfRemovedEntity == INVALID_INDEX) return false;
+
+        const uint32_t indexOfLastElement = static_cast<uint32_t>(m_denseEntities.size() - 1);
+
+        // Move last element to removed position (if not the same)
+        if (indexOfRemovedEntity != indexOfLastElement) {
+            const EntityID entityOfLastElement = m_denseEntities[indexOfLastElement];
+            componentAt(indexOfRemovedEntity) = std::move(componentAt(indexOfLastElement));
+            m_denseEntities[indexOfRemovedEntity] = entityOfLastElement;
+            m_ticks[indexOfRemovedEntity] = m_ticks[indexOfLastElement];
+            sparseSlot(entityOfLastElement) = indexOfRemovedEntity;
+        }
+
+        sparseSlot(entity) = INVALID_INDEX;
+        componentAt(indexOfLastElement).~T();
+        m_denseEntities.pop_back();
+        m_ticks.pop_back();
+        releaseUnusedChunks();
+        return true;
+    }
+
+    T& getData(EntityID entity) {
+        const uint32_t index = findIndex(entity);
+        if (index == INVALID_INDEX) {
+            throw std::runtime_error("Entity does not have this component");
+        }
+        return componentAt(index);
+    }
+
+    const T& getData(EntityID entity) const {
+        const uint32_t index = findIndex(entity);
+        if (index == INVALID_INDEX) {
+            throw std::runtime_error("Entity does not have this component");
+        }
+        return componentAt(index);
+    }
+
+    // getData() that also stamps the component as written at tick, from the
+    // same lookup
+    T& getDataAndStamp(EntityID entity, ChangeTick tick) {
+        const uint32_t index = findIndex(entity);
+        if (index == INVALID_INDEX) {
+            throw std::runtime_error("Entity does not have this component");
+        }
+        m_ticks[index].changed = tick;
+        return componentAt(index);
+    }
+
+    // Returns nullptr instead of throwing when the component is missing
+    T* tryGetData(EntityID entity) {
+        const uint32_t index = findIndex(entity);
+        return index == INVALID_INDEX ? nullptr : &componentAt(index);
+    }
+
+    bool hasData(EntityID entity) const {
+        return findIndex(entity) != INVALID_INDEX;
+    }
+
+    bool entityDestroyed(EntityID entity) override {
+        return removeData(entity);
+    }
+
+    // Dense index of the entity's component, or INVALID_INDEX
+    uint32_t indexOf(EntityID entity) const { return findIndex(entity); }
+
+    ComponentTicks& ticksAt(size_t index) { return m_ticks[index]; }
+    const ComponentTicks& ticksAt(size_t index) const { return m_ticks[index]; }
+
+    const ComponentTicks* findTicks(EntityID entity) const override {
+        const uint32_t index = findIndex(entity);
+        return index == INVALID_INDEX ? nullptr : &m_ticks[index];
+    }
+
+    // Stamps the component as written now; false if the entity has none
+    bool markChanged(EntityID entity) {
+        const uint32_t index = findIndex(entity);
+        if (index == INVALID_INDEX) return false;
+        m_ticks[index].changed = now();
+        return true;
+    }
+
+    std::unique_ptr<IComponentArray> clone() const override {
+        auto copy = std::make_unique<ComponentArray<T>>();
+        copy->copyFrom(*this);
+        return copy;
+    }
+
+    // Components that already exist are assigned rather than rebuilt and
+    // chunks and pages are reused; trivially copyable types are copied a
+    // chunk at a time
+    void copyFrom(const IComponentArray& other) override {
+        if constexpr (!std::is_copy_constructible_v<T> || !std::is_copy_assignable_v<T>) {
+            throw std::runtime_error("Component type is not copyable");
+        } else {
+            const auto& source = static_cast<const ComponentArray<T>&>(other);
+            const size_t oldCount = size();
+            const size_t newCount = source.size();
+            for (size_t i = newCount; i < oldCount; ++i) {
+                componentAt(i).~T();
+            }
+
+            const size_t neededChunks = (newCount + CHUNK_CAPACITY - 1) >> CHUNK_SHIFT;
+            while (m_chunks.size() < neededChunks) {
+                m_chunks.push_back(std::unique_ptr<Chunk>(new Chunk)); // Left uninitialised
+            }
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                for (size_t chunk = 0; chunk < neededChunks; ++chunk) {
+                    const size_t count = std::min(CHUNK_CAPACITY, newCount - (chunk << CHUNK_SHIFT));
+                    std::memcpy(m_chunks[chunk]->storage, source.m_chunks[chunk]->storage, count * sizeof(T));
+                }
+            } else {
+                for (size_t i = 0; i < newCount; ++i) {
+                    if (i < oldCount) {
+                        componentAt(i) = source.componentAt(i);
+                    } else {
+                        new (slotAddress(i)) T(source.componentAt(i));
+                    }
+                }
+            }
+            m_denseEntities = source.m_denseEntities;
+            m_ticks = source.m_ticks;
+
+            m_sparsePages.resize(source.m_sparsePages.size());
+            for (size_t page = 0; page < m_sparsePages.size(); ++page) {
+                if (!source.m_sparsePages[page]) {
+                    m_sparsePages[page].reset();
+                    continue;
+                }
+                if (!m_sparsePages[page]) {
+                    m_sparsePages[page] = std::make_unique<SparsePage>();
+                }
+                *m_sparsePages[page] = *source.m_sparsePages[page];
+            }
+            releaseUnusedChunks();
+        }
+    }
+
+    void stampAll(ChangeTick tick) override {
+        std::fill(m_ticks.begin(), m_ticks.end(), ComponentTicks{tick, tick});
+    }
+
+    // Destroys every component and frees all chunks and pages
+    void clear() {
+        for (uint32_t i = 0; i < m_denseEntities.size(); ++i) {
+            componentAt(i).~T();
+        }
+        m_denseEntities.clear();
+        m_ticks.clear();
+        m_chunks.clear();
+        m_sparsePages.clear();
+    }
+
+    // Dense access - components and their owners share the same index
+    size_t size() const { return m_denseEntities.size(); }
+    bool empty() const { return m_denseEntities.empty(); }
+    const EntityID* entities() const { return m_denseEntities.data(); }
+    EntityID entityAt(size_t index) const { return m_denseEntities[index]; }
+
+    T& componentAt(size_t index) { return *slotAddress(index); }
+    const T& componentAt(size_t index) const { return *slotAddress(index); }
+
+    // Chunk-wise access for tight loops: chunk c holds chunkSize(c) contiguous
+    // components whose owners start at entities()[c * CHUNK_CAPACITY]
+    size_t chunkCount() const { return (size() + CHUNK_CAPACITY - 1) >> CHUNK_SHIFT; }
+    size_t chunkSize(size_t chunk) const {
+        const size_t begin = chunk << CHUNK_SHIFT;
+        return std::min(CHUNK_CAPACITY, size() - begin);
+    }
+    T* chunkData(size_t chunk) { return slotAddress(chunk << CHUNK_SHIFT); }
+
+    ComponentPoolStats getMemoryStats() const override {
+        ComponentPoolStats stats;
+        stats.typeName = typeid(T).name();
+        stats.componentSize = sizeof(T);
+        stats.count = size();
+        stats.capacity = m_chunks.size() * CHUNK_CAPACITY;
+        stats.chunkCount = m_chunks.size();
+        for (const auto& page : m_sparsePages) {
+            if (page) ++stats.sparsePageCount;
+        }
+        stats.bytesAllocated = stats.chunkCount * sizeof(Chunk) +
+                               stats.sparsePageCount * sizeof(SparsePage) +
+                               m_sparsePages.capacity() * sizeof(m_sparsePages[0]) +
+                               m_chunks.capacity() * sizeof(m_chunks[0]) +
+                               m_denseEntities.capacity() * sizeof(EntityID) +
+                               m_ticks.capacity() * sizeof(ComponentTicks);
+        return stats;
+    }
+
+private:
+    using SparsePage = std::array<uint32_t, PAGE_SIZE>;
+
+    struct Chunk {
+        alignas(T) unsigned char storage[CHUNK_CAPACITY * sizeof(T)];
+    };
+
+    T* slotAddress(size_t index) const {
+        unsigned char* bytes = m_chunks[index >> CHUNK_SHIFT]->storage;
+        return std::launder(reinterpret_cast<T*>(bytes) + (index & CHUNK_MASK));
+    }
+
+    // Keeps one spare chunk past the live range so a pool that oscillates
+    // around a chunk boundary does not allocate on every insert
+    void releaseUnusedChunks() {
+        const size_t neededChunks = chunkCount();
+        while (m_chunks.size() > neededChunks + 1) {
+            m_chunks.pop_back();
+        }
+    }
+
+    // The sparse side is keyed by slot index; the dense owner list holds the
+    // full handle, so a stale handle whose slot was recycled does not match
+    uint32_t findIndex(EntityID entity) const {
+        const uint32_t entityIndex = Entity::index(entity);
+        const size_t page = entityIndex / PAGE_SIZE;
+        if (page >= m_sparsePages.size() || !m_sparsePages[page]) {
+            return INVALID_INDEX;
+        }
+        const uint32_t index = (*m_sparsePages[page])[entityIndex % PAGE_SIZE];
+        if (index == INVALID_INDEX || m_denseEntities[index] != entity) {
+            return INVALID_INDEX;
+        }
+        return index;
+    }
+
+    // Returns the sparse slot for an entity, allocating its page on demand
+    uint32_t& sparseSlot(EntityID entity) {
+        const uint32_t entityIndex = Entity::index(entity);
+        return sparsePage(entityIndex / PAGE_SIZE)[entityIndex % PAGE_SIZE];
+    }
+
+    SparsePage& sparsePage(size_t page) {
+        if (page >= m_sparsePages.size()) {
+            m_sparsePages.resize(page + 1);
+        }
+        if (!m_sparsePages[page]) {
+            m_sparsePages[page] = std::make_unique<SparsePage>();
+            m_sparsePages[page]->fill(INVALID_INDEX);
+        }
+        return *m_sparsePages[page];
+    }
+
+    ChangeTick now() const { return m_clock ? m_clock->now() : 0; }
+
+    std::vector<std::unique_ptr<SparsePage>> m_sparsePages;
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    std::vector<EntityID> m_denseEntities;
+    std::vector<ComponentTicks> m_ticks; // Parallel to m_denseEntities
+    const ChangeClock* m_clock = nullptr;
+};
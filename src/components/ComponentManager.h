@@ -1,137 +1,500 @@
 #pragma once
 
 #include "Components.h"
-#include <unordered_map>
-#include <memory>
-#include <typeindex>
+#include "ComponentArray.h"
+#include "ArchetypeStorage.h"
+#include "TypeId.h"
+#include "ChangeTick.h"
 #include <array>
+#include <atomic>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
 #include <stdexcept>
 
+// How component data is laid out in memory
+enum class StorageMode {
+    SparseSet,  // One ComponentArray per type (default)
+    Archetype   // Entities with the same mask share SoA chunks
+};
+
+// Owns one pool per registered component type.
+//
+// Pools are stored in a flat array indexed by ComponentId<T>::value, so every
+// typed access is an array index - no type_index hashing and no shared_ptr
+// copies. ComponentType (the signature bit) is assigned in registration order.
+//
+// Tag types (see Tag) get a signature bit but no pool: add/remove are no-ops
+// here and presence is read from the entity's signature.
+//
+// Change detection: every component carries ComponentTicks stamped from the
+// manager's ChangeClock on add and on mutable access (getComponent, non-const
+// view types). Each pool additionally tracks the newest add/change/removal
+// tick so consumers can skip a whole type cheaply, and removals are logged per
+// type until pruneRemoved() drops them.
 class ComponentManager {
 public:
+    ComponentManager() {
+        m_archetypes.setClock(&m_clock);
+    }
+    
     template<typename T>
     void registerComponent() {
-        const std::type_index typeIndex = std::type_index(typeid(T));
-        m_componentTypes.emplace(typeIndex, m_nextComponentType);
-        m_componentArrays.emplace(typeIndex, std::make_shared<ComponentArray<T>>());
+        const size_t id = ComponentId<T>::value;
+        if (id < m_pools.size() && m_pools[id].registered) return;
+        if (m_nextComponentType >= MAX_COMPONENTS) {
+            throw std::runtime_error("Too many component types registered");
+        }
+        
+        if (id >= m_pools.size()) {
+            m_pools.resize(id + 1);
+        }
+        m_pools[id].registered = true;
+        m_pools[id].type = m_nextComponentType;
+        if constexpr (is_tag_v<T>) {
+            m_tagMask.set(m_nextComponentType);
+            m_tagNames[m_nextComponentType] = typeid(T).name();
+        } else {
+            auto pool = std::make_unique<ComponentArray<T>>();
+            pool->setClock(&m_clock);
+            m_pools[id].array = std::move(pool);
+            m_archetypes.registerType(m_nextComponentType, ComponentTypeInfo::of<T>());
+        }
+        m_poolsByType.push_back(m_pools[id].array.get()); // nullptr for tags
         ++m_nextComponentType;
     }
     
+    // Switching is only allowed while no entity has any component
+    void setStorageMode(StorageMode mode) {
+        if (mode == m_storageMode) return;
+        for (const IComponentArray* componentArray : m_poolsByType) {
+            if (componentArray && componentArray->getMemoryStats().count > 0) {
+                throw std::runtime_error("Cannot change storage mode while components exist");
+            }
+        }
+        if (!m_archetypes.empty()) {
+            throw std::runtime_error("Cannot change storage mode while components exist");
+        }
+        m_archetypes.clear();
+        m_storageMode = mode;
+    }
+    
+    StorageMode getStorageMode() const { return m_storageMode; }
+    
+    // Signature bits that belong to tag types
+    const ComponentMask& getTagMask() const { return m_tagMask; }
+    
     template<typename T>
     ComponentType getComponentType() const {
-        const std::type_index typeIndex = std::type_index(typeid(T));
-        return m_componentTypes.at(typeIndex);
+        return poolEntry<T>().type;
+    }
+    
+    template<typename T>
+    bool isRegistered() const {
+        const size_t id = ComponentId<T>::value;
+        return id < m_pools.size() && m_pools[id].registered;
     }
     
     template<typename T>
     void addComponent(EntityID entity, T&& component) {
-        getComponentArray<T>()->insertData(entity, std::forward<T>(component));
+        using Stored = std::decay_t<T>;
+        const ComponentType type = getComponentType<Stored>();
+        if constexpr (is_tag_v<Stored>) {
+            // Nothing stored
+        } else if (m_storageMode == StorageMode::Archetype) {
+            m_archetypes.insert(entity, type, std::forward<T>(component));
+        } else {
+            getComponentArray<Stored>()->insertData(entity, std::forward<T>(component));
+        }
+        markPoolAdded(type);
+    }
+    
+    // Gives every entity a copy of each prototype. Each pool appends the whole
+    // batch in one pass (ComponentArray::insertBatch); in archetype mode
+    // entities without components go straight to their final archetype.
+    template<typename... Ts>
+    void addComponents(const EntityID* entities, size_t count, const Ts&... prototype) {
+        if (m_storageMode == StorageMode::Archetype) {
+            addComponentsArchetype(entities, count, prototype...);
+        } else {
+            auto addAll = [&](const auto& value) {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (!is_tag_v<T>) {
+                    getComponentArray<T>()->insertBatch(entities, count, value);
+                }
+            };
+            (addAll(prototype), ...);
+        }
+        (markPoolAdded(getComponentType<Ts>()), ...);
     }
     
     template<typename T>
     void removeComponent(EntityID entity) {
-        getComponentArray<T>()->removeData(entity);
+        if constexpr (is_tag_v<T>) {
+            // Nothing stored
+        } else {
+            const ComponentType type = getComponentType<T>();
+            const bool removed = m_storageMode == StorageMode::Archetype
+                ? m_archetypes.remove(entity, type)
+                : getComponentArray<T>()->removeData(entity);
+            if (removed) {
+                logRemoval(entity, type);
+            }
+        }
     }
     
+    // Mutable access counts as a write for change detection. The component is
+    // found and stamped in one lookup, and the pool tick only needs a CAS on
+    // the first write of the type in a tick.
     template<typename T>
     T& getComponent(EntityID entity) {
-        return getComponentArray<T>()->getData(entity);
+        static_assert(!is_tag_v<T>, "Tags have no data");
+        const ComponentType type = getComponentType<T>();
+        const ChangeTick tick = m_clock.now();
+        T* component;
+        if (m_storageMode == StorageMode::Archetype) {
+            component = static_cast<T*>(m_archetypes.findAndStamp(entity, type, tick));
+            if (!component) {
+                throw std::runtime_error("Entity does not have this component");
+            }
+        } else {
+            component = &getComponentArray<T>()->getDataAndStamp(entity, tick);
+        }
+        raiseTick(m_poolTicks[type].changed, tick);
+        return *component;
     }
     
     template<typename T>
     const T& getComponent(EntityID entity) const {
+        static_assert(!is_tag_v<T>, "Tags have no data");
+        if (m_storageMode == StorageMode::Archetype) {
+            return *static_cast<const T*>(findArchetypeComponent<T>(entity));
+        }
         return getComponentArray<T>()->getData(entity);
     }
     
     template<typename T>
     bool hasComponent(EntityID entity) const {
+        static_assert(!is_tag_v<T>, "Tags are only recorded in the entity signature");
+        if (m_storageMode == StorageMode::Archetype) {
+            return m_archetypes.find(entity, getComponentType<T>()) != nullptr;
+        }
         return getComponentArray<T>()->hasData(entity);
     }
     
+    // Direct access to a pool for dense iteration over every instance of T.
+    // Only populated in StorageMode::SparseSet.
+    template<typename T>
+    ComponentArray<T>& getComponentStorage() {
+        static_assert(!is_tag_v<T>, "Tags have no storage");
+        return *getComponentArray<T>();
+    }
+    
+    // Streams every archetype chunk whose entities have all of Ts, calling
+    // func(count, entities, Ts* columns...) once per chunk. Non-const Ts are
+    // stamped as changed, like a View.
+    // Only populated in StorageMode::Archetype.
+    template<typename... Ts, typename Func>
+    void forEachChunk(Func&& func) {
+        ComponentMask mask;
+        (mask.set(getComponentType<std::remove_const_t<Ts>>()), ...);
+        
+        const ChangeTick tick = m_clock.now();
+        m_archetypes.forEachArchetype(mask, [&](Archetype& archetype) {
+            const size_t chunkCapacity = archetype.chunkCapacity();
+            for (size_t chunk = 0; chunk < archetype.chunkCount(); ++chunk) {
+                const size_t count = archetype.chunkSize(chunk);
+                func(count, archetype.chunkEntities(chunk),
+                     static_cast<Ts*>(archetype.chunkColumn(chunk, getComponentType<std::remove_const_t<Ts>>()))...);
+                (stampChunk<Ts>(archetype, chunk * chunkCapacity, count, tick), ...);
+            }
+        });
+        (markWritten<Ts>(), ...);
+    }
+    
+    // Calls func(Archetype&) for every non-empty archetype containing mask
+    template<typename Func>
+    void forEachArchetype(const ComponentMask& mask, Func&& func) const {
+        m_archetypes.forEachArchetype(mask, std::forward<Func>(func));
+    }
+    
     void entityDestroyed(EntityID entity) {
-        for (const auto& [typeIndex, componentArray] : m_componentArrays) {
-            componentArray->entityDestroyed(entity);
+        if (m_storageMode == StorageMode::Archetype) {
+            const ComponentMask removed = m_archetypes.entityDestroyed(entity);
+            for (ComponentType type = 0; type < m_poolsByType.size(); ++type) {
+                if (removed.test(type)) logRemoval(entity, type);
+            }
+            return;
         }
-    }
-
-private:
-    class IComponentArray {
-    public:
-        virtual ~IComponentArray() = default;
-        virtual void entityDestroyed(EntityID entity) = 0;
-    };
-      template<typename T>
-    class ComponentArray : public IComponentArray {
-    public:
-        void insertData(EntityID entity, T&& component) {
-            if (m_size >= MAX_COMPONENTS) {
-                throw std::runtime_error("Component array is full");
+        for (ComponentType type = 0; type < m_poolsByType.size(); ++type) {
+            if (m_poolsByType[type] && m_poolsByType[type]->entityDestroyed(entity)) {
+                logRemoval(entity, type);
             }
-            m_entityToIndexMap[entity] = m_size;
-            m_indexToEntityMap[m_size] = entity;
-            m_componentArray[m_size] = std::forward<T>(component);
-            ++m_size;
         }
+    }
+    
+    // Change detection clock. advanceChangeTick() returns the tick a consumer
+    // should remember; anything written afterwards compares newer than it.
+    ChangeTick getChangeTick() const { return m_clock.now(); }
+    ChangeTick advanceChangeTick() { return m_clock.advance(); }
+    
+    // nullptr if the entity does not have the component (always for tags)
+    const ComponentTicks* getComponentTicks(EntityID entity, ComponentType type) const {
+        if (m_tagMask.test(type)) return nullptr;
+        if (m_storageMode == StorageMode::Archetype) {
+            return m_archetypes.findTicks(entity, type);
+        }
+        return m_poolsByType[type]->findTicks(entity);
+    }
+    
+    // Records a write made through a reference obtained earlier
+    template<typename T>
+    void markChanged(EntityID entity) {
+        static_assert(!is_tag_v<T>, "Tags have no data");
+        const ComponentType type = getComponentType<T>();
+        const bool found = m_storageMode == StorageMode::Archetype
+            ? m_archetypes.markChanged(entity, type)
+            : getComponentArray<T>()->markChanged(entity);
+        if (found) {
+            markPoolChanged(type);
+        }
+    }
+    
+    // Newest tick at which any component of the type was added / written /
+    // removed - lets a consumer skip a whole type that has not changed
+    ChangeTick getLastAddedTick(ComponentType type) const { return m_poolTicks[type].added.load(std::memory_order_relaxed); }
+    ChangeTick getLastChangedTick(ComponentType type) const { return m_poolTicks[type].changed.load(std::memory_order_relaxed); }
+    ChangeTick getLastRemovedTick(ComponentType type) const { return m_poolTicks[type].removed.load(std::memory_order_relaxed); }
+    
+    void markPoolChanged(ComponentType type) { raiseTick(m_poolTicks[type].changed); }
+    
+    // func(EntityID) for every T removed (or destroyed with its entity) after since
+    template<typename T, typename Func>
+    void forEachRemoved(ChangeTick since, Func&& func) const {
+        for (const RemovedComponent& removed : m_removed[getComponentType<T>()]) {
+            if (removed.tick > since) func(removed.entity);
+        }
+    }
+    
+    // Drops removal records at or before the given tick
+    void pruneRemoved(ChangeTick upTo) {
+        for (auto& log : m_removed) {
+            log.erase(std::remove_if(log.begin(), log.end(),
+                                     [upTo](const RemovedComponent& removed) { return removed.tick <= upTo; }),
+                      log.end());
+        }
+    }
+    
+    // Makes this manager a copy of source: the same registrations, storage
+    // mode and component data, per-component ticks included. Pools and
+    // archetype chunks that already exist are overwritten in place, so copying
+    // from the same source repeatedly (snapshots) does not reallocate. The
+    // clock, pool-level ticks and removal logs stay this manager's own - call
+    // markAllAdded() if consumers should see the copied state as new.
+    // Throws if a component type is not copyable.
+    void copyFrom(const ComponentManager& source) {
+        if (&source == this) return;
         
-        void removeData(EntityID entity) {
-            auto it = m_entityToIndexMap.find(entity);
-            if (it == m_entityToIndexMap.end()) return;
-            
-            const size_t indexOfRemovedEntity = it->second;
-            const size_t indexOfLastElement = m_size - 1;
-            
-            // Move last element to removed position (if not the same)
-            if (indexOfRemovedEntity != indexOfLastElement) {
-                m_componentArray[indexOfRemovedEntity] = std::move(m_componentArray[indexOfLastElement]);
-                
-                const EntityID entityOfLastElement = m_indexToEntityMap[indexOfLastElement];
-                m_entityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
-                m_indexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
+        bool layoutChanged = m_nextComponentType != source.m_nextComponentType;
+        m_pools.resize(std::max(m_pools.size(), source.m_pools.size()));
+        for (size_t id = 0; id < m_pools.size(); ++id) {
+            PoolEntry& entry = m_pools[id];
+            const PoolEntry* from = id < source.m_pools.size() ? &source.m_pools[id] : nullptr;
+            if (!from || !from->registered) {
+                layoutChanged = layoutChanged || entry.registered;
+                entry = PoolEntry();
+                continue;
+            }
+            layoutChanged = layoutChanged || !entry.registered || entry.type != from->type;
+            entry.registered = true;
+            entry.type = from->type;
+            if (!from->array) {
+                entry.array.reset();
+            } else if (entry.array) {
+                entry.array->copyFrom(*from->array);
+            } else {
+                entry.array = from->array->clone();
+                entry.array->setClock(&m_clock);
             }
-            
-            m_entityToIndexMap.erase(entity);
-            m_indexToEntityMap.erase(indexOfLastElement);
-            --m_size;
         }
         
-        T& getData(EntityID entity) {
-            auto it = m_entityToIndexMap.find(entity);
-            if (it == m_entityToIndexMap.end()) {
-                throw std::runtime_error("Entity does not have this component");
-            }
-            return m_componentArray[it->second];
+        m_poolsByType.assign(source.m_poolsByType.size(), nullptr);
+        for (const PoolEntry& entry : m_pools) {
+            if (entry.registered) m_poolsByType[entry.type] = entry.array.get();
         }
+        m_nextComponentType = source.m_nextComponentType;
+        m_tagMask = source.m_tagMask;
+        m_tagNames = source.m_tagNames;
+        m_storageMode = source.m_storageMode;
         
-        const T& getData(EntityID entity) const {
-            auto it = m_entityToIndexMap.find(entity);
-            if (it == m_entityToIndexMap.end()) {
-                throw std::runtime_error("Entity does not have this component");
+        // Archetype masks are only comparable under the same type numbering
+        if (layoutChanged) {
+            m_archetypes.clear();
+        }
+        m_archetypes.copyFrom(source.m_archetypes);
+    }
+    
+    // Treats every live component as just added: stamps them all at the
+    // current tick, raises every pool's added/changed/removed tick and drops
+    // the removal logs. Used after a wholesale copy, so change consumers
+    // rebuild instead of diffing against state they never saw.
+    void markAllAdded() {
+        const ChangeTick tick = m_clock.now();
+        for (IComponentArray* componentArray : m_poolsByType) {
+            if (componentArray) componentArray->stampAll(tick);
+        }
+        m_archetypes.stampAll(tick);
+        for (ComponentType type = 0; type < m_poolsByType.size(); ++type) {
+            markPoolAdded(type);
+            raiseTick(m_poolTicks[type].removed);
+        }
+        for (auto& log : m_removed) {
+            log.clear();
+        }
+    }
+    
+    // Per-type memory usage, in registration order
+    std::vector<ComponentPoolStats> getMemoryReport() const {
+        std::vector<ComponentPoolStats> report(m_poolsByType.size());
+        for (ComponentType type = 0; type < m_poolsByType.size(); ++type) {
+            if (m_tagMask.test(type)) {
+                report[type].typeName = m_tagNames[type];
+                continue;
             }
-            return m_componentArray[it->second];
+            report[type] = m_storageMode == StorageMode::Archetype
+                ? m_archetypes.getMemoryStats(type)
+                : m_poolsByType[type]->getMemoryStats();
         }
-        
-        bool hasData(EntityID entity) const {
-            return m_entityToIndexMap.find(entity) != m_entityToIndexMap.end();
+        return report;
+    }
+
+private:
+    struct PoolChangeTicks {
+        std::atomic<ChangeTick> added{0};
+        std::atomic<ChangeTick> changed{0};
+        std::atomic<ChangeTick> removed{0};
+    };
+    
+    struct RemovedComponent {
+        EntityID entity;
+        ChangeTick tick;
+    };
+    
+    // Monotonic max - concurrent writers from worker threads never move it back
+    void raiseTick(std::atomic<ChangeTick>& target) const {
+        raiseTick(target, m_clock.now());
+    }
+    
+    static void raiseTick(std::atomic<ChangeTick>& target, ChangeTick tick) {
+        ChangeTick current = target.load(std::memory_order_relaxed);
+        while (current < tick && !target.compare_exchange_weak(current, tick, std::memory_order_relaxed)) {
+        }
+    }
+    
+    template<typename T>
+    void stampChunk(Archetype& archetype, size_t firstRow, size_t count, ChangeTick tick) {
+        if constexpr (!std::is_const_v<T>) {
+            ComponentTicks* ticks = archetype.columnTicks(getComponentType<T>()) + firstRow;
+            for (size_t row = 0; row < count; ++row) {
+                ticks[row].changed = tick;
+            }
+        }
+    }
+    
+    template<typename T>
+    void markWritten() {
+        if constexpr (!std::is_const_v<T>) {
+            markPoolChanged(getComponentType<T>());
         }
+    }
+    
+    void markPoolAdded(ComponentType type) {
+        raiseTick(m_poolTicks[type].added);
+        raiseTick(m_poolTicks[type].changed);
+    }
+    
+    void logRemoval(EntityID entity, ComponentType type) {
+        m_removed[type].push_back({entity, m_clock.now()});
+        raiseTick(m_poolTicks[type].removed);
+    }
+    
+    template<typename... Ts>
+    void addComponentsArchetype(const EntityID* entities, size_t count, const Ts&... prototype) {
+        ComponentMask mask;
+        (mask.set(getComponentType<Ts>()), ...);
+        mask &= ~m_tagMask;
+        if (mask.none()) return; // Only tags
         
-        void entityDestroyed(EntityID entity) override {
-            removeData(entity);
+        // Entities that already have components move one component at a time
+        std::vector<EntityID> fresh;
+        fresh.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (m_archetypes.contains(entities[i])) {
+                (insertArchetypeComponent(entities[i], prototype), ...);
+            } else {
+                fresh.push_back(entities[i]);
+            }
         }
         
-    private:
-        static constexpr size_t MAX_COMPONENTS = 5000;
-        std::array<T, MAX_COMPONENTS> m_componentArray;
-        std::unordered_map<EntityID, size_t> m_entityToIndexMap;
-        std::unordered_map<size_t, EntityID> m_indexToEntityMap;
-        size_t m_size = 0;
-    };private:
+        m_archetypes.insertNew(fresh.data(), fresh.size(), mask, [&](Archetype& archetype, uint32_t row) {
+            (constructArchetypeComponent(archetype, row, prototype), ...);
+        });
+    }
+    
+    template<typename T>
+    void insertArchetypeComponent(EntityID entity, const T& prototype) {
+        if constexpr (!is_tag_v<T>) {
+            m_archetypes.insert(entity, getComponentType<T>(), T(prototype));
+        }
+    }
+    
     template<typename T>
-    std::shared_ptr<ComponentArray<T>> getComponentArray() const {
-        const std::type_index typeIndex = std::type_index(typeid(T));
-        return std::static_pointer_cast<ComponentArray<T>>(m_componentArrays.at(typeIndex));
+    void constructArchetypeComponent(Archetype& archetype, uint32_t row, const T& prototype) {
+        if constexpr (!is_tag_v<T>) {
+            new (archetype.componentAddress(getComponentType<T>(), row)) T(prototype);
+        }
     }
     
-    std::unordered_map<std::type_index, ComponentType> m_componentTypes;
-    std::unordered_map<std::type_index, std::shared_ptr<IComponentArray>> m_componentArrays;
+    template<typename T>
+    void* findArchetypeComponent(EntityID entity) const {
+        void* component = m_archetypes.find(entity, getComponentType<T>());
+        if (!component) {
+            throw std::runtime_error("Entity does not have this component");
+        }
+        return component;
+    }
+    
+    struct PoolEntry {
+        std::unique_ptr<IComponentArray> array; // nullptr for tags
+        ComponentType type = 0;
+        bool registered = false;
+    };
+    
+    template<typename T>
+    const PoolEntry& poolEntry() const {
+        const size_t id = ComponentId<T>::value;
+        if (id >= m_pools.size() || !m_pools[id].registered) {
+            throw std::runtime_error("Component type not registered");
+        }
+        return m_pools[id];
+    }
+    
+    template<typename T>
+    ComponentArray<T>* getComponentArray() const {
+        return static_cast<ComponentArray<T>*>(poolEntry<T>().array.get());
+    }
+    
+    std::vector<PoolEntry> m_pools;              // Indexed by ComponentId<T>::value
+    std::vector<IComponentArray*> m_poolsByType; // Indexed by ComponentType
     ComponentType m_nextComponentType = 0;
-};
+    ComponentMask m_tagMask;
+    std::array<const char*, MAX_COMPONENTS> m_tagNames{};
+    
+    StorageMode m_storageMode = StorageMode::SparseSet;
+    ArchetypeStorage m_archetypes;
+    
+    ChangeClock m_clock;
+    std::array<PoolChangeTicks, MAX_COMPONENTS> m_poolTicks;
+    std::array<std::vector<RemovedComponent>, MAX_COMPONENTS> m_removed;
+};
\ No newline at end of file
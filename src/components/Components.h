@@ -11,14 +11,15 @@
 #include <algorithm>
 #include <cmath>
 #include <random>
+#include <type_traits>
 #include "../graphics/Renderer.h"
 #include <functional>
 #include "graphics/Renderer.h" // Include for Vector2, Rect, Texture, Color
+#include "Entity.h"
 
-using EntityID = uint32_t;
 using ComponentType = uint8_t;
 
-const ComponentType MAX_COMPONENTS = 32;
+const ComponentType MAX_COMPONENTS = 64;
 using ComponentMask = std::bitset<MAX_COMPONENTS>;
 
 // Base component class
@@ -27,6 +28,21 @@ public:
     virtual ~Component() = default;
 };
 
+// Base for tag components: data-less markers that occupy a signature bit but
+// no storage. Adding or removing a tag only changes the entity's ComponentMask.
+struct Tag {};
+
+template<typename T>
+inline constexpr bool is_tag_v = std::is_base_of_v<Tag, T>;
+
+// Marks entities that never move, e.g. walls and props; physics skips them
+struct Static : Tag {};
+
+// Marks resting rigid bodies, set and cleared by CollisionSystem: physics
+// skips them and the broadphase treats them as static until another collider
+// pushes into them or their Transform or RigidBody is written
+struct Sleeping : Tag {};
+
 // Transform component - every entity should have this
 class Transform : public Component {
 public:
@@ -38,6 +54,24 @@ public:
     Transform(const Vector2& pos) : position(pos), scale(1, 1), rotation(0.0f) {}
 };
 
+// The Transform as it was before the latest Scene::update, refreshed by the
+// scene for every entity that has one. RenderSystem draws such entities
+// between the two by Scene::getInterpolationAlpha(), so motion stays smooth
+// when frames and fixed simulation steps do not line up. Scene::update adds
+// one to every RigidBody entity; to interpolate anything else, construct it
+// from the entity's Transform so the first frame does not blend from the
+// origin.
+class PreviousTransform : public Component {
+public:
+    Vector2 position{0, 0};
+    Vector2 scale{1, 1};
+    float rotation = 0.0f;
+    
+    PreviousTransform() = default;
+    PreviousTransform(const Transform& transform)
+        : position(transform.position), scale(transform.scale), rotation(transform.rotation) {}
+};
+
 // Rotation component - separate from transform for node editor
 class Rotation : public Component {
 public:
@@ -74,6 +108,8 @@ public:
     }
 };
 
+class CollisionMask;
+
 // Collider component for physics/collision
 class Collider : public Component {
 public:
@@ -81,6 +117,10 @@ public:
     Vector2 size{32, 32};
     bool isTrigger = false;
     bool isStatic = false;
+    uint8_t layer = 0; // 0-31; which layers it meets is up to the scene's CollisionMatrix
+    // Optional solid pixels, from the top-left corner of the bounds; with one
+    // only overlapping solid pixels collide (shared between copies)
+    std::shared_ptr<const CollisionMask> mask;
     
     Collider(float width = 32, float height = 32) : size(width, height) {}
     Collider(const Vector2& sz) : size(sz) {}
@@ -98,6 +138,8 @@ public:
     float drag = 0.98f; // Air resistance
     float mass = 1.0f;
     bool useGravity = false;
+    bool canSleep = true;
+    float sleepTime = 0.0f; // Seconds spent below the sleep speed, see CollisionSystem
     
     void addForce(const Vector2& force) {
         acceleration = acceleration + (force * (1.0f / mass));
@@ -1085,6 +1127,8 @@ public:
 // ENVIRONMENT COMPONENTS
 //================================================================================
 
+class TileCollisionMap;
+
 // Environment Collider for world geometry
 class EnvironmentCollider : public Component {
 public:
@@ -1099,6 +1143,10 @@ public:
     Vector2 size{32, 32};
     float radius = 16.0f;
     std::vector<Vector2> vertices;
+    // Tilemap shape: solid cells, with the map's top-left corner at the
+    // entity's Transform position (see ProceduralMap::getCollisionMap())
+    std::shared_ptr<const TileCollisionMap> tilemap;
+    uint8_t layer = 0; // 0-31, see CollisionMatrix
     bool isOneWayPlatform = false;
     bool isSlope = false;
     float slopeAngle = 0.0f;
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+using EntityID = uint32_t;
+
+// Entity handles pack a slot index (low bits) and a generation (high bits).
+// The generation is bumped every time a slot is recycled, so a handle kept
+// around after its entity was destroyed no longer matches the new occupant.
+namespace Entity {
+    constexpr uint32_t INDEX_BITS = 20;
+    constexpr uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+    constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+    constexpr EntityID Null = 0;
+
+    constexpr uint32_t index(EntityID entity) { return entity & INDEX_MASK; }
+    constexpr uint32_t generation(EntityID entity) { return (entity >> INDEX_BITS) & GENERATION_MASK; }
+    constexpr EntityID makeHandle(uint32_t index, uint32_t generation) {
+        return ((generation & GENERATION_MASK) << INDEX_BITS) | (index & INDEX_MASK);
+    }
+}
@@ -1,70 +1,125 @@
 #pragma once
 
 #include "Components.h"
-#include <queue>
-#include <array>
+#include <algorithm>
+#include <vector>
 #include <stdexcept>
 
+// Allocates generational entity handles (see Entity:: in Components.h).
+//
+// m_slots holds one entry per slot index. For a living entity the entry is
+// its current handle, so the stored index equals the slot position. For a free
+// slot the entry instead stores the index of the next free slot together with
+// the generation the slot will have when it is reused - the free list lives
+// inside the slot table and needs no separate container or startup fill.
 class EntityManager {
 public:
     EntityManager() {
-        // Initialize the queue with all possible entity IDs
-        // Start from 1 since 0 is reserved as "null/invalid" entity
-        for (EntityID entity = 1; entity < MAX_ENTITIES; ++entity) {
-            m_availableEntities.push(entity);
-        }
+        // Slot 0 is reserved as the "null/invalid" entity
+        m_slots.push_back(Entity::Null);
+        m_signatures.emplace_back();
     }
-    
+
     EntityID createEntity() {
-        if (m_livingEntityCount >= MAX_ENTITIES) {
-            throw std::runtime_error("Too many entities in existence");
+        EntityID handle;
+        if (m_freeHead != NO_FREE_SLOT) {
+            // Reuse a destroyed slot with its bumped generation
+            const uint32_t index = m_freeHead;
+            const EntityID freeEntry = m_slots[index];
+            m_freeHead = Entity::index(freeEntry);
+            handle = Entity::makeHandle(index, Entity::generation(freeEntry));
+            m_slots[index] = handle;
+        } else {
+            // Grow on demand - there is no fixed entity ceiling below the index range
+            const uint32_t index = static_cast<uint32_t>(m_slots.size());
+            if (index >= NO_FREE_SLOT) {
+                throw std::runtime_error("Too many entities in existence");
+            }
+            handle = Entity::makeHandle(index, 0);
+            m_slots.push_back(handle);
+            m_signatures.emplace_back();
         }
-        
-        const EntityID id = m_availableEntities.front();
-        m_availableEntities.pop();
+
         ++m_livingEntityCount;
-        
-        return id;
+        return handle;
     }
-    
+
+    // Creates count entities, reusing free slots first and growing the slot
+    // table at most once
+    std::vector<EntityID> createEntities(size_t count) {
+        std::vector<EntityID> entities;
+        entities.reserve(count);
+        if (m_slots.size() + count > m_slots.capacity()) {
+            const size_t capacity = std::max(m_slots.size() + count, m_slots.capacity() * 2);
+            m_slots.reserve(capacity);
+            m_signatures.reserve(capacity);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            entities.push_back(createEntity());
+        }
+        return entities;
+    }
+
     void destroyEntity(EntityID entity) {
-        if (entity == 0 || entity >= MAX_ENTITIES) {
+        if (!isAlive(entity)) {
             throw std::runtime_error("Invalid entity ID");
         }
-        
-        m_signatures[entity].reset();
-        m_availableEntities.push(entity);
+
+        const uint32_t index = Entity::index(entity);
+        m_signatures[index].reset();
+        m_slots[index] = Entity::makeHandle(m_freeHead, Entity::generation(entity) + 1);
+        m_freeHead = index;
         --m_livingEntityCount;
     }
-    
+
+    // O(1) - false for the null handle, destroyed entities and stale handles
+    bool isAlive(EntityID entity) const noexcept {
+        const uint32_t index = Entity::index(entity);
+        return index != 0 && index < m_slots.size() && m_slots[index] == entity;
+    }
+
     void setSignature(EntityID entity, const ComponentMask& signature) {
-        if (entity == 0 || entity >= MAX_ENTITIES) {
+        if (!isAlive(entity)) {
             throw std::runtime_error("Invalid entity ID");
         }
-        
-        m_signatures[entity] = signature;
+
+        m_signatures[Entity::index(entity)] = signature;
     }
-    
+
     const ComponentMask& getSignature(EntityID entity) const {
-        if (entity == 0 || entity >= MAX_ENTITIES) {
+        if (!isAlive(entity)) {
             throw std::runtime_error("Invalid entity ID");
         }
-        
-        return m_signatures[entity];
+
+        return m_signatures[Entity::index(entity)];
+    }
+
+    // Current handle occupying a slot, or Entity::Null if the slot is free
+    EntityID getEntityAtIndex(uint32_t index) const noexcept {
+        if (index == 0 || index >= m_slots.size()) return Entity::Null;
+        const EntityID entry = m_slots[index];
+        return Entity::index(entry) == index ? entry : Entity::Null;
     }
-    
+
     uint32_t getLivingEntityCount() const noexcept {
         return m_livingEntityCount;
     }
-    
-    static constexpr uint32_t getMaxEntities() noexcept {
-        return MAX_ENTITIES;
+
+    // One past the highest slot index handed out so far
+    uint32_t getEntityCapacity() const noexcept {
+        return static_cast<uint32_t>(m_slots.size());
+    }
+
+    size_t getMemoryUsage() const noexcept {
+        return m_slots.capacity() * sizeof(EntityID) +
+               m_signatures.capacity() * sizeof(ComponentMask);
     }
 
 private:
-    static constexpr uint32_t MAX_ENTITIES = 5000;
-    
-    std::queue<EntityID> m_availableEntities;
-    std::array<ComponentMask, MAX_ENTITIES> m_signatures;
+    static constexpr uint32_t NO_FREE_SLOT = Entity::INDEX_MASK;
+
+    std::vector<EntityID> m_slots;
+    std::vector<ComponentMask> m_signatures;
+    uint32_t m_freeHead = NO_FREE_SLOT;
     uint32_t m_livingEntityCount = 0;
 };
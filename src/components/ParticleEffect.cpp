@@ -155,8 +155,8 @@ Color ParticleEffect::interpolateColor(const Color& start, const Color& end, flo
 }
 
 float ParticleEffect::randomFloat(float min, float max) const {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
+    // Effects update on worker threads, so each thread keeps its own generator
+    static thread_local std::mt19937 gen(std::random_device{}());
     std::uniform_real_distribution<float> dis(min, max);
     return dis(gen);
 }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// Dense per-family type IDs, handed out on first use of each type.
+//
+// ComponentId<T>::value, SystemId<T>::value, ResourceId<T>::value and
+// EventId<T>::value are plain static constants, so looking a type up is an
+// array index instead of a type_index hash. IDs are process-wide and
+// independent of registration order; ComponentManager maps them to per-scene
+// ComponentType bits.
+template<typename Family>
+class TypeIdFamily {
+public:
+    static size_t next() {
+        static std::atomic<size_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+struct ComponentIdFamily {};
+struct SystemIdFamily {};
+struct ResourceIdFamily {};
+struct EventIdFamily {};
+
+template<typename T>
+struct ComponentId {
+    static_assert(!std::is_const_v<T> && !std::is_reference_v<T>, "Use the plain component type");
+    static inline const size_t value = TypeIdFamily<ComponentIdFamily>::next();
+};
+
+template<typename T>
+struct SystemId {
+    static inline const size_t value = TypeIdFamily<SystemIdFamily>::next();
+};
+
+template<typename T>
+struct ResourceId {
+    static_assert(!std::is_const_v<T> && !std::is_reference_v<T>, "Use the plain resource type");
+    static inline const size_t value = TypeIdFamily<ResourceIdFamily>::next();
+};
+
+template<typename T>
+struct EventId {
+    static_assert(!std::is_const_v<T> && !std::is_reference_v<T>, "Use the plain event type");
+    static inline const size_t value = TypeIdFamily<EventIdFamily>::next();
+};
@@ -0,0 +1,287 @@
+#pragma once
+
+#include "Components.h"
+#include "ComponentManager.h"
+#include "EntityManager.h"
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Iterates every entity that has all of Ts (and none of the excluded types),
+// handing the components to a callback by reference. Nothing is allocated.
+//
+// In sparse-set mode the view walks the dense entity list of the smallest
+// requested pool and checks each candidate's signature; in archetype mode it
+// streams the columns of every matching archetype chunk.
+//
+// Request read-only access with a const type, e.g. view<const Transform>().
+// Tags (see Tag) carry no data, so they are filtered with with<>/exclude<>
+// rather than listed in Ts.
+// Non-const types count as written: every visited component is stamped with
+// the current change tick. added<Us...>(since) / changed<Us...>(since) narrow
+// the view to entities whose Us were added / written after a tick the caller
+// remembered (see ComponentManager::advanceChangeTick()).
+// Adding or removing components of the viewed types (or destroying entities)
+// from inside each() is not supported.
+template<typename... Ts>
+class View {
+    static_assert(sizeof...(Ts) > 0, "A view needs at least one component type");
+    static_assert(!(is_tag_v<std::remove_const_t<Ts>> || ...), "Filter tags with with<>() instead");
+
+public:
+    View(ComponentManager& components, const EntityManager& entities)
+        : m_components(components), m_entities(entities) {
+        (m_include.set(m_components.getComponentType<std::remove_const_t<Ts>>()), ...);
+    }
+
+    // Only entities that also have all of Us (components or tags), without
+    // fetching them
+    template<typename... Us>
+    View& with() {
+        (m_include.set(m_components.getComponentType<Us>()), ...);
+        return *this;
+    }
+    
+    // Skips entities that have any of Us
+    template<typename... Us>
+    View& exclude() {
+        (m_exclude.set(m_components.getComponentType<Us>()), ...);
+        return *this;
+    }
+
+    // Only entities where at least one of Us was added after since
+    template<typename... Us>
+    View& added(ChangeTick since) {
+        return addTickFilter<Us...>(m_addedFilter, since);
+    }
+
+    // Only entities where at least one of Us was added or written after since
+    template<typename... Us>
+    View& changed(ChangeTick since) {
+        return addTickFilter<Us...>(m_changedFilter, since);
+    }
+
+    // func(EntityID, Ts&...)
+    template<typename Func>
+    void each(Func&& func) {
+        eachInRange(0, static_cast<size_t>(-1), func);
+    }
+
+    // Number of candidate positions a range split can address: the smallest
+    // pool's size in sparse-set mode, or the total rows of every matching
+    // archetype. Entities filtered out by the signature still count.
+    size_t workSize() const {
+        if (m_components.getStorageMode() == StorageMode::Archetype) {
+            size_t total = 0;
+            forEachMatchingArchetype([&](const Archetype& archetype) { total += archetype.size(); });
+            return total;
+        }
+        return smallestPool().second;
+    }
+
+    // Like each(), restricted to candidate positions [begin, end) of workSize().
+    // Disjoint ranges visit disjoint entities, so they may run concurrently.
+    template<typename Func>
+    void eachInRange(size_t begin, size_t end, Func&& func) {
+        if (!canMatchTickFilters()) return;
+        markWrittenPools();
+        if (m_components.getStorageMode() == StorageMode::Archetype) {
+            eachArchetypeInRange(begin, end, func);
+        } else {
+            eachSparseSetInRange(begin, end, func);
+        }
+    }
+
+private:
+    template<typename T>
+    using Pool = ComponentArray<std::remove_const_t<T>>;
+
+    // Tick-based filter over up to MAX_COMPONENTS types: passes if any of them
+    // has a tick newer than since
+    struct TickFilter {
+        std::array<ComponentType, MAX_COMPONENTS> types;
+        size_t count = 0;
+        ChangeTick since = 0;
+
+        bool active() const { return count > 0; }
+    };
+
+    template<typename... Us>
+    View& addTickFilter(TickFilter& filter, ChangeTick since) {
+        static_assert(!(is_tag_v<Us> || ...), "Tags carry no change ticks");
+        auto addType = [&](ComponentType type) {
+            m_include.set(type);
+            for (size_t i = 0; i < filter.count; ++i) {
+                if (filter.types[i] == type) return;
+            }
+            filter.types[filter.count++] = type;
+        };
+        (addType(m_components.getComponentType<Us>()), ...);
+        filter.since = since;
+        return *this;
+    }
+
+    // Cheap whole-view reject using the per-pool newest ticks
+    bool canMatchTickFilters() const {
+        auto poolCanMatch = [this](const TickFilter& filter, bool added) {
+            if (!filter.active()) return true;
+            for (size_t i = 0; i < filter.count; ++i) {
+                const ChangeTick newest = added ? m_components.getLastAddedTick(filter.types[i])
+                                                : m_components.getLastChangedTick(filter.types[i]);
+                if (newest > filter.since) return true;
+            }
+            return false;
+        };
+        return poolCanMatch(m_addedFilter, true) && poolCanMatch(m_changedFilter, false);
+    }
+
+    // ticksOf(type) returns the entity's ComponentTicks for a filtered type
+    template<typename TicksOf>
+    bool passesTickFilters(TicksOf&& ticksOf) const {
+        auto passes = [&](const TickFilter& filter, bool added) {
+            if (!filter.active()) return true;
+            for (size_t i = 0; i < filter.count; ++i) {
+                const ComponentTicks& ticks = ticksOf(filter.types[i]);
+                if ((added ? ticks.added : ticks.changed) > filter.since) return true;
+            }
+            return false;
+        };
+        return passes(m_addedFilter, true) && passes(m_changedFilter, false);
+    }
+
+    bool hasTickFilters() const { return m_addedFilter.active() || m_changedFilter.active(); }
+
+    void markWrittenPools() {
+        auto mark = [this](auto* typeTag) {
+            using T = std::remove_pointer_t<decltype(typeTag)>;
+            if constexpr (!std::is_const_v<T>) {
+                m_components.markPoolChanged(m_components.getComponentType<T>());
+            }
+        };
+        (mark(static_cast<Ts*>(nullptr)), ...);
+    }
+
+    // Component reference for a sparse-set entity, stamping it if writable
+    template<typename T>
+    static T& access(Pool<T>* pool, EntityID entity, ChangeTick tick) {
+        const uint32_t index = pool->indexOf(entity);
+        if constexpr (!std::is_const_v<T>) {
+            pool->ticksAt(index).changed = tick;
+        }
+        return pool->componentAt(index);
+    }
+
+    // Dense entity list of the smallest requested pool and its size
+    std::pair<const EntityID*, size_t> smallestPool() const {
+        const EntityID* candidates = nullptr;
+        size_t candidateCount = 0;
+        bool first = true;
+        auto consider = [&](const auto& pool) {
+            if (first || pool.size() < candidateCount) {
+                candidates = pool.entities();
+                candidateCount = pool.size();
+                first = false;
+            }
+        };
+        (consider(m_components.getComponentStorage<std::remove_const_t<Ts>>()), ...);
+        return {candidates, candidateCount};
+    }
+
+    template<typename Func>
+    void eachSparseSetInRange(size_t begin, size_t end, Func& func) {
+        std::tuple<Pool<Ts>*...> pools(&m_components.getComponentStorage<std::remove_const_t<Ts>>()...);
+
+        // Drive the iteration from the smallest pool
+        const auto [candidates, candidateCount] = smallestPool();
+        end = std::min(end, candidateCount);
+
+        const ChangeTick tick = m_components.getChangeTick();
+        const bool filtered = hasTickFilters();
+        for (size_t i = begin; i < end; ++i) {
+            const EntityID entity = candidates[i];
+            const ComponentMask& signature = m_entities.getSignature(entity);
+            if ((signature & m_include) != m_include || (signature & m_exclude).any()) continue;
+            if (filtered && !passesTickFilters([&](ComponentType type) -> const ComponentTicks& {
+                    return *m_components.getComponentTicks(entity, type);
+                })) continue;
+
+            func(entity, access<Ts>(std::get<Pool<Ts>*>(pools), entity, tick)...);
+        }
+    }
+
+    template<typename T>
+    void stampArchetype(Archetype& archetype, uint32_t row, ChangeTick tick) {
+        if constexpr (!std::is_const_v<T>) {
+            archetype.ticks(m_components.getComponentType<std::remove_const_t<T>>(), row).changed = tick;
+        }
+    }
+
+    // Tags are not part of archetype masks; rows are checked against the
+    // entity signature instead
+    bool passesTagFilter(const ComponentMask& signature, const ComponentMask& tags) const {
+        const ComponentMask include = m_include & tags;
+        return (signature & include) == include && !(signature & m_exclude & tags).any();
+    }
+    
+    // The storage owns its archetypes through pointers, so they are mutable
+    // even when reached through the const traversal
+    template<typename Func>
+    void forEachMatchingArchetype(Func&& func) const {
+        const ComponentMask& tags = m_components.getTagMask();
+        const ComponentMask exclude = m_exclude & ~tags;
+        m_components.forEachArchetype(m_include & ~tags, [&](Archetype& archetype) {
+            if ((archetype.getMask() & exclude).any()) return;
+            func(archetype);
+        });
+    }
+
+    template<typename Func>
+    void eachArchetypeInRange(size_t begin, size_t end, Func& func) {
+        // Row positions are numbered across matching archetypes in visit order
+        const ChangeTick tick = m_components.getChangeTick();
+        const bool filtered = hasTickFilters();
+        const ComponentMask& tags = m_components.getTagMask();
+        const bool tagFiltered = ((m_include | m_exclude) & tags).any();
+        size_t base = 0;
+        forEachMatchingArchetype([&](Archetype& archetype) {
+            const size_t archetypeEnd = base + archetype.size();
+            if (archetypeEnd <= begin || base >= end) {
+                base = archetypeEnd;
+                return;
+            }
+
+            const size_t firstRow = begin > base ? begin - base : 0;
+            const size_t lastRow = std::min(end, archetypeEnd) - base;
+            const size_t chunkCapacity = archetype.chunkCapacity();
+            for (size_t chunk = firstRow / chunkCapacity; chunk * chunkCapacity < lastRow; ++chunk) {
+                const EntityID* entities = archetype.chunkEntities(chunk);
+                std::tuple<Ts*...> columns(static_cast<Ts*>(
+                    archetype.chunkColumn(chunk, m_components.getComponentType<std::remove_const_t<Ts>>()))...);
+
+                const size_t chunkStart = chunk * chunkCapacity;
+                const size_t rowBegin = std::max(firstRow, chunkStart) - chunkStart;
+                const size_t rowEnd = std::min(lastRow, chunkStart + archetype.chunkSize(chunk)) - chunkStart;
+                for (size_t row = rowBegin; row < rowEnd; ++row) {
+                    const uint32_t archetypeRow = static_cast<uint32_t>(chunkStart + row);
+                    if (tagFiltered && !passesTagFilter(m_entities.getSignature(entities[row]), tags)) continue;
+                    if (filtered && !passesTickFilters([&](ComponentType type) -> const ComponentTicks& {
+                            return archetype.ticks(type, archetypeRow);
+                        })) continue;
+
+                    (stampArchetype<Ts>(archetype, archetypeRow, tick), ...);
+                    func(entities[row], std::get<Ts*>(columns)[row]...);
+                }
+            }
+            base = archetypeEnd;
+        });
+    }
+
+    ComponentManager& m_components;
+    const EntityManager& m_entities;
+    ComponentMask m_include;
+    ComponentMask m_exclude;
+    TickFilter m_addedFilter;
+    TickFilter m_changedFilter;
+};
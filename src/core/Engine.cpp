@@ -1,4 +1,5 @@
 #include "Engine.h"
+#include "JobSystem.h"
 #include "graphics/Renderer.h"
 #include "input/InputManager.h"
 #include "audio/AudioManager.h"
@@ -7,7 +8,9 @@
 
 #include <SDL2/SDL.h>
 #include <chrono>
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 
 Engine& Engine::getInstance() {
     static Engine instance;
@@ -45,12 +48,14 @@ bool Engine::initialize(const std::string& title, int width, int height) {
 }
 
 void Engine::run() {
-    auto lastTime = std::chrono::high_resolution_clock::now();
+    using Clock = std::chrono::high_resolution_clock;
+    auto lastTime = Clock::now();
+    float accumulator = 0.0f;
     
     while (m_running) {
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        m_deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
-        lastTime = currentTime;
+        const auto frameStart = Clock::now();
+        m_deltaTime = std::chrono::duration<float>(frameStart - lastTime).count();
+        lastTime = frameStart;
         
         // Handle events
         SDL_Event event;
@@ -69,13 +74,31 @@ void Engine::run() {
             m_inputManager->update();
         }
         
-        update(m_deltaTime);
+        // Fixed steps; whatever the cap leaves over is dropped rather than
+        // carried, keeping only the part of a step the renderer blends across
+        accumulator += m_deltaTime;
+        int substeps = 0;
+        while (accumulator >= m_fixedTimestep && substeps < m_maxSubsteps) {
+            update(m_fixedTimestep);
+            accumulator -= m_fixedTimestep;
+            ++substeps;
+        }
+        if (accumulator >= m_fixedTimestep) {
+            accumulator = std::fmod(accumulator, m_fixedTimestep);
+        }
+        m_interpolationAlpha = accumulator / m_fixedTimestep;
         
         // Render
         render();
         
-        // Cap framerate (roughly 60 FPS)
-        SDL_Delay(16);
+        // Sleep off whatever is left of the frame budget
+        if (m_frameRateLimit > 0) {
+            const float frameTime = std::chrono::duration<float>(Clock::now() - frameStart).count();
+            const float remaining = 1.0f / m_frameRateLimit - frameTime;
+            if (remaining > 0.001f) {
+                SDL_Delay(static_cast<Uint32>(remaining * 1000.0f));
+            }
+        }
     }
 }
 
@@ -90,18 +113,51 @@ void Engine::render() {
         m_renderer->clear();
         
         if (m_activeScene) {
-            m_activeScene->render(m_renderer.get());
+            m_activeScene->render(m_renderer.get(), m_interpolationAlpha);
         }
         
         m_renderer->present();
     }
 }
 
+JobSystem& Engine::getJobSystem() {
+    // Systems on worker threads ask every frame, so only creation locks
+    if (JobSystem* jobSystem = m_jobSystemPtr.load(std::memory_order_acquire)) {
+        return *jobSystem;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_jobSystemMutex);
+    if (!m_jobSystem) {
+        m_jobSystem = std::make_unique<JobSystem>();
+        m_jobSystemPtr.store(m_jobSystem.get(), std::memory_order_release);
+    }
+    return *m_jobSystem;
+}
+
+void Engine::setFixedTimestep(float seconds) {
+    if (!(seconds > 0.0f)) {
+        throw std::runtime_error("Fixed timestep must be positive");
+    }
+    m_fixedTimestep = seconds;
+}
+
+void Engine::setMaxSubsteps(int substeps) {
+    if (substeps < 1) {
+        throw std::runtime_error("Max substeps must be at least 1");
+    }
+    m_maxSubsteps = substeps;
+}
+
 void Engine::setActiveScene(std::shared_ptr<Scene> scene) {
     m_activeScene = scene;
 }
 
 void Engine::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_jobSystemMutex);
+        m_jobSystemPtr.store(nullptr, std::memory_order_release);
+        m_jobSystem.reset();
+    }
     m_activeScene.reset();
     m_renderer.reset();
     m_inputManager.reset();
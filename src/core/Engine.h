@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 
 // Forward declarations
@@ -9,6 +11,7 @@ class Renderer;
 class InputManager;
 class AudioManager;
 class ResourceManager;
+class JobSystem;
 
 class Engine {
 public:
@@ -23,6 +26,8 @@ public:
     InputManager* getInputManager() const { return m_inputManager.get(); }
     AudioManager* getAudioManager() const { return m_audioManager.get(); }
     ResourceManager* getResourceManager() const { return m_resourceManager.get(); }
+    // Created on first use, so headless tools and the editor get one without initialize()
+    JobSystem& getJobSystem();
     
     // Scene management
     void setActiveScene(std::shared_ptr<Scene> scene);
@@ -32,7 +37,25 @@ public:
     bool isRunning() const { return m_running; }
     void quit() { m_running = false; }
     
+    // Wall-clock time of the last frame; the scene itself always advances in
+    // steps of getFixedTimestep()
     float getDeltaTime() const { return m_deltaTime; }
+    
+    // Simulation rate. At most maxSubsteps steps run per frame; any backlog
+    // beyond that is dropped, so a slow frame cannot snowball into slower
+    // ones. Both throw if not positive.
+    void setFixedTimestep(float seconds);
+    float getFixedTimestep() const { return m_fixedTimestep; }
+    void setMaxSubsteps(int substeps);
+    int getMaxSubsteps() const { return m_maxSubsteps; }
+    
+    // Fraction of a step left unsimulated when the last frame was drawn
+    float getInterpolationAlpha() const { return m_interpolationAlpha; }
+    
+    // Frames per second to sleep down to; 0 renders as fast as possible
+    void setFrameRateLimit(int framesPerSecond) { m_frameRateLimit = framesPerSecond > 0 ? framesPerSecond : 0; }
+    int getFrameRateLimit() const { return m_frameRateLimit; }
+
     int getWindowWidth() const { return m_windowWidth; }
     int getWindowHeight() const { return m_windowHeight; }
 
@@ -49,6 +72,10 @@ private:
     int m_windowWidth = 0;
     int m_windowHeight = 0;
     float m_deltaTime = 0.0f;
+    float m_fixedTimestep = 1.0f / 60.0f;
+    int m_maxSubsteps = 5;
+    float m_interpolationAlpha = 1.0f;
+    int m_frameRateLimit = 60;
     
     std::shared_ptr<Scene> m_activeScene;
     
@@ -56,4 +83,7 @@ private:
     std::unique_ptr<InputManager> m_inputManager;
     std::unique_ptr<AudioManager> m_audioManager;
     std::unique_ptr<ResourceManager> m_resourceManager;
+    std::unique_ptr<JobSystem> m_jobSystem;
+    std::atomic<JobSystem*> m_jobSystemPtr{nullptr}; // Read without the lock once set
+    std::mutex m_jobSystemMutex;                     // Guards creation and shutdown
 };
@@ -0,0 +1,205 @@
+#include "JobSystem.h"
+
+namespace {
+    // Identifies the pool (and slot) a worker thread belongs to
+    thread_local const JobSystem* t_ownerSystem = nullptr;
+    thread_local size_t t_workerIndex = 0;
+    // Jobs being executed on this thread, counting ones run inside wait()
+    thread_local size_t t_jobDepth = 0;
+}
+
+JobSystem::JobSystem(size_t workerCount) {
+    if (workerCount == 0) {
+        const unsigned hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    m_statsStart = std::chrono::steady_clock::now();
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    // Start threads only once every deque exists, since workers steal from each other
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_workers[i]->thread = std::thread([this, i]() { workerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_sleepCondition.notify_all();
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+void JobSystem::submit(Job job, JobCounter* counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const size_t self = currentWorkerIndex();
+    if (self != NOT_A_WORKER) {
+        Worker& worker = *m_workers[self];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.deque.push_back({std::move(job), counter});
+    } else {
+        std::lock_guard<std::mutex> lock(m_sharedMutex);
+        m_sharedQueue.push_back({std::move(job), counter});
+    }
+    m_queuedJobs.fetch_add(1, std::memory_order_release);
+
+    {
+        // Taking the lock orders this notify after a sleeper's predicate check
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCondition.notify_one();
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    const size_t self = currentWorkerIndex();
+    while (!counter.isDone()) {
+        if (!tryRunOne(self)) {
+            std::this_thread::yield();
+        }
+    }
+    
+    if (counter.m_failed.load(std::memory_order_acquire)) {
+        // Leave the counter reusable
+        std::exception_ptr exception = std::move(counter.m_exception);
+        counter.m_exception = nullptr;
+        counter.m_failed.store(false, std::memory_order_relaxed);
+        std::rethrow_exception(exception);
+    }
+}
+
+std::vector<JobWorkerStats> JobSystem::getWorkerStats() const {
+    const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_statsStart).count();
+
+    std::vector<JobWorkerStats> stats(m_workers.size());
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        const Worker& worker = *m_workers[i];
+        stats[i].jobsExecuted = worker.jobsExecuted.load(std::memory_order_relaxed);
+        stats[i].jobsStolen = worker.jobsStolen.load(std::memory_order_relaxed);
+        stats[i].busySeconds = worker.busyNanoseconds.load(std::memory_order_relaxed) * 1e-9;
+        stats[i].utilisation = wallSeconds > 0.0 ? stats[i].busySeconds / wallSeconds : 0.0;
+    }
+    return stats;
+}
+
+void JobSystem::resetStats() {
+    for (auto& worker : m_workers) {
+        worker->jobsExecuted = 0;
+        worker->jobsStolen = 0;
+        worker->busyNanoseconds = 0;
+    }
+    m_statsStart = std::chrono::steady_clock::now();
+}
+
+void JobSystem::workerLoop(size_t index) {
+    t_ownerSystem = this;
+    t_workerIndex = index;
+
+    while (!m_stopping.load(std::memory_order_acquire)) {
+        if (tryRunOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.wait(lock, [this]() {
+            return m_stopping.load(std::memory_order_acquire) ||
+                   m_queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+bool JobSystem::tryRunOne(size_t selfIndex) {
+    QueuedJob job;
+    const bool found = (selfIndex != NOT_A_WORKER && popLocal(selfIndex, job)) ||
+                       popShared(job) ||
+                       steal(selfIndex, job);
+    if (!found) return false;
+
+    execute(job, selfIndex);
+    return true;
+}
+
+bool JobSystem::popLocal(size_t index, QueuedJob& out) {
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.deque.empty()) return false;
+
+    out = std::move(worker.deque.back());
+    worker.deque.pop_back();
+    m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::popShared(QueuedJob& out) {
+    std::lock_guard<std::mutex> lock(m_sharedMutex);
+    if (m_sharedQueue.empty()) return false;
+
+    out = std::move(m_sharedQueue.front());
+    m_sharedQueue.pop_front();
+    m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::steal(size_t thiefIndex, QueuedJob& out) {
+    const size_t count = m_workers.size();
+    const size_t start = thiefIndex == NOT_A_WORKER ? 0 : thiefIndex + 1;
+    for (size_t offset = 0; offset < count; ++offset) {
+        const size_t victim = (start + offset) % count;
+        if (victim == thiefIndex) continue;
+
+        Worker& worker = *m_workers[victim];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.deque.empty()) continue;
+
+        // Oldest job first - usually the largest remaining piece of work
+        out = std::move(worker.deque.front());
+        worker.deque.pop_front();
+        m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        if (thiefIndex != NOT_A_WORKER) {
+            m_workers[thiefIndex]->jobsStolen.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(QueuedJob& job, size_t workerIndex) {
+    // A job run inside another job's wait() is already in that job's time
+    const bool outermost = t_jobDepth++ == 0;
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        job.job();
+    } catch (...) {
+        // The counter must still come down, or its wait() never returns
+        bool expected = false;
+        if (job.counter && job.counter->m_failed.compare_exchange_strong(expected, true, std::memory_order_relaxed)) {
+            job.counter->m_exception = std::current_exception();
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    --t_jobDepth;
+
+    if (workerIndex != NOT_A_WORKER) {
+        Worker& worker = *m_workers[workerIndex];
+        worker.jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+        if (outermost) {
+            worker.busyNanoseconds.fetch_add(
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                std::memory_order_relaxed);
+        }
+    }
+
+    if (job.counter) {
+        job.counter->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+size_t JobSystem::currentWorkerIndex() const {
+    return t_ownerSystem == this ? t_workerIndex : NOT_A_WORKER;
+}
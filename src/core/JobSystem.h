@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Tracks a group of jobs. wait() returns once every job submitted with the
+// counter has finished, and rethrows the first exception one of them threw.
+class JobCounter {
+public:
+    bool isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<uint32_t> m_pending{0};
+    std::atomic<bool> m_failed{false};
+    std::exception_ptr m_exception; // Written once, by the job that set m_failed
+};
+
+// Per-worker statistics since the last resetStats()
+struct JobWorkerStats {
+    uint64_t jobsExecuted = 0;
+    uint64_t jobsStolen = 0;     // Taken from another worker's deque
+    double busySeconds = 0.0;    // In outermost jobs; nested ones run inside wait() count toward their parent
+    double utilisation = 0.0;    // busySeconds / wall time
+};
+
+// Work-stealing job scheduler.
+//
+// Each worker owns a deque: it pushes and pops its own jobs at the back
+// (newest first, cache-warm) while idle workers steal from the front of other
+// deques. Jobs submitted from threads outside the pool go to a shared queue.
+// wait() never blocks idly - the waiting thread runs queued jobs until its
+// counter reaches zero - so jobs may submit and wait on nested jobs.
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    // workerCount == 0 picks hardware_concurrency() - 1 (at least one)
+    explicit JobSystem(size_t workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // counter may be nullptr for fire-and-forget jobs; an exception thrown by
+    // such a job is dropped
+    void submit(Job job, JobCounter* counter = nullptr);
+
+    // Runs queued jobs on the calling thread until the counter reaches zero,
+    // then rethrows the first exception a job of the counter threw
+    void wait(JobCounter& counter);
+
+    // Calls func(begin, end) over [first, last) split into ranges of at most
+    // grainSize elements, and waits for all of them
+    template<typename Func>
+    void parallel_for(size_t first, size_t last, size_t grainSize, Func&& func) {
+        if (first >= last) return;
+        grainSize = std::max<size_t>(1, grainSize);
+        if (last - first <= grainSize) {
+            func(first, last);
+            return;
+        }
+
+        JobCounter counter;
+        for (size_t begin = first; begin < last; begin += grainSize) {
+            const size_t end = std::min(last, begin + grainSize);
+            submit([&func, begin, end]() { func(begin, end); }, &counter);
+        }
+        wait(counter);
+    }
+
+    // Calls func(EntityID, Ts&...) for every entity of a View, split into
+    // ranges of grainSize entities. func runs concurrently and must only touch
+    // the components it is handed.
+    template<typename ViewType, typename Func>
+    void parallel_for(ViewType& view, size_t grainSize, Func&& func) {
+        parallel_for(size_t(0), view.workSize(), grainSize, [&view, &func](size_t begin, size_t end) {
+            view.eachInRange(begin, end, func);
+        });
+    }
+
+    size_t getWorkerCount() const { return m_workers.size(); }
+    std::vector<JobWorkerStats> getWorkerStats() const;
+    void resetStats();
+
+private:
+    struct QueuedJob {
+        Job job;
+        JobCounter* counter;
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::deque<QueuedJob> deque;
+        std::mutex mutex;
+        std::atomic<uint64_t> jobsExecuted{0};
+        std::atomic<uint64_t> jobsStolen{0};
+        std::atomic<uint64_t> busyNanoseconds{0};
+    };
+
+    void workerLoop(size_t index);
+    bool tryRunOne(size_t selfIndex);
+    bool popLocal(size_t index, QueuedJob& out);
+    bool popShared(QueuedJob& out);
+    bool steal(size_t thiefIndex, QueuedJob& out);
+    void execute(QueuedJob& job, size_t workerIndex);
+
+    static constexpr size_t NOT_A_WORKER = static_cast<size_t>(-1);
+    size_t currentWorkerIndex() const;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::deque<QueuedJob> m_sharedQueue;
+    std::mutex m_sharedMutex;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<size_t> m_queuedJobs{0};
+    std::atomic<bool> m_stopping{false};
+
+    std::chrono::steady_clock::time_point m_statsStart;
+};
@@ -2,6 +2,7 @@
 #include "GameEditor.h"
 #include "../core/Engine.h"
 #include "../utils/ResourceManager.h"
+#include "../physics/CollisionMask.h"
 #include <algorithm>
 #include <cmath>
 
@@ -140,6 +141,12 @@ void CollisionEditorWindow::renderCollisionEditor() {
     ImGui::SameLine();
     ImGui::Checkbox("Is Static", &collider.isStatic);
     
+    int layer = collider.layer;
+    if (ImGui::SliderInt("Layer", &layer, 0, CollisionMatrix::LAYER_COUNT - 1)) {
+        collider.layer = static_cast<uint8_t>(layer);
+    }
+    renderCollisionMatrix();
+    
     // Quick action buttons
     if (ImGui::Button("Reset to Default")) {
         resetCollisionToDefaults();
@@ -173,6 +180,47 @@ void CollisionEditorWindow::renderCollisionEditor() {
     renderSpriteWithCollision();
 }
 
+void CollisionEditorWindow::renderCollisionMatrix() {
+    if (!ImGui::CollapsingHeader("Collision Matrix")) return;
+    
+    CollisionMatrix* matrix = m_currentScene->tryGetResource<CollisionMatrix>();
+    if (!matrix) {
+        m_currentScene->setResource(CollisionMatrix());
+        matrix = &m_currentScene->getResource<CollisionMatrix>();
+    }
+    
+    ImGui::SliderInt("Layers Shown", &m_matrixLayers, 1, CollisionMatrix::LAYER_COUNT);
+    ImGui::TextDisabled("Ticked layers collide with each other");
+    
+    const int layers = m_matrixLayers;
+    if (ImGui::BeginTable("CollisionMatrix", layers + 1, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableNextRow(ImGuiTableRowFlags_Headers);
+        ImGui::TableNextColumn();
+        for (int column = 0; column < layers; ++column) {
+            ImGui::TableNextColumn();
+            ImGui::Text("%d", column);
+        }
+        
+        for (int row = 0; row < layers; ++row) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%d", row);
+            for (int column = 0; column < layers; ++column) {
+                ImGui::TableNextColumn();
+                if (column < row) continue; // Symmetric, so only the upper triangle is shown
+                
+                bool collides = matrix->collides(row, column);
+                ImGui::PushID(row * CollisionMatrix::LAYER_COUNT + column);
+                if (ImGui::Checkbox("##collides", &collides)) {
+                    matrix->setCollides(row, column, collides);
+                }
+                ImGui::PopID();
+            }
+        }
+        ImGui::EndTable();
+    }
+}
+
 void CollisionEditorWindow::renderSpriteWithCollision() {
     if (!m_currentScene->hasComponent<Collider>(m_selectedEntity)) return;
     
@@ -550,7 +598,8 @@ void CollisionEditorWindow::initializeCollisionMask() {
         
         for (int y = startY; y < endY; y++) {
             for (int x = startX; x < endX; x++) {
-                m_collisionMask[y][x] = true;
+                // A painted mask starts at the top-left corner of the box
+                m_collisionMask[y][x] = !collider.mask || collider.mask->get(x - startX, y - startY);
             }
         }
     }
@@ -586,6 +635,17 @@ void CollisionEditorWindow::updateCollisionFromMask() {
         float centerY = (minY + maxY) / 2.0f;
         collider.offset.x = centerX - m_maskWidth / 2.0f;
         collider.offset.y = centerY - m_maskHeight / 2.0f;
+        
+        // Keep the painted pixels inside the box as packed rows, unless the
+        // box is solid anyway
+        auto mask = std::make_shared<CollisionMask>(maxX - minX + 1, maxY - minY + 1);
+        for (int y = minY; y <= maxY; y++) {
+            for (int x = minX; x <= maxX; x++) {
+                mask->set(x - minX, y - minY, m_collisionMask[y][x]);
+            }
+        }
+        const size_t boxPixels = static_cast<size_t>(mask->getWidth()) * mask->getHeight();
+        collider.mask = mask->countSolid() == boxPixels ? nullptr : std::move(mask);
     }
 }
 
@@ -597,6 +657,7 @@ void CollisionEditorWindow::resetCollisionToDefaults() {
     collider.size = Vector2(32, 32);
     collider.isTrigger = false;
     collider.isStatic = false;
+    collider.mask = nullptr;
     
     initializeCollisionMask();
 }
@@ -611,6 +672,7 @@ void CollisionEditorWindow::fitCollisionToSprite() {
         if (sprite.texture) {
             collider.offset = Vector2(0, 0);
             collider.size = Vector2(sprite.texture->getWidth(), sprite.texture->getHeight());
+            collider.mask = nullptr;
             initializeCollisionMask();
         }
     }
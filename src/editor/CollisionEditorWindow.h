@@ -21,6 +21,7 @@ public:
 
 private:
     void renderCollisionEditor();
+    void renderCollisionMatrix();
     void renderCollisionVisualization();
     void renderSpriteWithCollision();
     void handleCollisionEditing();
@@ -63,6 +64,7 @@ private:
     float m_brushSize = 8.0f;
     bool m_isPainting = false;
     bool m_showGrid = true;
+    int m_matrixLayers = 8; // Layers shown in the collision matrix
     
     // Collision pixel mask for precise collision editing
     std::vector<std::vector<bool>> m_collisionMask;
@@ -1851,6 +1851,7 @@ void GameEditor::createNewScene() {
     auto renderSystem = m_currentScene->registerSystem<RenderSystem>();
     auto physicsSystem = m_currentScene->registerSystem<PhysicsSystem>();
     auto collisionSystem = m_currentScene->registerSystem<CollisionSystem>();
+    auto triggerSystem = m_currentScene->registerSystem<TriggerSystem>();
     auto particleSystem = m_currentScene->registerSystem<ParticleSystem>();
     auto lightSystem = m_currentScene->registerSystem<LightSystem>();
     auto audioSystem = m_currentScene->registerSystem<AudioSystem>();
@@ -1859,6 +1860,7 @@ void GameEditor::createNewScene() {
     renderSystem->setScene(m_currentScene.get());
     physicsSystem->setScene(m_currentScene.get());
     collisionSystem->setScene(m_currentScene.get());
+    triggerSystem->setScene(m_currentScene.get());
     particleSystem->setScene(m_currentScene.get());
     lightSystem->setScene(m_currentScene.get());
     audioSystem->setScene(m_currentScene.get());
@@ -1882,6 +1884,11 @@ void GameEditor::createNewScene() {
     collisionSignature.set(m_currentScene->getComponentType<Collider>());
     m_currentScene->setSystemSignature<CollisionSystem>(collisionSignature);
     
+    ComponentMask triggerSignature;
+    triggerSignature.set(m_currentScene->getComponentType<Transform>());
+    triggerSignature.set(m_currentScene->getComponentType<EnvironmentTrigger>());
+    m_currentScene->setSystemSignature<TriggerSystem>(triggerSignature);
+    
     ComponentMask particleSignature;
     particleSignature.set(m_currentScene->getComponentType<Transform>());
     particleSignature.set(m_currentScene->getComponentType<ParticleEffect>());
@@ -2739,6 +2746,7 @@ void GameEditor::openSceneInNewWindow() {
     auto renderSystem = scene->registerSystem<RenderSystem>();
     auto physicsSystem = scene->registerSystem<PhysicsSystem>();
     auto collisionSystem = scene->registerSystem<CollisionSystem>();
+    auto triggerSystem = scene->registerSystem<TriggerSystem>();
     auto particleSystem = scene->registerSystem<ParticleSystem>();
     auto lightSystem = scene->registerSystem<LightSystem>();
     auto audioSystem = scene->registerSystem<AudioSystem>();
@@ -2747,6 +2755,7 @@ void GameEditor::openSceneInNewWindow() {
     renderSystem->setScene(scene.get());
     physicsSystem->setScene(scene.get());
     collisionSystem->setScene(scene.get());
+    triggerSystem->setScene(scene.get());
     particleSystem->setScene(scene.get());
     lightSystem->setScene(scene.get());
     audioSystem->setScene(scene.get());
@@ -2770,6 +2779,11 @@ void GameEditor::openSceneInNewWindow() {
     collisionSignature.set(scene->getComponentType<Collider>());
     scene->setSystemSignature<CollisionSystem>(collisionSignature);
     
+    ComponentMask triggerSignature;
+    triggerSignature.set(scene->getComponentType<Transform>());
+    triggerSignature.set(scene->getComponentType<EnvironmentTrigger>());
+    scene->setSystemSignature<TriggerSystem>(triggerSignature);
+    
     ComponentMask particleSignature;
     particleSignature.set(scene->getComponentType<Transform>());
     particleSignature.set(scene->getComponentType<ParticleEffect>());
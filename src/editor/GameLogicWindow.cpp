@@ -506,8 +506,40 @@ void GameLogicWindow::renderPerformanceStats() {
     fpsHistory.erase(fpsHistory.begin());
     fpsHistory.push_back(m_fps);
     
-    ImGui::PlotLines("FPS History", fpsHistory.data(), static_cast<int>(fpsHistory.size()), 
+    ImGui::PlotLines("FPS History", fpsHistory.data(), static_cast<int>(fpsHistory.size()),
                      0, nullptr, 0.0f, 120.0f, ImVec2(0, 50));
+
+    // Component pool memory report for the active scene
+    if (m_activeScene && m_activeScene->getScene() && ImGui::CollapsingHeader("Component Memory")) {
+        auto scene = m_activeScene->getScene();
+        auto report = scene->getComponentMemoryReport();
+
+        size_t totalBytes = scene->getEntityMemoryUsage();
+        for (const auto& pool : report) {
+            totalBytes += pool.bytesAllocated;
+        }
+        ImGui::Text("Total: %.1f KB (entities: %.1f KB)", totalBytes / 1024.0f,
+                    scene->getEntityMemoryUsage() / 1024.0f);
+
+        if (ImGui::BeginTable("ComponentPools", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Component");
+            ImGui::TableSetupColumn("Size");
+            ImGui::TableSetupColumn("Live");
+            ImGui::TableSetupColumn("Capacity");
+            ImGui::TableSetupColumn("KB");
+            ImGui::TableHeadersRow();
+
+            for (const auto& pool : report) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(pool.typeName.c_str());
+                ImGui::TableNextColumn(); ImGui::Text("%zu", pool.componentSize);
+                ImGui::TableNextColumn(); ImGui::Text("%zu", pool.count);
+                ImGui::TableNextColumn(); ImGui::Text("%zu", pool.capacity);
+                ImGui::TableNextColumn(); ImGui::Text("%.1f", pool.bytesAllocated / 1024.0f);
+            }
+            ImGui::EndTable();
+        }
+    }
 }
 
 void GameLogicWindow::renderSceneState() {
@@ -555,7 +587,7 @@ void GameLogicWindow::renderSceneState() {
     ImGui::Text("Scene Backup:");
     if (hasSceneBackup()) {
         ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "  ✓ Backup available");
-        ImGui::Text("  Entities: %zu", m_sceneBackup->getAllLivingEntities().size());
+        ImGui::Text("  Entities: %u", m_sceneBackup->getEntityCount());
         if (ImGui::Button("Restore from Backup")) {
             restoreSceneFromBackup();
         }
@@ -1200,71 +1232,16 @@ void GameLogicWindow::createRuntimeSceneCopy() {
     try {
         log("Creating runtime scene copy...", LogEntry::DEBUG);
         
-        // Create a new scene for runtime use
+        // Create a new scene for runtime use and copy the active scene's
+        // entities, components and resources into it wholesale. Entity IDs are
+        // kept, so references between entities stay valid.
         m_runtimeScene = std::make_shared<Scene>();
         m_runtimeScene->initialize(); // IMPORTANT: Register all component types first!
         
-        // Copy all entities and components from the active scene
         auto sourceScene = m_activeScene->getScene();
-        auto entities = sourceScene->getAllLivingEntities();
+        m_runtimeScene->copyFrom(*sourceScene);
         
-        log("Found " + std::to_string(entities.size()) + " entities to copy", LogEntry::DEBUG);
-        
-        for (EntityID entity : entities) {
-            // Create corresponding entity in runtime scene
-            EntityID newEntity = m_runtimeScene->createEntity();
-            
-            // Copy entity name
-            std::string entityName = sourceScene->getEntityName(entity);
-            m_runtimeScene->setEntityName(newEntity, entityName);
-            
-            log("Copying entity " + std::to_string(entity) + " -> " + std::to_string(newEntity) + " (" + entityName + ")", LogEntry::DEBUG);
-            
-            // Copy all components
-            try {
-                if (sourceScene->hasComponent<Name>(entity)) {
-                    auto& name = sourceScene->getComponent<Name>(entity);
-                    m_runtimeScene->addComponent<Name>(newEntity, name);
-                }
-                
-                if (sourceScene->hasComponent<Transform>(entity)) {
-                    auto& transform = sourceScene->getComponent<Transform>(entity);
-                    m_runtimeScene->addComponent<Transform>(newEntity, transform);
-                }
-                
-                if (sourceScene->hasComponent<Sprite>(entity)) {
-                    auto& sprite = sourceScene->getComponent<Sprite>(entity);
-                    m_runtimeScene->addComponent<Sprite>(newEntity, sprite);
-                }
-                
-                if (sourceScene->hasComponent<PlayerController>(entity)) {
-                    auto& controller = sourceScene->getComponent<PlayerController>(entity);
-                    m_runtimeScene->addComponent<PlayerController>(newEntity, controller);
-                }
-                
-                if (sourceScene->hasComponent<PlayerStats>(entity)) {
-                    auto& stats = sourceScene->getComponent<PlayerStats>(entity);
-                    m_runtimeScene->addComponent<PlayerStats>(newEntity, stats);
-                }
-                
-                if (sourceScene->hasComponent<PlayerPhysics>(entity)) {
-                    auto& physics = sourceScene->getComponent<PlayerPhysics>(entity);
-                    m_runtimeScene->addComponent<PlayerPhysics>(newEntity, physics);
-                }
-                
-                if (sourceScene->hasComponent<Collider>(entity)) {
-                    auto& collider = sourceScene->getComponent<Collider>(entity);
-                    m_runtimeScene->addComponent<Collider>(newEntity, collider);
-                }
-                
-                if (sourceScene->hasComponent<RigidBody>(entity)) {
-                    auto& rigidbody = sourceScene->getComponent<RigidBody>(entity);
-                    m_runtimeScene->addComponent<RigidBody>(newEntity, rigidbody);
-                }
-            } catch (const std::exception& e) {
-                log("Error copying components for entity " + std::to_string(entity) + ": " + e.what(), LogEntry::ERROR);
-            }
-        }
+        log("Copied " + std::to_string(m_runtimeScene->getAllLivingEntities().size()) + " entities", LogEntry::DEBUG);
         
         log("Runtime scene copy completed successfully", LogEntry::INFO);
         
@@ -1289,9 +1266,11 @@ void GameLogicWindow::createSceneBackup() {
     try {
         log("Creating scene backup...", LogEntry::DEBUG);
         
-        // For now, just create a placeholder backup
-        // Scene copying will be implemented once Scene.cpp is fixed
-        log("Scene backup functionality temporarily disabled", LogEntry::WARNING);
+        if (!m_sceneBackup) {
+            m_sceneBackup = std::make_unique<SceneSnapshot>();
+        }
+        m_activeScene->getScene()->snapshot(*m_sceneBackup);
+        log("Scene backup created (" + std::to_string(m_sceneBackup->getEntityCount()) + " entities)", LogEntry::INFO);
         
     } catch (const std::exception& e) {
         log("Error creating scene backup: " + std::string(e.what()), LogEntry::ERROR);
@@ -1299,7 +1278,21 @@ void GameLogicWindow::createSceneBackup() {
 }
 
 void GameLogicWindow::restoreSceneFromBackup() {
-    log("Scene restore functionality temporarily disabled", LogEntry::WARNING);
+    if (!m_sceneBackup) {
+        log("No scene backup to restore", LogEntry::WARNING);
+        return;
+    }
+    if (!m_activeScene || !m_activeScene->getScene()) {
+        log("No active scene available for restore", LogEntry::WARNING);
+        return;
+    }
+    
+    try {
+        m_activeScene->getScene()->restore(*m_sceneBackup);
+        log("Scene restored from backup (" + std::to_string(m_sceneBackup->getEntityCount()) + " entities)", LogEntry::INFO);
+    } catch (const std::exception& e) {
+        log("Error restoring scene backup: " + std::string(e.what()), LogEntry::ERROR);
+    }
 }
 
 void GameLogicWindow::renderRuntimeViewport() {
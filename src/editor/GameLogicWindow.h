@@ -99,7 +99,7 @@ private:    // Window state
     std::vector<std::string> m_availableScenes;
     
     // Scene backup for live playtesting
-    std::shared_ptr<Scene> m_sceneBackup = nullptr;
+    std::unique_ptr<SceneSnapshot> m_sceneBackup = nullptr;
     
     // Code editor
     std::string m_userCode;
@@ -3,6 +3,7 @@
 #include "../scene/Scene.h"
 #include "../components/Components.h"
 #include "../generation/ProceduralGeneration.h"
+#include "../physics/CollisionMask.h"
 #include "../core/Engine.h"
 #include "../utils/ResourceManager.h"
 #include <imgui.h>
@@ -783,6 +784,10 @@ bool SceneManager::loadSceneFromJson(std::shared_ptr<Scene> scene, const std::st
         int entitiesLoaded = 0;
         int componentsLoaded = 0;
         
+        // Tilemap colliders and their tile sizes, linked to the procedural
+        // map's collision cells once that is loaded
+        std::vector<std::pair<EntityID, int>> tilemapColliders;
+        
         // Load entities
         if (sceneJsonData.contains("entities")) {
             auto entities = sceneJsonData["entities"];
@@ -865,6 +870,20 @@ bool SceneManager::loadSceneFromJson(std::shared_ptr<Scene> scene, const std::st
                         if (colliderData.contains("sizeY")) collider.size.y = colliderData["sizeY"];
                         if (colliderData.contains("isTrigger")) collider.isTrigger = colliderData["isTrigger"];
                         if (colliderData.contains("isStatic")) collider.isStatic = colliderData["isStatic"];
+                        if (colliderData.contains("layer")) collider.layer = static_cast<uint8_t>(colliderData["layer"].get<unsigned int>() % CollisionMatrix::LAYER_COUNT);
+                        if (colliderData.contains("mask")) {
+                            // Row by row, getWordsPerRow() words each
+                            const auto& maskData = colliderData["mask"];
+                            auto mask = std::make_shared<CollisionMask>(maskData["width"].get<int>(), maskData["height"].get<int>());
+                            const auto& words = maskData["words"];
+                            size_t index = 0;
+                            for (int y = 0; y < mask->getHeight(); ++y) {
+                                for (int word = 0; word < mask->getWordsPerRow() && index < words.size(); ++word) {
+                                    mask->setWord(y, word, words[index++].get<uint64_t>());
+                                }
+                            }
+                            collider.mask = mask;
+                        }
                         scene->addComponent<Collider>(entityId, collider);
                         componentsLoaded++;
                     }
@@ -880,10 +899,41 @@ bool SceneManager::loadSceneFromJson(std::shared_ptr<Scene> scene, const std::st
                         if (rigidBodyData.contains("drag")) rigidBody.drag = rigidBodyData["drag"];
                         if (rigidBodyData.contains("mass")) rigidBody.mass = rigidBodyData["mass"];
                         if (rigidBodyData.contains("useGravity")) rigidBody.useGravity = rigidBodyData["useGravity"];
+                        if (rigidBodyData.contains("canSleep")) rigidBody.canSleep = rigidBodyData["canSleep"];
                         scene->addComponent<RigidBody>(entityId, rigidBody);
                         componentsLoaded++;
                     }
                     
+                    // Load Static tag
+                    if (components.contains("Static")) {
+                        scene->addComponent(entityId, Static());
+                        componentsLoaded++;
+                    }
+                    
+                    // Load EnvironmentCollider component
+                    if (components.contains("EnvironmentCollider")) {
+                        auto environmentData = components["EnvironmentCollider"];
+                        EnvironmentCollider environment;
+                        if (environmentData.contains("shape")) environment.shape = static_cast<EnvironmentCollider::ColliderShape>(environmentData["shape"].get<int>());
+                        if (environmentData.contains("sizeX")) environment.size.x = environmentData["sizeX"];
+                        if (environmentData.contains("sizeY")) environment.size.y = environmentData["sizeY"];
+                        if (environmentData.contains("radius")) environment.radius = environmentData["radius"];
+                        if (environmentData.contains("vertices")) {
+                            for (const auto& vertex : environmentData["vertices"]) {
+                                environment.vertices.emplace_back(vertex[0].get<float>(), vertex[1].get<float>());
+                            }
+                        }
+                        if (environmentData.contains("layer")) environment.layer = static_cast<uint8_t>(environmentData["layer"].get<unsigned int>() % CollisionMatrix::LAYER_COUNT);
+                        if (environmentData.contains("isOneWayPlatform")) environment.isOneWayPlatform = environmentData["isOneWayPlatform"];
+                        if (environmentData.contains("isSlope")) environment.isSlope = environmentData["isSlope"];
+                        if (environmentData.contains("slopeAngle")) environment.slopeAngle = environmentData["slopeAngle"];
+                        if (environment.shape == EnvironmentCollider::ColliderShape::Tilemap && environmentData.contains("tileSize")) {
+                            tilemapColliders.emplace_back(entityId, environmentData["tileSize"].get<int>());
+                        }
+                        scene->addComponent<EnvironmentCollider>(entityId, environment);
+                        componentsLoaded++;
+                    }
+                    
                     // Load PlayerController component
                     if (components.contains("PlayerController")) {
                         auto controllerData = components["PlayerController"];
@@ -1116,6 +1166,25 @@ bool SceneManager::loadSceneFromJson(std::shared_ptr<Scene> scene, const std::st
             }
         }
         
+        // Load collision matrix rows (bit b of row a: layers a and b collide).
+        // A hand-edited file may set a pair on one side only; it collides.
+        if (sceneJsonData.contains("collisionMatrix")) {
+            const auto& rows = sceneJsonData["collisionMatrix"];
+            CollisionMatrix saved;
+            for (size_t layer = 0; layer < rows.size() && layer < saved.rows.size(); ++layer) {
+                saved.rows[layer] = rows[layer].get<uint32_t>();
+            }
+            CollisionMatrix matrix;
+            for (int a = 0; a < CollisionMatrix::LAYER_COUNT; ++a) {
+                for (int b = a; b < CollisionMatrix::LAYER_COUNT; ++b) {
+                    const bool collide = saved.collides(static_cast<uint8_t>(a), static_cast<uint8_t>(b)) ||
+                                         saved.collides(static_cast<uint8_t>(b), static_cast<uint8_t>(a));
+                    matrix.setCollides(static_cast<uint8_t>(a), static_cast<uint8_t>(b), collide);
+                }
+            }
+            scene->setResource(matrix);
+        }
+        
         // Load procedural map data if present
         if (sceneJsonData.contains("proceduralMap")) {
             auto mapData = sceneJsonData["proceduralMap"];
@@ -1158,7 +1227,14 @@ bool SceneManager::loadSceneFromJson(std::shared_ptr<Scene> scene, const std::st
                     proceduralMap->setSpriteManager(spriteManager);
                 }
                 
-                // Set the procedural map on the scene                scene->setProceduralMap(proceduralMap);
+                // Set the procedural map on the scene
+                scene->setProceduralMap(proceduralMap);
+                
+                // The cells are rebuilt from the tiles rather than saved, so
+                // tilemap colliders get them back from the map
+                for (const auto& [colliderEntity, tileSize] : tilemapColliders) {
+                    scene->getComponent<EnvironmentCollider>(colliderEntity).tilemap = proceduralMap->getCollisionMap(tileSize);
+                }
                 
                 std::cout << "Loaded procedural map: " << width << "x" << height 
                          << " with " << mapData["tiles"].size() << " tiles" << std::endl;
@@ -1246,8 +1322,22 @@ bool SceneManager::saveSceneToJson(std::shared_ptr<Scene> scene, std::string& js
                     {"sizeX", collider.size.x},
                     {"sizeY", collider.size.y},
                     {"isTrigger", collider.isTrigger},
-                    {"isStatic", collider.isStatic}
+                    {"isStatic", collider.isStatic},
+                    {"layer", collider.layer}
                 };
+                if (collider.mask) {
+                    json words = json::array();
+                    for (int y = 0; y < collider.mask->getHeight(); ++y) {
+                        for (int word = 0; word < collider.mask->getWordsPerRow(); ++word) {
+                            words.push_back(collider.mask->getWord(y, word));
+                        }
+                    }
+                    componentsData["Collider"]["mask"] = {
+                        {"width", collider.mask->getWidth()},
+                        {"height", collider.mask->getHeight()},
+                        {"words", words}
+                    };
+                }
             }
             
             // Save RigidBody component
@@ -1260,8 +1350,38 @@ bool SceneManager::saveSceneToJson(std::shared_ptr<Scene> scene, std::string& js
                     {"accelerationY", rigidBody.acceleration.y},
                     {"drag", rigidBody.drag},
                     {"mass", rigidBody.mass},
-                    {"useGravity", rigidBody.useGravity}
+                    {"useGravity", rigidBody.useGravity},
+                    {"canSleep", rigidBody.canSleep}
+                };
+            }
+            
+            // Save Static tag
+            if (scene->hasComponent<Static>(entityId)) {
+                componentsData["Static"] = true;
+            }
+            
+            // Save EnvironmentCollider component; a tilemap's cells come
+            // from the procedural map, so only its tile size is kept
+            if (scene->hasComponent<EnvironmentCollider>(entityId)) {
+                const EnvironmentCollider& environment = scene->getComponent<EnvironmentCollider>(entityId);
+                json vertices = json::array();
+                for (const Vector2& vertex : environment.vertices) {
+                    vertices.push_back({vertex.x, vertex.y});
+                }
+                componentsData["EnvironmentCollider"] = {
+                    {"shape", static_cast<int>(environment.shape)},
+                    {"sizeX", environment.size.x},
+                    {"sizeY", environment.size.y},
+                    {"radius", environment.radius},
+                    {"vertices", vertices},
+                    {"layer", environment.layer},
+                    {"isOneWayPlatform", environment.isOneWayPlatform},
+                    {"isSlope", environment.isSlope},
+                    {"slopeAngle", environment.slopeAngle}
                 };
+                if (environment.tilemap) {
+                    componentsData["EnvironmentCollider"]["tileSize"] = static_cast<int>(environment.tilemap->getTileSize());
+                }
             }
             
             // Save PlayerController component
@@ -1485,6 +1605,11 @@ bool SceneManager::saveSceneToJson(std::shared_ptr<Scene> scene, std::string& js
         
         sceneJsonData["entities"] = entitiesArray;
         
+        // Save collision matrix
+        if (const CollisionMatrix* matrix = scene->tryGetResource<CollisionMatrix>()) {
+            sceneJsonData["collisionMatrix"] = matrix->rows;
+        }
+        
         // Save procedural map data if present
         if (scene->hasProceduralMap()) {
             auto proceduralMap = scene->getProceduralMap();
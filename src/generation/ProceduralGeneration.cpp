@@ -1,10 +1,13 @@
 #include "ProceduralGeneration.h"
 #include "../scene/Scene.h"
 #include "../core/Engine.h"
+#include "../core/JobSystem.h"
 #include "../utils/ResourceManager.h"
 #include "../utils/ConfigManager.h"
 #include <algorithm>
+#include <charconv>
 #include <cmath>
+#include <cstdio>
 #include <queue>
 #include <filesystem>
 #include <iostream>
@@ -419,6 +422,9 @@ void ProceduralMap::setTile(int x, int y, TileType type) {
         if (m_spriteManager) {
             m_tiles[y][x].updateProperties(*m_spriteManager);
         }
+        if (m_collisionMap) {
+            m_collisionMap->setSolid(x, y, !m_tiles[y][x].walkable);
+        }
     }
 }
 
@@ -442,6 +448,9 @@ void ProceduralMap::updateAllTileSprites() {
     for (int y = 0; y < m_height; ++y) {
         for (int x = 0; x < m_width; ++x) {
             m_tiles[y][x].updateProperties(*m_spriteManager);
+            if (m_collisionMap) {
+                m_collisionMap->setSolid(x, y, !m_tiles[y][x].walkable);
+            }
         }
     }
     
@@ -464,6 +473,18 @@ Vector2 ProceduralMap::getGridPosition(const Vector2& worldPos) const {
                    static_cast<int>((worldPos.y - 16.0f) / 32.0f + 0.5f));
 }
 
+std::shared_ptr<TileCollisionMap> ProceduralMap::getCollisionMap(int tileSize) {
+    if (!m_collisionMap || m_collisionMap->getTileSize() != static_cast<float>(tileSize)) {
+        m_collisionMap = std::make_shared<TileCollisionMap>(m_width, m_height, static_cast<float>(tileSize));
+    }
+    for (int y = 0; y < m_height; ++y) {
+        for (int x = 0; x < m_width; ++x) {
+            m_collisionMap->setSolid(x, y, !m_tiles[y][x].walkable);
+        }
+    }
+    return m_collisionMap;
+}
+
 void ProceduralMap::clear(TileType fillType) {
     for (int y = 0; y < m_height; ++y) {
         for (int x = 0; x < m_width; ++x) {
@@ -475,35 +496,61 @@ void ProceduralMap::clear(TileType fillType) {
 void ProceduralMap::generateToScene(Scene* scene, int tileSize) {
     if (!scene) return;
     
+    // Walls collide through a single tilemap collider; tile entities below
+    // are only for rendering. Tile (x, y) spans [x, x + 1) * tileSize, so
+    // the map's corner is the world origin.
+    EnvironmentCollider mapCollider;
+    mapCollider.shape = EnvironmentCollider::ColliderShape::Tilemap;
+    mapCollider.size = Vector2(static_cast<float>(m_width * tileSize), static_cast<float>(m_height * tileSize));
+    mapCollider.tilemap = getCollisionMap(tileSize);
+    const EntityID mapEntity = scene->createEntity();
+    scene->addComponent(mapEntity, Transform());
+    scene->addComponent(mapEntity, mapCollider);
+    scene->addComponent(mapEntity, Name("TilemapCollider"));
+    
     // Get resource manager to load textures
     auto& engine = Engine::getInstance();
     auto resourceManager = engine.getResourceManager();
     if (!resourceManager) return;
     
+    auto isVisible = [](const Tile& tile) {
+        return tile.type != TileType::Empty && !tile.spriteName.empty();
+    };
+    
+    size_t tileCount = 0;
+    for (int y = 0; y < m_height; ++y) {
+        for (int x = 0; x < m_width; ++x) {
+            if (isVisible(getTile(x, y))) ++tileCount;
+        }
+    }
+    
+    // Spawn every tile entity in one batch, then fill in the per-tile values
+    std::vector<EntityID> entities = scene->createEntities(tileCount, Transform(), Sprite(), Name());
+    
+    size_t next = 0;
+    char tileName[32] = "Tile_"; // Room for two 11-character ints
     for (int y = 0; y < m_height; ++y) {
         for (int x = 0; x < m_width; ++x) {
             const Tile& tile = getTile(x, y);
-            if (tile.type != TileType::Empty && !tile.spriteName.empty()) {
-                // Create entity for this tile
-                EntityID entity = scene->createEntity();
-                
-                // Add transform
-                Vector2 worldPos = getWorldPosition(x, y, tileSize);
-                scene->addComponent<Transform>(entity, Transform(worldPos));
-                
-                // Add sprite with loaded texture
-                Sprite sprite;
-                auto texture = resourceManager->loadTexture(tile.spriteName);
-                if (texture) {
-                    sprite.texture = texture;
-                    sprite.sourceRect = Rect(0, 0, texture->getWidth(), texture->getHeight());
-                }
-                scene->addComponent<Sprite>(entity, sprite);
-                
-                // Set entity name
-                std::string tileName = "Tile_" + std::to_string(x) + "_" + std::to_string(y);
-                scene->setEntityName(entity, tileName);
+            if (!isVisible(tile)) continue;
+            const EntityID entity = entities[next++];
+            
+            scene->getComponent<Transform>(entity).position = getWorldPosition(x, y, tileSize);
+            
+            // Sprite with loaded texture
+            auto texture = resourceManager->loadTexture(tile.spriteName);
+            if (texture) {
+                Sprite& sprite = scene->getComponent<Sprite>(entity);
+                sprite.texture = texture;
+                sprite.sourceRect = Rect(0, 0, texture->getWidth(), texture->getHeight());
             }
+            
+            // "Tile_x_y" via to_chars, a fraction of snprintf's cost; short
+            // enough for the small-string buffer, so naming does not allocate
+            char* end = std::to_chars(tileName + 5, tileName + 16, x).ptr;
+            *end++ = '_';
+            end = std::to_chars(end, end + 11, y).ptr;
+            scene->getComponent<Name>(entity).name.assign(tileName, end);
         }
     }
 }
@@ -608,28 +655,33 @@ void DungeonGenerator::generateCellularAutomata(ProceduralMap& map) {
 void DungeonGenerator::smoothMap(ProceduralMap& map) {
     std::vector<std::vector<TileType>> newTiles(map.getHeight(), std::vector<TileType>(map.getWidth()));
     
-    for (int y = 0; y < map.getHeight(); ++y) {
-        for (int x = 0; x < map.getWidth(); ++x) {
-            int wallCount = 0;
-            
-            // Count neighboring walls
-            for (int ny = y - 1; ny <= y + 1; ++ny) {
-                for (int nx = x - 1; nx <= x + 1; ++nx) {
-                    if (nx == x && ny == y) continue;
-                    if (!map.isValidPosition(nx, ny) || map.getTile(nx, ny).type == TileType::Wall) {
-                        wallCount++;
+    // Rows only read the old map and write their own row, so they smooth in parallel
+    const ProceduralMap& source = map;
+    Engine::getInstance().getJobSystem().parallel_for(0, static_cast<size_t>(map.getHeight()), SMOOTH_ROWS_PER_JOB,
+        [&source, &newTiles](size_t firstRow, size_t lastRow) {
+            for (int y = static_cast<int>(firstRow); y < static_cast<int>(lastRow); ++y) {
+                for (int x = 0; x < source.getWidth(); ++x) {
+                    int wallCount = 0;
+                    
+                    // Count neighboring walls
+                    for (int ny = y - 1; ny <= y + 1; ++ny) {
+                        for (int nx = x - 1; nx <= x + 1; ++nx) {
+                            if (nx == x && ny == y) continue;
+                            if (!source.isValidPosition(nx, ny) || source.getTile(nx, ny).type == TileType::Wall) {
+                                wallCount++;
+                            }
+                        }
+                    }
+                    
+                    // Apply smoothing rule
+                    if (wallCount > 4) {
+                        newTiles[y][x] = TileType::Wall;
+                    } else {
+                        newTiles[y][x] = TileType::Floor;
                     }
                 }
             }
-            
-            // Apply smoothing rule
-            if (wallCount > 4) {
-                newTiles[y][x] = TileType::Wall;
-            } else {
-                newTiles[y][x] = TileType::Floor;
-            }
-        }
-    }
+        });
     
     // Apply changes
     for (int y = 0; y < map.getHeight(); ++y) {
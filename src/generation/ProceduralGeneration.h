@@ -7,6 +7,7 @@
 #include <string>
 #include "../graphics/Renderer.h"
 #include "../components/Components.h"
+#include "../physics/TileCollisionMap.h"
 
 // Forward declarations
 class Scene;
@@ -132,14 +133,23 @@ public:
     std::shared_ptr<TileSpriteManager> getSpriteManager() const { return m_spriteManager; }
     void updateAllTileSprites();
     
+    // Collision: tiles that are not walkable are solid. Each call refreshes
+    // every cell from the tiles; afterwards setTile() and
+    // updateAllTileSprites() keep the map in sync. A different tileSize
+    // replaces the map rather than changing the one already handed out.
+    std::shared_ptr<TileCollisionMap> getCollisionMap(int tileSize = 32);
+    
     // Generation
     void clear(TileType fillType = TileType::Empty);
+    // Adds sprite entities for the visible tiles and one Tilemap
+    // EnvironmentCollider entity for the whole map
     void generateToScene(Scene* scene, int tileSize = 32);
     
 private:
     int m_width, m_height;
     std::vector<std::vector<Tile>> m_tiles;
     std::shared_ptr<TileSpriteManager> m_spriteManager;
+    std::shared_ptr<TileCollisionMap> m_collisionMap;
 };
 
 // Base class for procedural generators
@@ -199,6 +209,8 @@ private:
     void createCorridor(ProceduralMap& map, Vector2 start, Vector2 end);
     void addDetails(ProceduralMap& map);
     bool isRoomValid(const Room& room, const std::vector<Room>& existingRooms, int mapWidth, int mapHeight);
+    
+    static constexpr size_t SMOOTH_ROWS_PER_JOB = 16;
 };
 
 // City generator with roads, buildings, and districts
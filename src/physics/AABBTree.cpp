@@ -0,0 +1,246 @@
+#include "AABBTree.h"
+#include <algorithm>
+#include <stdexcept>
+
+AABBTree::AABBTree(float margin) : m_margin(margin) {
+    if (!(margin >= 0.0f)) {
+        throw std::runtime_error("AABB tree margin must not be negative");
+    }
+}
+
+int32_t AABBTree::createProxy(const Rect& bounds, uint32_t id) {
+    const int32_t proxy = allocateNode();
+    Node& node = m_nodes[proxy];
+    const Box box = toBox(bounds);
+    node.box = {box.minX - m_margin, box.minY - m_margin, box.maxX + m_margin, box.maxY + m_margin};
+    node.id = id;
+    node.height = 0;
+    insertLeaf(proxy);
+    ++m_proxyCount;
+    return proxy;
+}
+
+void AABBTree::destroyProxy(int32_t proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --m_proxyCount;
+}
+
+bool AABBTree::moveProxy(int32_t proxy, const Rect& bounds, const Vector2& displacement) {
+    const Box box = toBox(bounds);
+    if (m_nodes[proxy].box.contains(box)) {
+        return false;
+    }
+
+    Box fat = {box.minX - m_margin, box.minY - m_margin, box.maxX + m_margin, box.maxY + m_margin};
+    const float dx = displacement.x * DISPLACEMENT_MULTIPLIER;
+    const float dy = displacement.y * DISPLACEMENT_MULTIPLIER;
+    (dx < 0.0f ? fat.minX : fat.maxX) += dx;
+    (dy < 0.0f ? fat.minY : fat.maxY) += dy;
+
+    removeLeaf(proxy);
+    m_nodes[proxy].box = fat;
+    insertLeaf(proxy);
+    return true;
+}
+
+Rect AABBTree::getFatBounds(int32_t proxy) const {
+    const Box& box = m_nodes[proxy].box;
+    return Rect(box.minX, box.minY, box.maxX - box.minX, box.maxY - box.minY);
+}
+
+void AABBTree::clear() {
+    m_nodes.clear();
+    m_root = NULL_NODE;
+    m_freeList = NULL_NODE;
+    m_proxyCount = 0;
+}
+
+AABBTree::Box AABBTree::merge(const Box& a, const Box& b) {
+    return {std::min(a.minX, b.minX), std::min(a.minY, b.minY), std::max(a.maxX, b.maxX), std::max(a.maxY, b.maxY)};
+}
+
+bool AABBTree::rayHitsBox(const Vector2& origin, const Vector2& direction, float maxDistance, const Box& box) {
+    // Slab test, one axis at a time
+    float enter = 0.0f;
+    float exit = maxDistance;
+    const float origins[2] = {origin.x, origin.y};
+    const float directions[2] = {direction.x, direction.y};
+    const float mins[2] = {box.minX, box.minY};
+    const float maxs[2] = {box.maxX, box.maxY};
+    for (int axis = 0; axis < 2; ++axis) {
+        if (directions[axis] == 0.0f) {
+            if (origins[axis] < mins[axis] || origins[axis] > maxs[axis]) return false;
+            continue;
+        }
+        const float inverse = 1.0f / directions[axis];
+        float near = (mins[axis] - origins[axis]) * inverse;
+        float far = (maxs[axis] - origins[axis]) * inverse;
+        if (near > far) std::swap(near, far);
+        enter = std::max(enter, near);
+        exit = std::min(exit, far);
+        if (enter > exit) return false;
+    }
+    return true;
+}
+
+int32_t AABBTree::allocateNode() {
+    if (m_freeList == NULL_NODE) {
+        m_nodes.emplace_back();
+        return static_cast<int32_t>(m_nodes.size() - 1);
+    }
+
+    const int32_t index = m_freeList;
+    m_freeList = m_nodes[index].parent;
+    m_nodes[index] = Node();
+    return index;
+}
+
+void AABBTree::freeNode(int32_t index) {
+    m_nodes[index].parent = m_freeList;
+    m_nodes[index].height = -1;
+    m_freeList = index;
+}
+
+void AABBTree::insertLeaf(int32_t leaf) {
+    if (m_root == NULL_NODE) {
+        m_root = leaf;
+        m_nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    const int32_t sibling = findBestSibling(m_nodes[leaf].box);
+    const int32_t newParent = allocateNode(); // May grow m_nodes; no references held
+    const int32_t oldParent = m_nodes[sibling].parent;
+
+    Node& parent = m_nodes[newParent];
+    parent.parent = oldParent;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    parent.box = merge(m_nodes[sibling].box, m_nodes[leaf].box);
+    parent.height = m_nodes[sibling].height + 1;
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        m_root = newParent;
+    } else if (m_nodes[oldParent].child1 == sibling) {
+        m_nodes[oldParent].child1 = newParent;
+    } else {
+        m_nodes[oldParent].child2 = newParent;
+    }
+
+    refitAncestors(newParent);
+}
+
+void AABBTree::removeLeaf(int32_t leaf) {
+    if (leaf == m_root) {
+        m_root = NULL_NODE;
+        return;
+    }
+
+    const int32_t parent = m_nodes[leaf].parent;
+    const int32_t grandParent = m_nodes[parent].parent;
+    const int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+    freeNode(parent);
+
+    m_nodes[sibling].parent = grandParent;
+    if (grandParent == NULL_NODE) {
+        m_root = sibling;
+        return;
+    }
+    if (m_nodes[grandParent].child1 == parent) {
+        m_nodes[grandParent].child1 = sibling;
+    } else {
+        m_nodes[grandParent].child2 = sibling;
+    }
+    refitAncestors(grandParent);
+}
+
+int32_t AABBTree::findBestSibling(const Box& box) const {
+    // Greedy descent: stop where pairing with the current node is cheaper
+    // than the lowest possible cost of going further down either child
+    int32_t index = m_root;
+    while (!m_nodes[index].isLeaf()) {
+        const Node& node = m_nodes[index];
+        const float combined = merge(node.box, box).perimeter();
+        const float cost = 2.0f * combined;
+        const float inheritance = 2.0f * (combined - node.box.perimeter()); // Every ancestor grows too
+
+        auto descendCost = [&](int32_t child) {
+            const Node& childNode = m_nodes[child];
+            const float merged = merge(childNode.box, box).perimeter();
+            return childNode.isLeaf() ? merged + inheritance
+                                      : merged - childNode.box.perimeter() + inheritance;
+        };
+        const float cost1 = descendCost(node.child1);
+        const float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+    return index;
+}
+
+void AABBTree::refitAncestors(int32_t index) {
+    while (index != NULL_NODE) {
+        Node& node = m_nodes[index];
+        node.box = merge(m_nodes[node.child1].box, m_nodes[node.child2].box);
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+        rotate(index);
+        index = m_nodes[index].parent;
+    }
+}
+
+void AABBTree::rotate(int32_t index) {
+    // Tries swapping one child of the node with a grandchild under the other
+    // child. The node's own box is unchanged by any swap; only the box of the
+    // child that receives the swapped node changes, so the swap that shrinks
+    // that box's perimeter the most (if any) is applied.
+    Node& node = m_nodes[index];
+    if (node.height < 2) return;
+
+    int32_t bestMoved = NULL_NODE;  // Child of the node moving down
+    int32_t bestParent = NULL_NODE; // Other child, receiving it
+    int32_t bestNephew = NULL_NODE; // Grandchild moving up
+    float bestDelta = 0.0f;
+
+    const int32_t children[2] = {node.child1, node.child2};
+    for (int i = 0; i < 2; ++i) {
+        const int32_t moved = children[i];
+        const int32_t parent = children[1 - i];
+        const Node& parentNode = m_nodes[parent];
+        if (parentNode.isLeaf()) continue;
+
+        const int32_t nephews[2] = {parentNode.child1, parentNode.child2};
+        for (int j = 0; j < 2; ++j) {
+            const int32_t kept = nephews[1 - j];
+            const float delta = merge(m_nodes[moved].box, m_nodes[kept].box).perimeter() - parentNode.box.perimeter();
+            if (delta < bestDelta) {
+                bestDelta = delta;
+                bestMoved = moved;
+                bestParent = parent;
+                bestNephew = nephews[j];
+            }
+        }
+    }
+    if (bestMoved == NULL_NODE) return;
+
+    Node& parentNode = m_nodes[bestParent];
+    if (node.child1 == bestMoved) {
+        node.child1 = bestNephew;
+    } else {
+        node.child2 = bestNephew;
+    }
+    if (parentNode.child1 == bestNephew) {
+        parentNode.child1 = bestMoved;
+    } else {
+        parentNode.child2 = bestMoved;
+    }
+    m_nodes[bestMoved].parent = bestParent;
+    m_nodes[bestNephew].parent = index;
+
+    parentNode.box = merge(m_nodes[parentNode.child1].box, m_nodes[parentNode.child2].box);
+    parentNode.height = 1 + std::max(m_nodes[parentNode.child1].height, m_nodes[parentNode.child2].height);
+    node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "graphics/Renderer.h" // Rect, Vector2
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Dynamic bounding volume tree over axis-aligned boxes.
+//
+// Each proxy is a leaf holding a "fat" box: its real bounds grown by a margin,
+// so small movements stay inside it and moveProxy() leaves the tree alone.
+// Leaves are inserted next to the sibling that grows the tree's total
+// perimeter the least (the 2D form of the surface area heuristic), and nodes
+// on the path back to the root are rotated whenever that lowers the perimeter
+// further, so the tree stays balanced as proxies come and go.
+//
+// Unlike SpatialHash it makes no assumption about box sizes, so it suits
+// levels that mix tiny and very large colliders, and it answers box, point
+// and ray queries. Proxies carry a caller-chosen id, returned by queries.
+class AABBTree {
+public:
+    static constexpr int32_t NULL_NODE = -1;
+
+    explicit AABBTree(float margin = 4.0f);
+
+    // Returns the proxy handle, valid until destroyProxy()
+    int32_t createProxy(const Rect& bounds, uint32_t id);
+    void destroyProxy(int32_t proxy);
+
+    // Returns true if the proxy left its fat box and was reinserted. The new
+    // fat box is stretched along displacement (the movement since the last
+    // call, if known) so fast movers are not reinserted every frame.
+    bool moveProxy(int32_t proxy, const Rect& bounds, const Vector2& displacement = Vector2());
+
+    void setId(int32_t proxy, uint32_t id) { m_nodes[proxy].id = id; }
+    uint32_t getId(int32_t proxy) const { return m_nodes[proxy].id; }
+    Rect getFatBounds(int32_t proxy) const;
+
+    void clear();
+
+    float getMargin() const { return m_margin; }
+    size_t getProxyCount() const { return m_proxyCount; }
+    int getHeight() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+
+    // Calls callback(id) for every proxy whose fat box overlaps bounds; the
+    // callback returns false to stop the query
+    template<typename Callback>
+    void query(const Rect& bounds, Callback&& callback) const {
+        const Box box = toBox(bounds);
+        TraversalStack stack;
+        stack.push(m_root);
+        while (!stack.empty()) {
+            const int32_t index = stack.pop();
+            if (index == NULL_NODE) continue;
+            const Node& node = m_nodes[index];
+            if (!node.box.overlaps(box)) continue;
+            if (node.isLeaf()) {
+                if (!callback(node.id)) return;
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+    // Calls callback(id) for every proxy whose fat box contains point
+    template<typename Callback>
+    void queryPoint(const Vector2& point, Callback&& callback) const {
+        query(Rect(point.x, point.y, 0.0f, 0.0f), std::forward<Callback>(callback));
+    }
+
+    // Calls callback(id) for every proxy whose fat box the ray from origin
+    // along direction crosses within maxDistance, in no particular order.
+    // Distances are in multiples of direction's length. The callback returns
+    // the distance to clip the ray to: maxDistance to carry on, its own exact
+    // hit distance to skip everything further away, or 0 to stop.
+    template<typename Callback>
+    void raycast(const Vector2& origin, const Vector2& direction, float maxDistance, Callback&& callback) const {
+        TraversalStack stack;
+        stack.push(m_root);
+        while (!stack.empty() && maxDistance > 0.0f) {
+            const int32_t index = stack.pop();
+            if (index == NULL_NODE) continue;
+            const Node& node = m_nodes[index];
+            if (!rayHitsBox(origin, direction, maxDistance, node.box)) continue;
+            if (node.isLeaf()) {
+                const float clip = callback(node.id);
+                if (clip < maxDistance) maxDistance = clip;
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+    // Calls callback(id) for every proxy whose fat box lies within
+    // sqrt(maxDistanceSquared) of point, descending into the nearer child
+    // first. The callback returns the squared distance to prune beyond:
+    // maxDistanceSquared to carry on, or e.g. the k-th best distance found so
+    // far once it has k, which skips every subtree farther away than that.
+    template<typename Callback>
+    void queryNearest(const Vector2& point, float maxDistanceSquared, Callback&& callback) const {
+        TraversalStack stack;
+        stack.push(m_root);
+        while (!stack.empty()) {
+            const int32_t index = stack.pop();
+            if (index == NULL_NODE) continue;
+            const Node& node = m_nodes[index];
+            if (distanceSquared(point, node.box) > maxDistanceSquared) continue;
+            if (node.isLeaf()) {
+                const float bound = callback(node.id);
+                if (bound < maxDistanceSquared) maxDistanceSquared = bound;
+            } else if (distanceSquared(point, m_nodes[node.child1].box) <= distanceSquared(point, m_nodes[node.child2].box)) {
+                stack.push(node.child2);
+                stack.push(node.child1); // Popped first
+            } else {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+private:
+    struct Box {
+        float minX, minY, maxX, maxY;
+
+        bool overlaps(const Box& other) const {
+            return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+        }
+        bool contains(const Box& other) const {
+            return minX <= other.minX && minY <= other.minY && other.maxX <= maxX && other.maxY <= maxY;
+        }
+        float perimeter() const { return 2.0f * ((maxX - minX) + (maxY - minY)); }
+    };
+
+    struct Node {
+        Box box;
+        int32_t parent = NULL_NODE; // Next free node while on the free list
+        int32_t child1 = NULL_NODE;
+        int32_t child2 = NULL_NODE;
+        int32_t height = 0;         // Leaves are 0, free nodes -1
+        uint32_t id = 0;
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    // Depth-first stack that only allocates for unusually deep trees
+    class TraversalStack {
+    public:
+        void push(int32_t index) {
+            if (m_size < INLINE_CAPACITY) {
+                m_inline[m_size++] = index;
+            } else {
+                m_overflow.push_back(index);
+            }
+        }
+        int32_t pop() {
+            if (!m_overflow.empty()) {
+                const int32_t index = m_overflow.back();
+                m_overflow.pop_back();
+                return index;
+            }
+            return m_inline[--m_size];
+        }
+        bool empty() const { return m_size == 0 && m_overflow.empty(); }
+
+    private:
+        static constexpr int INLINE_CAPACITY = 128;
+        int32_t m_inline[INLINE_CAPACITY];
+        int m_size = 0;
+        std::vector<int32_t> m_overflow;
+    };
+
+    static Box toBox(const Rect& bounds) {
+        return {bounds.x, bounds.y, bounds.x + bounds.width, bounds.y + bounds.height};
+    }
+    static float distanceSquared(const Vector2& point, const Box& box) {
+        const float dx = std::max(std::max(box.minX - point.x, point.x - box.maxX), 0.0f);
+        const float dy = std::max(std::max(box.minY - point.y, point.y - box.maxY), 0.0f);
+        return dx * dx + dy * dy;
+    }
+    static constexpr float DISPLACEMENT_MULTIPLIER = 4.0f; // Frames of movement a fat box covers
+
+    static Box merge(const Box& a, const Box& b);
+    static bool rayHitsBox(const Vector2& origin, const Vector2& direction, float maxDistance, const Box& box);
+
+    int32_t allocateNode();
+    void freeNode(int32_t index);
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    int32_t findBestSibling(const Box& box) const;
+    void refitAncestors(int32_t index);
+    void rotate(int32_t index);
+
+    float m_margin;
+    std::vector<Node> m_nodes;
+    int32_t m_root = NULL_NODE;
+    int32_t m_freeList = NULL_NODE;
+    size_t m_proxyCount = 0;
+};
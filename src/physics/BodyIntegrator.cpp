@@ -0,0 +1,143 @@
+#include "BodyIntegrator.h"
+#include <stdexcept>
+#include <string>
+
+#ifdef PHYSICS_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Reference step for [first, count); the vector kernels finish their
+    // tails with it
+    void integrateScalar(const BodyIntegrator::Streams& s, size_t first, float deltaTime, float gravityStep) {
+        for (size_t i = first; i < s.count; ++i) {
+            float accelerationY = s.accelerationY[i];
+            if (s.gravityMask[i]) {
+                accelerationY = accelerationY + gravityStep;
+            }
+            const float velocityX = (s.velocityX[i] + s.accelerationX[i] * deltaTime) * s.drag[i];
+            const float velocityY = (s.velocityY[i] + accelerationY * deltaTime) * s.drag[i];
+            s.velocityX[i] = velocityX;
+            s.velocityY[i] = velocityY;
+            s.positionX[i] = s.positionX[i] + velocityX * deltaTime;
+            s.positionY[i] = s.positionY[i] + velocityY * deltaTime;
+            s.accelerationX[i] = 0.0f;
+            s.accelerationY[i] = 0.0f;
+        }
+    }
+
+#ifdef PHYSICS_SIMD_SSE2
+    size_t integrateSSE2(const BodyIntegrator::Streams& s, float deltaTime, float gravityStep) {
+        const __m128 dt = _mm_set1_ps(deltaTime);
+        const __m128 gravity = _mm_set1_ps(gravityStep);
+        const __m128 zero = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 4 <= s.count; i += 4) {
+            // Select rather than add a masked zero, which would turn -0 into +0
+            const __m128 mask = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s.gravityMask + i)));
+            __m128 accelerationY = _mm_loadu_ps(s.accelerationY + i);
+            accelerationY = _mm_or_ps(_mm_and_ps(mask, _mm_add_ps(accelerationY, gravity)),
+                                      _mm_andnot_ps(mask, accelerationY));
+
+            const __m128 drag = _mm_loadu_ps(s.drag + i);
+            const __m128 velocityX = _mm_mul_ps(
+                _mm_add_ps(_mm_loadu_ps(s.velocityX + i), _mm_mul_ps(_mm_loadu_ps(s.accelerationX + i), dt)), drag);
+            const __m128 velocityY = _mm_mul_ps(
+                _mm_add_ps(_mm_loadu_ps(s.velocityY + i), _mm_mul_ps(accelerationY, dt)), drag);
+            _mm_storeu_ps(s.velocityX + i, velocityX);
+            _mm_storeu_ps(s.velocityY + i, velocityY);
+            _mm_storeu_ps(s.positionX + i, _mm_add_ps(_mm_loadu_ps(s.positionX + i), _mm_mul_ps(velocityX, dt)));
+            _mm_storeu_ps(s.positionY + i, _mm_add_ps(_mm_loadu_ps(s.positionY + i), _mm_mul_ps(velocityY, dt)));
+            _mm_storeu_ps(s.accelerationX + i, zero);
+            _mm_storeu_ps(s.accelerationY + i, zero);
+        }
+        return i;
+    }
+#endif
+
+#ifdef PHYSICS_SIMD_AVX2
+    PHYSICS_TARGET_AVX2
+    size_t integrateAVX2(const BodyIntegrator::Streams& s, float deltaTime, float gravityStep) {
+        const __m256 dt = _mm256_set1_ps(deltaTime);
+        const __m256 gravity = _mm256_set1_ps(gravityStep);
+        const __m256 zero = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= s.count; i += 8) {
+            const __m256 mask = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.gravityMask + i)));
+            __m256 accelerationY = _mm256_loadu_ps(s.accelerationY + i);
+            accelerationY = _mm256_blendv_ps(accelerationY, _mm256_add_ps(accelerationY, gravity), mask);
+
+            const __m256 drag = _mm256_loadu_ps(s.drag + i);
+            const __m256 velocityX = _mm256_mul_ps(
+                _mm256_add_ps(_mm256_loadu_ps(s.velocityX + i), _mm256_mul_ps(_mm256_loadu_ps(s.accelerationX + i), dt)), drag);
+            const __m256 velocityY = _mm256_mul_ps(
+                _mm256_add_ps(_mm256_loadu_ps(s.velocityY + i), _mm256_mul_ps(accelerationY, dt)), drag);
+            _mm256_storeu_ps(s.velocityX + i, velocityX);
+            _mm256_storeu_ps(s.velocityY + i, velocityY);
+            _mm256_storeu_ps(s.positionX + i, _mm256_add_ps(_mm256_loadu_ps(s.positionX + i), _mm256_mul_ps(velocityX, dt)));
+            _mm256_storeu_ps(s.positionY + i, _mm256_add_ps(_mm256_loadu_ps(s.positionY + i), _mm256_mul_ps(velocityY, dt)));
+            _mm256_storeu_ps(s.accelerationX + i, zero);
+            _mm256_storeu_ps(s.accelerationY + i, zero);
+        }
+        return i;
+    }
+
+    PHYSICS_TARGET_AVX2_FMA
+    size_t integrateAVX2Fused(const BodyIntegrator::Streams& s, float deltaTime, float gravityStep) {
+        const __m256 dt = _mm256_set1_ps(deltaTime);
+        const __m256 gravity = _mm256_set1_ps(gravityStep);
+        const __m256 zero = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= s.count; i += 8) {
+            const __m256 mask = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s.gravityMask + i)));
+            __m256 accelerationY = _mm256_loadu_ps(s.accelerationY + i);
+            accelerationY = _mm256_blendv_ps(accelerationY, _mm256_add_ps(accelerationY, gravity), mask);
+
+            const __m256 drag = _mm256_loadu_ps(s.drag + i);
+            const __m256 velocityX = _mm256_mul_ps(
+                _mm256_fmadd_ps(_mm256_loadu_ps(s.accelerationX + i), dt, _mm256_loadu_ps(s.velocityX + i)), drag);
+            const __m256 velocityY = _mm256_mul_ps(
+                _mm256_fmadd_ps(accelerationY, dt, _mm256_loadu_ps(s.velocityY + i)), drag);
+            _mm256_storeu_ps(s.velocityX + i, velocityX);
+            _mm256_storeu_ps(s.velocityY + i, velocityY);
+            _mm256_storeu_ps(s.positionX + i, _mm256_fmadd_ps(velocityX, dt, _mm256_loadu_ps(s.positionX + i)));
+            _mm256_storeu_ps(s.positionY + i, _mm256_fmadd_ps(velocityY, dt, _mm256_loadu_ps(s.positionY + i)));
+            _mm256_storeu_ps(s.accelerationX + i, zero);
+            _mm256_storeu_ps(s.accelerationY + i, zero);
+        }
+        return i;
+    }
+#endif
+}
+
+BodyIntegrator::BodyIntegrator(bool deterministic)
+    : m_instructionSet(Simd::bestSupported()), m_deterministic(deterministic) {
+}
+
+void BodyIntegrator::setInstructionSet(InstructionSet instructionSet) {
+    if (!Simd::isSupported(instructionSet)) {
+        throw std::runtime_error(std::string("Body integrator: ") + Simd::getName(instructionSet) + " is not supported");
+    }
+    m_instructionSet = instructionSet;
+}
+
+void BodyIntegrator::integrate(const Streams& streams, float deltaTime, float gravity) const {
+    const float gravityStep = gravity * deltaTime;
+    size_t done = 0;
+    switch (m_instructionSet) {
+        case InstructionSet::Scalar:
+            break;
+        case InstructionSet::SSE2:
+#ifdef PHYSICS_SIMD_SSE2
+            done = integrateSSE2(streams, deltaTime, gravityStep);
+#endif
+            break;
+        case InstructionSet::AVX2:
+#ifdef PHYSICS_SIMD_AVX2
+            done = !m_deterministic && Simd::hasFma() ? integrateAVX2Fused(streams, deltaTime, gravityStep)
+                                                         : integrateAVX2(streams, deltaTime, gravityStep);
+#endif
+            break;
+    }
+    integrateScalar(streams, done, deltaTime, gravityStep);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "InstructionSet.h"
+#include <cstddef>
+#include <cstdint>
+
+// Semi-implicit Euler step over bodies stored as structure-of-arrays streams,
+// vectorised with AVX2 or SSE2 when the CPU has them and scalar otherwise
+// (see InstructionSet).
+//
+// Per body, in this order:
+//   acceleration.y += gravity * deltaTime   (bodies with a gravity mask only)
+//   velocity = (velocity + acceleration * deltaTime) * drag
+//   position += velocity * deltaTime
+//   acceleration = 0
+//
+// In deterministic mode (the default) every instruction set performs exactly
+// these roundings, separately multiplied and added, so all of them produce
+// results bit-for-bit identical to each other and to the scalar code, however
+// the bodies are split into batches. Turning it off lets the AVX2 kernel fuse
+// the multiply-adds where the CPU has FMA, which rounds once instead of twice.
+class BodyIntegrator {
+public:
+    // Caller-owned streams of count elements each. gravityMask holds ~0u for
+    // bodies gravity applies to and 0 for the rest.
+    struct Streams {
+        float* positionX = nullptr;
+        float* positionY = nullptr;
+        float* velocityX = nullptr;
+        float* velocityY = nullptr;
+        float* accelerationX = nullptr;
+        float* accelerationY = nullptr;
+        const float* drag = nullptr;
+        const uint32_t* gravityMask = nullptr;
+        size_t count = 0;
+    };
+
+    // Starts on the widest instruction set the CPU supports
+    explicit BodyIntegrator(bool deterministic = true);
+
+    // Throws if the CPU or the build does not support instructionSet
+    void setInstructionSet(InstructionSet instructionSet);
+    InstructionSet getInstructionSet() const { return m_instructionSet; }
+
+    void setDeterministic(bool deterministic) { m_deterministic = deterministic; }
+    bool isDeterministic() const { return m_deterministic; }
+
+    void integrate(const Streams& streams, float deltaTime, float gravity) const;
+
+private:
+    InstructionSet m_instructionSet;
+    bool m_deterministic;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "graphics/Renderer.h" // Rect, Vector2
+#include "InstructionSet.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A collider's solid pixels as 64-bit row bitsets. Pixel (x, y) covers
+// [x, x + 1) x [y, y + 1) from the top-left corner of the mask, which
+// Collider places at the top-left corner of its bounds.
+//
+// Each row is packed into getWordsPerRow() words, bit x % 64 of word x / 64,
+// with the bits past the width kept clear. The words are stored a word column
+// at a time (word w of row y at w * height + y), so the same word of
+// consecutive rows is contiguous: overlaps() shifts one mask's words into the
+// other's frame and ANDs them several rows per vector, with SSE2 or AVX2 when
+// the CPU has them (see InstructionSet).
+class CollisionMask {
+public:
+    CollisionMask() = default;
+    // Every pixel starts open; throws if a dimension is negative
+    CollisionMask(int width, int height);
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getWordsPerRow() const { return m_wordsPerRow; }
+
+    // Out-of-range pixels are ignored by set() and open for get()
+    void set(int x, int y, bool solid);
+    bool get(int x, int y) const;
+
+    // Bits past the width are dropped by setWord()
+    uint64_t getWord(int y, int word) const { return m_words[static_cast<size_t>(word) * m_height + y]; }
+    void setWord(int y, int word, uint64_t bits);
+
+    size_t countSolid() const;
+
+    // True if a solid pixel of a with its top-left corner at originA covers
+    // one of b at originB. The offset between the origins is rounded to whole
+    // pixels. The first form runs on SSE2 where available.
+    static bool overlaps(const CollisionMask& a, const Vector2& originA, const CollisionMask& b, const Vector2& originB);
+    // Throws if instructionSet is not supported
+    static bool overlaps(const CollisionMask& a, const Vector2& originA, const CollisionMask& b, const Vector2& originB,
+                         InstructionSet instructionSet);
+
+    // True if a solid pixel of mask, with its top-left corner at origin,
+    // overlaps area (touching edges do not count)
+    static bool overlaps(const CollisionMask& mask, const Vector2& origin, const Rect& area);
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_wordsPerRow = 0;
+    std::vector<uint64_t> m_words; // By word column, then row
+};
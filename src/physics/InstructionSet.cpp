@@ -0,0 +1,77 @@
+#include "InstructionSet.h"
+
+#if defined(PHYSICS_SIMD_AVX2) && defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace {
+    struct CpuFeatures {
+        bool avx2 = false;
+        bool fma = false;
+    };
+
+    CpuFeatures detectCpuFeatures() {
+        CpuFeatures features;
+#if defined(PHYSICS_SIMD_AVX2) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        features.avx2 = __builtin_cpu_supports("avx2") != 0;
+        features.fma = __builtin_cpu_supports("fma") != 0;
+#elif defined(PHYSICS_SIMD_AVX2)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] >= 7) {
+            __cpuid(info, 1);
+            const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+            features.fma = osSavesYmm && (info[2] & (1 << 12)) != 0;
+            __cpuidex(info, 7, 0);
+            features.avx2 = osSavesYmm && (info[1] & (1 << 5)) != 0;
+        }
+#endif
+        return features;
+    }
+
+    const CpuFeatures& cpuFeatures() {
+        static const CpuFeatures features = detectCpuFeatures();
+        return features;
+    }
+}
+
+bool Simd::isSupported(InstructionSet instructionSet) {
+    switch (instructionSet) {
+        case InstructionSet::Scalar:
+            return true;
+        case InstructionSet::SSE2:
+#ifdef PHYSICS_SIMD_SSE2
+            return true;
+#else
+            return false;
+#endif
+        case InstructionSet::AVX2:
+#ifdef PHYSICS_SIMD_AVX2
+            return cpuFeatures().avx2;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+InstructionSet Simd::bestSupported() {
+    if (isSupported(InstructionSet::AVX2)) return InstructionSet::AVX2;
+    if (isSupported(InstructionSet::SSE2)) return InstructionSet::SSE2;
+    return InstructionSet::Scalar;
+}
+
+bool Simd::hasFma() {
+    return isSupported(InstructionSet::AVX2) && cpuFeatures().fma;
+}
+
+const char* Simd::getName(InstructionSet instructionSet) {
+    switch (instructionSet) {
+        case InstructionSet::Scalar: return "scalar";
+        case InstructionSet::SSE2: return "SSE2";
+        case InstructionSet::AVX2: return "AVX2";
+    }
+    return "unknown";
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// SIMD instruction sets the physics kernels (BodyIntegrator, CollisionMask)
+// are written for, and which of them this build and CPU can run.
+//
+// SSE2 kernels are built whenever the compiler targets SSE2. AVX2 kernels are
+// compiled for that target alone, function by function (PHYSICS_TARGET_AVX2),
+// and only called once isSupported() checked the CPU, so the rest of the
+// build keeps its baseline instruction set. Kernel sources include
+// <immintrin.h> themselves under PHYSICS_SIMD_X86.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PHYSICS_SIMD_X86 1
+#endif
+
+#if defined(PHYSICS_SIMD_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define PHYSICS_SIMD_SSE2 1
+#endif
+
+#if defined(PHYSICS_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PHYSICS_SIMD_AVX2 1
+#define PHYSICS_TARGET_AVX2 __attribute__((target("avx2")))
+#define PHYSICS_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#elif defined(PHYSICS_SIMD_X86) && defined(_MSC_VER)
+#define PHYSICS_SIMD_AVX2 1
+#define PHYSICS_TARGET_AVX2
+#define PHYSICS_TARGET_AVX2_FMA
+#endif
+
+enum class InstructionSet { Scalar, SSE2, AVX2 };
+
+namespace Simd {
+    // Compiled in and, for AVX2, present on this CPU
+    bool isSupported(InstructionSet instructionSet);
+    // The widest supported one
+    InstructionSet bestSupported();
+    // AVX2 with fused multiply-add
+    bool hasFma();
+    const char* getName(InstructionSet instructionSet);
+}
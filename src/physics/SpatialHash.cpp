@@ -0,0 +1,136 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+SpatialHash::SpatialHash(float cellSize) {
+    setCellSize(cellSize);
+}
+
+void SpatialHash::setCellSize(float cellSize) {
+    if (!(cellSize > 0.0f)) {
+        throw std::runtime_error("Spatial hash cell size must be positive");
+    }
+    m_cellSize = cellSize;
+    m_inverseCellSize = 1.0f / cellSize;
+
+    // Existing proxies move to the new grid
+    m_staticCells.clear();
+    for (uint32_t i = 0; i < m_static.size(); ++i) {
+        m_static[i].cells = cellRange(m_staticBounds[i]);
+        addEntries(m_staticCells, m_static[i].cells, i);
+    }
+    m_staticSorted = m_staticCells.empty();
+    m_dynamic.clear();
+    m_dynamicCells.clear();
+}
+
+void SpatialHash::insertStatic(uint32_t id, const Rect& bounds) {
+    const uint32_t proxy = static_cast<uint32_t>(m_static.size());
+    m_static.push_back({id, cellRange(bounds)});
+    m_staticBounds.push_back(bounds);
+    addEntries(m_staticCells, m_static.back().cells, proxy);
+    m_staticSorted = false;
+}
+
+void SpatialHash::clearStatic() {
+    m_static.clear();
+    m_staticBounds.clear();
+    m_staticCells.clear();
+    m_staticSorted = true;
+}
+
+void SpatialHash::insertDynamic(uint32_t id, const Rect& bounds) {
+    const uint32_t proxy = static_cast<uint32_t>(m_dynamic.size());
+    m_dynamic.push_back({id, cellRange(bounds)});
+    addEntries(m_dynamicCells, m_dynamic.back().cells, proxy);
+}
+
+void SpatialHash::clearDynamic() {
+    m_dynamic.clear();
+    m_dynamicCells.clear();
+}
+
+void SpatialHash::findPairs(std::vector<Pair>& pairs) {
+    pairs.clear();
+    sortStatic();
+    std::sort(m_dynamicCells.begin(), m_dynamicCells.end());
+
+    size_t staticBegin = 0;
+    for (size_t runBegin = 0; runBegin < m_dynamicCells.size();) {
+        const uint64_t cell = m_dynamicCells[runBegin].cell;
+        size_t runEnd = runBegin + 1;
+        while (runEnd < m_dynamicCells.size() && m_dynamicCells[runEnd].cell == cell) {
+            ++runEnd;
+        }
+
+        // Dynamic against dynamic within the cell
+        for (size_t i = runBegin; i < runEnd; ++i) {
+            const Proxy& a = m_dynamic[m_dynamicCells[i].proxy];
+            for (size_t j = i + 1; j < runEnd; ++j) {
+                const Proxy& b = m_dynamic[m_dynamicCells[j].proxy];
+                if (isFirstSharedCell(a.cells, b.cells, cell)) {
+                    pairs.push_back({a.id, b.id, false});
+                }
+            }
+        }
+
+        // Dynamic against the static entries of the same cell; both arrays
+        // are sorted, so the static cursor only moves forward
+        while (staticBegin < m_staticCells.size() && m_staticCells[staticBegin].cell < cell) {
+            ++staticBegin;
+        }
+        for (size_t s = staticBegin; s < m_staticCells.size() && m_staticCells[s].cell == cell; ++s) {
+            const Proxy& b = m_static[m_staticCells[s].proxy];
+            for (size_t i = runBegin; i < runEnd; ++i) {
+                const Proxy& a = m_dynamic[m_dynamicCells[i].proxy];
+                if (isFirstSharedCell(a.cells, b.cells, cell)) {
+                    pairs.push_back({a.id, b.id, true});
+                }
+            }
+        }
+
+        runBegin = runEnd;
+    }
+}
+
+SpatialHash::CellRange SpatialHash::cellRange(const Rect& bounds) const {
+    return {cellCoordinate(bounds.x), cellCoordinate(bounds.y),
+            cellCoordinate(bounds.x + bounds.width), cellCoordinate(bounds.y + bounds.height)};
+}
+
+int32_t SpatialHash::cellCoordinate(float position) const {
+    // Clamped so far-away or non-finite boxes land in the outermost cells
+    // instead of overflowing
+    constexpr float LIMIT = 1.0e9f;
+    const float cell = std::floor(position * m_inverseCellSize);
+    if (!(cell > -LIMIT)) return static_cast<int32_t>(-LIMIT);
+    if (!(cell < LIMIT)) return static_cast<int32_t>(LIMIT);
+    return static_cast<int32_t>(cell);
+}
+
+uint64_t SpatialHash::cellKey(int32_t x, int32_t y) {
+    // Offset so keys sort by x, then y, with negative coordinates first
+    const uint32_t ux = static_cast<uint32_t>(x) ^ 0x80000000u;
+    const uint32_t uy = static_cast<uint32_t>(y) ^ 0x80000000u;
+    return (static_cast<uint64_t>(ux) << 32) | uy;
+}
+
+void SpatialHash::addEntries(std::vector<CellEntry>& entries, const CellRange& cells, uint32_t proxy) {
+    for (int32_t x = cells.minX; x <= cells.maxX; ++x) {
+        for (int32_t y = cells.minY; y <= cells.maxY; ++y) {
+            entries.push_back({cellKey(x, y), proxy});
+        }
+    }
+}
+
+bool SpatialHash::isFirstSharedCell(const CellRange& a, const CellRange& b, uint64_t cell) {
+    return cellKey(std::max(a.minX, b.minX), std::max(a.minY, b.minY)) == cell;
+}
+
+void SpatialHash::sortStatic() {
+    if (m_staticSorted) return;
+    std::sort(m_staticCells.begin(), m_staticCells.end());
+    m_staticSorted = true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "graphics/Renderer.h" // Rect
+#include <cstdint>
+#include <vector>
+
+// Uniform-grid broadphase over axis-aligned boxes.
+//
+// Cells are square and addressed by their integer coordinates, so the world
+// needs no bounds. Every proxy is entered into each cell its box touches as a
+// (cell, proxy) entry; entries are kept in flat arrays and sorted by cell
+// instead of being bucketed in a hash map, so rebuilding allocates nothing
+// once the arrays have grown.
+//
+// Proxies carry a caller-chosen id, typically an index into the caller's own
+// collider array. Static proxies stay until clearStatic() and are only sorted
+// again after a change; dynamic proxies are meant to be rebuilt every frame
+// with clearDynamic() + insertDynamic(). findPairs() reports every
+// dynamic/dynamic and dynamic/static pair whose boxes share a cell, exactly
+// once - candidates for an exact overlap test. Pairs of two static proxies are
+// never reported.
+class SpatialHash {
+public:
+    struct Pair {
+        uint32_t a;        // Dynamic proxy id
+        uint32_t b;        // Dynamic or static proxy id, see bStatic
+        bool bStatic;
+    };
+
+    explicit SpatialHash(float cellSize = 64.0f);
+
+    // Re-buckets the static proxies; throws if cellSize is not positive
+    void setCellSize(float cellSize);
+    float getCellSize() const { return m_cellSize; }
+
+    void insertStatic(uint32_t id, const Rect& bounds);
+    void clearStatic();
+
+    void insertDynamic(uint32_t id, const Rect& bounds);
+    void clearDynamic();
+
+    size_t getStaticCount() const { return m_static.size(); }
+    size_t getDynamicCount() const { return m_dynamic.size(); }
+
+    // Replaces pairs' contents; ordered by cell, not by id
+    void findPairs(std::vector<Pair>& pairs);
+
+private:
+    // Range of cells a box touches, inclusive
+    struct CellRange {
+        int32_t minX, minY, maxX, maxY;
+    };
+
+    struct Proxy {
+        uint32_t id;
+        CellRange cells;
+    };
+
+    struct CellEntry {
+        uint64_t cell;
+        uint32_t proxy; // Index into m_static / m_dynamic
+
+        bool operator<(const CellEntry& other) const {
+            return cell != other.cell ? cell < other.cell : proxy < other.proxy;
+        }
+    };
+
+    CellRange cellRange(const Rect& bounds) const;
+    int32_t cellCoordinate(float position) const;
+    static uint64_t cellKey(int32_t x, int32_t y);
+    static void addEntries(std::vector<CellEntry>& entries, const CellRange& cells, uint32_t proxy);
+
+    // Boxes that share several cells are reported from one of them only: the
+    // cell at the lowest corner of the cells they share
+    static bool isFirstSharedCell(const CellRange& a, const CellRange& b, uint64_t cell);
+
+    void sortStatic();
+
+    float m_cellSize;
+    float m_inverseCellSize;
+
+    std::vector<Proxy> m_static;
+    std::vector<Rect> m_staticBounds; // Kept so setCellSize() can re-bucket
+    std::vector<CellEntry> m_staticCells;
+    bool m_staticSorted = true;
+
+    std::vector<Proxy> m_dynamic;
+    std::vector<CellEntry> m_dynamicCells;
+};
@@ -0,0 +1,151 @@
+#include "TileCollisionMap.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    // Clamped before the cast so far-away or non-finite values cannot overflow
+    int clampToInt(float value, int low, int high) {
+        if (!(value > static_cast<float>(low))) return low;
+        if (!(value < static_cast<float>(high))) return high;
+        return static_cast<int>(value);
+    }
+}
+
+TileCollisionMap::TileCollisionMap(int width, int height, float tileSize)
+    : m_width(width), m_height(height), m_tileSize(tileSize), m_skin(tileSize * SKIN) {
+    if (width <= 0 || height <= 0 || !(tileSize > 0.0f)) {
+        throw std::runtime_error("Tile collision map needs a positive size and tile size");
+    }
+    m_solid.assign(static_cast<size_t>(width) * static_cast<size_t>(height), 0);
+}
+
+void TileCollisionMap::setSolid(int x, int y, bool solid) {
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) return;
+    m_solid[static_cast<size_t>(y) * m_width + x] = solid ? 1 : 0;
+}
+
+bool TileCollisionMap::isSolid(int x, int y) const {
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) return false;
+    return m_solid[static_cast<size_t>(y) * m_width + x] != 0;
+}
+
+bool TileCollisionMap::overlapsSolid(const Rect& bounds) const {
+    return anySolid(firstCell(bounds.x), lastCell(bounds.x + bounds.width),
+                    firstCell(bounds.y), lastCell(bounds.y + bounds.height));
+}
+
+TileCollisionMap::SweepResult TileCollisionMap::sweep(const Rect& bounds, const Vector2& delta) const {
+    SweepResult result;
+    result.delta.x = sweepAxis(true, bounds.x, bounds.width, delta.x,
+                               firstCell(bounds.y), lastCell(bounds.y + bounds.height), result.hitX);
+
+    const float x = bounds.x + result.delta.x;
+    result.delta.y = sweepAxis(false, bounds.y, bounds.height, delta.y,
+                               firstCell(x), lastCell(x + bounds.width), result.hitY);
+    return result;
+}
+
+Vector2 TileCollisionMap::resolveOverlap(const Rect& bounds) const {
+    if (!overlapsSolid(bounds)) return Vector2();
+
+    // Ties go to the first direction tried; up first suits platformers
+    Vector2 best;
+    float bestDistance = -1.0f;
+    const struct { bool horizontal; bool positive; } directions[4] = {
+        {false, false}, {false, true}, {true, false}, {true, true}
+    };
+    for (const auto& direction : directions) {
+        float shift = 0.0f;
+        if (!findExit(bounds, direction.horizontal, direction.positive, shift)) continue;
+        if (bestDistance < 0.0f || std::abs(shift) < bestDistance) {
+            bestDistance = std::abs(shift);
+            best = direction.horizontal ? Vector2(shift, 0.0f) : Vector2(0.0f, shift);
+        }
+    }
+    return best;
+}
+
+int TileCollisionMap::firstCell(float min) const {
+    const int limit = std::max(m_width, m_height) + 1;
+    return clampToInt(std::floor((min + m_skin) / m_tileSize), -1, limit);
+}
+
+int TileCollisionMap::lastCell(float max) const {
+    const int limit = std::max(m_width, m_height) + 1;
+    return clampToInt(std::ceil((max - m_skin) / m_tileSize) - 1.0f, -1, limit);
+}
+
+bool TileCollisionMap::anySolid(int minX, int maxX, int minY, int maxY) const {
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, m_width - 1);
+    maxY = std::min(maxY, m_height - 1);
+    for (int y = minY; y <= maxY; ++y) {
+        const uint8_t* row = &m_solid[static_cast<size_t>(y) * m_width];
+        for (int x = minX; x <= maxX; ++x) {
+            if (row[x]) return true;
+        }
+    }
+    return false;
+}
+
+float TileCollisionMap::sweepAxis(bool horizontal, float min, float size, float delta,
+                                  int otherFirst, int otherLast, bool& hit) const {
+    if (delta == 0.0f || otherFirst > otherLast) return delta;
+
+    const int count = horizontal ? m_width : m_height;
+    auto solidAt = [&](int cell) {
+        return horizontal ? anySolid(cell, cell, otherFirst, otherLast)
+                          : anySolid(otherFirst, otherLast, cell, cell);
+    };
+
+    // Only cells beyond the leading edge are tested, nearest first
+    if (delta > 0.0f) {
+        const float edge = min + size;
+        const float target = edge + delta;
+        for (int cell = clampToInt(std::ceil((edge - m_skin) / m_tileSize), 0, count);
+             cell < count && cell * m_tileSize < target; ++cell) {
+            if (solidAt(cell)) {
+                hit = true;
+                return std::max(0.0f, cell * m_tileSize - edge);
+            }
+        }
+    } else {
+        const float target = min + delta;
+        for (int cell = clampToInt(std::floor((min + m_skin) / m_tileSize) - 1.0f, -1, count - 1);
+             cell >= 0 && (cell + 1) * m_tileSize > target; --cell) {
+            if (solidAt(cell)) {
+                hit = true;
+                return std::min(0.0f, (cell + 1) * m_tileSize - min);
+            }
+        }
+    }
+    return delta;
+}
+
+bool TileCollisionMap::findExit(const Rect& bounds, bool horizontal, bool positive, float& shift) const {
+    Rect moved = bounds;
+    for (int step = 0; step < MAX_RESOLVE_STEPS; ++step) {
+        const int minX = firstCell(moved.x);
+        const int maxX = lastCell(moved.x + moved.width);
+        const int minY = firstCell(moved.y);
+        const int maxY = lastCell(moved.y + moved.height);
+        if (!anySolid(minX, maxX, minY, maxY)) {
+            shift = horizontal ? moved.x - bounds.x : moved.y - bounds.y;
+            return true;
+        }
+
+        // Jump past the farthest solid cell in the direction of travel
+        if (horizontal) {
+            int blocking = positive ? maxX : minX;
+            while (!anySolid(blocking, blocking, minY, maxY)) blocking += positive ? -1 : 1;
+            moved.x = positive ? (blocking + 1) * m_tileSize : blocking * m_tileSize - moved.width;
+        } else {
+            int blocking = positive ? maxY : minY;
+            while (!anySolid(minX, maxX, blocking, blocking)) blocking += positive ? -1 : 1;
+            moved.y = positive ? (blocking + 1) * m_tileSize : blocking * m_tileSize - moved.height;
+        }
+    }
+    return false;
+}
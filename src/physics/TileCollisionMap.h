@@ -0,0 +1,71 @@
+#pragma once
+
+#include "graphics/Renderer.h" // Rect, Vector2
+#include <cstdint>
+#include <vector>
+
+// Solid/open grid for colliding boxes against a tile map without an entity
+// per tile. Cell (x, y) covers [x * tileSize, (x + 1) * tileSize) on each
+// axis, relative to the map's origin; cells outside the grid are open.
+//
+// Every call takes bounds relative to the origin and only visits the cells
+// the box overlaps or sweeps through, so its cost does not depend on the
+// size of the map. Boxes that touch a solid cell, or overlap it by less than
+// a thousandth of a tile (float rounding after a sweep), do not overlap it.
+class TileCollisionMap {
+public:
+    struct SweepResult {
+        Vector2 delta; // The part of the requested movement that is possible
+        bool hitX = false;
+        bool hitY = false;
+    };
+
+    // Every cell starts open; throws if a dimension or tileSize is not positive
+    TileCollisionMap(int width, int height, float tileSize = 32.0f);
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    float getTileSize() const { return m_tileSize; }
+
+    // Out-of-range cells are ignored by setSolid() and open for isSolid()
+    void setSolid(int x, int y, bool solid);
+    bool isSolid(int x, int y) const;
+
+    bool overlapsSolid(const Rect& bounds) const;
+
+    // Moves bounds by delta along x, then along y from where x stopped,
+    // clipping each axis at the first solid cell in the way. Cells the box
+    // already overlaps are ignored, so a box stuck in a wall can move out.
+    SweepResult sweep(const Rect& bounds, const Vector2& delta) const;
+
+    // Shortest single-axis translation that takes bounds out of every solid
+    // cell, looking at most MAX_RESOLVE_STEPS solid runs away per direction.
+    // Zero if the box overlaps nothing or no way out was found.
+    Vector2 resolveOverlap(const Rect& bounds) const;
+
+private:
+    static constexpr int MAX_RESOLVE_STEPS = 8;
+    static constexpr float SKIN = 1.0e-3f; // In tiles
+
+    // Cells whose interior the span [min, max] overlaps
+    int firstCell(float min) const;
+    int lastCell(float max) const;
+
+    // Any solid cell in the inclusive column and row ranges
+    bool anySolid(int minX, int maxX, int minY, int maxY) const;
+
+    // Clips delta along one axis; min/size describe the box on that axis and
+    // [otherFirst, otherLast] the cells it covers on the other one
+    float sweepAxis(bool horizontal, float min, float size, float delta,
+                    int otherFirst, int otherLast, bool& hit) const;
+
+    // Translation along one axis and direction out of every solid cell;
+    // false if none was found within MAX_RESOLVE_STEPS
+    bool findExit(const Rect& bounds, bool horizontal, bool positive, float& shift) const;
+
+    int m_width;
+    int m_height;
+    float m_tileSize;
+    float m_skin; // SKIN in world units
+    std::vector<uint8_t> m_solid; // Row-major
+};
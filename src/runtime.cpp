@@ -12,11 +12,13 @@ public:
         auto renderSystem = registerSystem<RenderSystem>();
         auto physicsSystem = registerSystem<PhysicsSystem>();
         auto collisionSystem = registerSystem<CollisionSystem>();
+        auto triggerSystem = registerSystem<TriggerSystem>();
         
         // Set scene pointer for each system
         renderSystem->setScene(this);
         physicsSystem->setScene(this);
         collisionSystem->setScene(this);
+        triggerSystem->setScene(this);
         
         ComponentMask renderSignature;
         renderSignature.set(getComponentType<Transform>());
@@ -33,6 +35,11 @@ public:
         collisionSignature.set(getComponentType<Collider>());
         setSystemSignature<CollisionSystem>(collisionSignature);
         
+        ComponentMask triggerSignature;
+        triggerSignature.set(getComponentType<Transform>());
+        triggerSignature.set(getComponentType<EnvironmentTrigger>());
+        setSystemSignature<TriggerSystem>(triggerSignature);
+        
         // Create a player entity
         createPlayer();
         
@@ -50,7 +57,9 @@ private:
         addComponent<Sprite>(player, Sprite());
         
         addComponent<Collider>(player, Collider(32, 32));
-        addComponent<RigidBody>(player, RigidBody());
+        RigidBody body;
+        body.canSleep = false; // Driven by game code rather than physics
+        addComponent<RigidBody>(player, body);
     }
     
     void createTestEntities() {
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "components/Components.h"
+#include "components/ComponentManager.h"
+#include "Resources.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// An entity created by a CommandBuffer. It has no EntityID until playback,
+// but later commands in the same buffer can target it.
+struct PendingEntity {
+    uint32_t index;
+};
+
+// Records structural changes - entity creation/destruction, component (and
+// tag) add/remove and resource insertion/removal - so they can be made from code that must not touch the scene's
+// entity lists directly, e.g. system updates running on worker threads.
+//
+// A buffer belongs to one thread (see Scene::getCommandBuffer()); recording
+// never touches the scene. Scene::playbackCommands() applies every buffer in
+// one batch at a sync point. Commands aimed at an entity that is no longer
+// alive by the time they play back are dropped.
+class CommandBuffer {
+public:
+    // Either a live entity handle or an entity created earlier in this buffer
+    struct Target {
+        Target(EntityID entity) : value(entity), pending(false) {}
+        Target(PendingEntity entity) : value(entity.index), pending(true) {}
+
+        uint32_t value;
+        bool pending;
+    };
+
+    PendingEntity createEntity() {
+        m_commands.push_back({CommandKind::Create, PendingEntity{m_pendingCount}, nullptr});
+        return PendingEntity{m_pendingCount++};
+    }
+
+    void destroyEntity(Target entity) {
+        m_commands.push_back({CommandKind::Destroy, entity, nullptr});
+    }
+
+    // Adds the component, or overwrites it if the entity already has one
+    template<typename T>
+    void addComponent(Target entity, T component) {
+        using Stored = std::decay_t<T>;
+        m_commands.push_back({CommandKind::Add, entity,
+            [value = std::move(component)](ComponentManager& components, EntityID target) mutable {
+                components.addComponent<Stored>(target, std::move(value));
+                return components.getComponentType<Stored>();
+            }});
+    }
+
+    template<typename T>
+    void removeComponent(Target entity) {
+        m_commands.push_back({CommandKind::Remove, entity,
+            [](ComponentManager& components, EntityID target) {
+                components.removeComponent<T>(target);
+                return components.getComponentType<T>();
+            }});
+    }
+
+    void setName(Target entity, std::string name) {
+        addComponent(entity, Name(std::move(name)));
+    }
+
+    // Inserts or replaces a scene resource (see ResourceMap). Resource
+    // commands play back after the buffer's entity commands.
+    template<typename T>
+    void setResource(T resource) {
+        using Stored = std::decay_t<T>;
+        m_resourceCommands.push_back([value = std::move(resource)](ResourceMap& resources) mutable {
+            resources.set<Stored>(std::move(value));
+        });
+    }
+
+    template<typename T>
+    void removeResource() {
+        m_resourceCommands.push_back([](ResourceMap& resources) { resources.remove<T>(); });
+    }
+
+    bool empty() const { return m_commands.empty() && m_resourceCommands.empty(); }
+    size_t size() const { return m_commands.size() + m_resourceCommands.size(); }
+
+    void clear() {
+        m_commands.clear();
+        m_resourceCommands.clear();
+        m_pendingCount = 0;
+    }
+
+private:
+    friend class Scene;
+
+    enum class CommandKind : uint8_t { Create, Destroy, Add, Remove };
+
+    struct Command {
+        CommandKind kind;
+        Target target;
+        // Add/Remove: applies the change and returns the component's signature bit
+        std::function<ComponentType(ComponentManager&, EntityID)> apply;
+    };
+
+    std::vector<Command> m_commands;
+    std::vector<std::function<void(ResourceMap&)>> m_resourceCommands;
+    uint32_t m_pendingCount = 0;
+};
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "components/Components.h"
+#include "components/TypeId.h"
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Type-erased interface so the EventBus can flip every queue
+class IEventQueue {
+public:
+    virtual ~IEventQueue() = default;
+    virtual void swap() = 0;
+    virtual void clear() = 0;
+};
+
+namespace EventQueueDetail {
+    // Distinguishes queues in the per-thread writer cache, so a queue
+    // allocated where a destroyed one lived is never mistaken for it
+    inline std::atomic<uint64_t> nextSerial{1};
+}
+
+// Double-buffered queue for one event type.
+//
+// Each publishing thread appends to its own buffer; the mutex is only taken
+// the first time a thread publishes to the queue. swap() moves everything
+// published since the previous swap into the readable array and drops the
+// events that were readable before.
+template<typename T>
+class EventQueue : public IEventQueue {
+public:
+    EventQueue() : m_serial(EventQueueDetail::nextSerial.fetch_add(1, std::memory_order_relaxed)) {}
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    void publish(T event) {
+        writeBuffer().push_back(std::move(event));
+    }
+
+    // Appends a whole batch with one buffer lookup, keeping its order
+    void publish(const std::vector<T>& events) {
+        if (events.empty()) return;
+        std::vector<T>& buffer = writeBuffer();
+        buffer.insert(buffer.end(), events.begin(), events.end());
+    }
+
+    // Events published before the last swap(). Each thread's events keep their
+    // publishing order; threads appear in the order they first published.
+    const std::vector<T>& read() const { return m_readable; }
+
+    // Must not run concurrently with publish() or read()
+    void swap() override {
+        m_readable.clear();
+        std::lock_guard<std::mutex> lock(m_writersMutex);
+        for (auto& writer : m_writers) {
+            std::move(writer->events.begin(), writer->events.end(), std::back_inserter(m_readable));
+            writer->events.clear();
+        }
+    }
+
+    void clear() override {
+        m_readable.clear();
+        std::lock_guard<std::mutex> lock(m_writersMutex);
+        for (auto& writer : m_writers) {
+            writer->events.clear();
+        }
+    }
+
+private:
+    struct Writer {
+        std::thread::id thread;
+        std::vector<T> events;
+    };
+
+    // Last queue of this type the calling thread published to
+    struct CachedWriter {
+        uint64_t queueSerial = 0;
+        std::vector<T>* events = nullptr;
+    };
+
+    std::vector<T>& writeBuffer() {
+        thread_local CachedWriter t_cachedWriter;
+        if (t_cachedWriter.queueSerial == m_serial) {
+            return *t_cachedWriter.events;
+        }
+
+        std::lock_guard<std::mutex> lock(m_writersMutex);
+        const std::thread::id thread = std::this_thread::get_id();
+        Writer* writer = nullptr;
+        for (auto& candidate : m_writers) {
+            if (candidate->thread == thread) {
+                writer = candidate.get();
+                break;
+            }
+        }
+        if (!writer) {
+            m_writers.push_back(std::make_unique<Writer>());
+            writer = m_writers.back().get();
+            writer->thread = thread;
+        }
+
+        t_cachedWriter = {m_serial, &writer->events};
+        return writer->events;
+    }
+
+    const uint64_t m_serial;
+    std::vector<T> m_readable;
+    std::mutex m_writersMutex;
+    std::vector<std::unique_ptr<Writer>> m_writers; // Stable addresses for the cache
+};
+
+// Typed events between systems, one EventQueue per event type.
+//
+// Events published during a frame become readable at the end of that frame's
+// Scene::update and stay readable until the end of the next one, so every
+// system sees the previous frame's events whatever order the scheduler runs
+// them in, and code outside the update sees the frame that just finished.
+// Publishing is safe from any thread and reading only touches the readable
+// array, so systems need no reads<>/writes<> declaration for events.
+//
+// Event types are registered up front (registerEvent<T>()), like components;
+// publishing or reading an unregistered type throws.
+class EventBus {
+public:
+    template<typename T>
+    void registerEvent() {
+        const size_t id = EventId<T>::value;
+        if (id >= m_queues.size()) {
+            m_queues.resize(id + 1);
+        }
+        if (!m_queues[id]) {
+            m_queues[id] = std::make_unique<EventQueue<T>>();
+        }
+    }
+
+    template<typename T>
+    bool isRegistered() const {
+        const size_t id = EventId<T>::value;
+        return id < m_queues.size() && m_queues[id] != nullptr;
+    }
+
+    template<typename T>
+    void publish(T event) {
+        queue<T>().publish(std::move(event));
+    }
+
+    template<typename T>
+    void publishBatch(const std::vector<T>& events) {
+        queue<T>().publish(events);
+    }
+
+    template<typename T>
+    const std::vector<T>& read() const {
+        return queue<T>().read();
+    }
+
+    // The sync point: makes this frame's events readable
+    void swap() {
+        for (auto& eventQueue : m_queues) {
+            if (eventQueue) eventQueue->swap();
+        }
+    }
+
+    // Drops every pending and readable event; registrations are kept
+    void clear() {
+        for (auto& eventQueue : m_queues) {
+            if (eventQueue) eventQueue->clear();
+        }
+    }
+
+private:
+    template<typename T>
+    EventQueue<T>& queue() const {
+        const size_t id = EventId<T>::value;
+        if (id >= m_queues.size() || !m_queues[id]) {
+            throw std::runtime_error("Event type not registered");
+        }
+        return static_cast<EventQueue<T>&>(*m_queues[id]);
+    }
+
+    std::vector<std::unique_ptr<IEventQueue>> m_queues; // Indexed by EventId<T>::value
+};
+
+// Built-in events, registered by Scene::initialize()
+
+// Two solid colliders overlapped this frame and were pushed apart
+// (CollisionSystem). a is always a moving collider; overlaps between two
+// isStatic colliders are not reported, and pairs involving a trigger only
+// produce ContactEvents. normal is CollisionSystem::getCollisionNormal() of
+// a's and b's bounds.
+struct CollisionEvent {
+    EntityID a;
+    EntityID b;
+    Vector2 normal;
+};
+
+// Two colliders started touching, are still touching or stopped touching
+// (CollisionSystem's contact cache). a < b, so a pair keeps its order across
+// phases. Exit is also sent when either entity is destroyed or loses its
+// Collider, so a or b may no longer be alive. Stay is only sent when
+// CollisionSystem::setStayEvents() is on.
+struct ContactEvent {
+    enum class Phase {
+        Enter,
+        Stay,
+        Exit
+    };
+
+    EntityID a;
+    EntityID b;
+    Phase phase;
+    bool trigger; // Either collider is a trigger
+};
+
+// An entity with a Collider entered, stayed in or left an EnvironmentTrigger
+// area (TriggerSystem). Only the phase the trigger's type asks for is sent.
+struct TriggerEvent {
+    EntityID trigger;
+    EntityID other;
+    EnvironmentTrigger::TriggerType type;
+};
+
+// Player actions (PlayerSystem)
+struct PlayerEvent {
+    enum Type {
+        LevelUp,
+        Death,
+        ItemPickup,
+        AbilityUsed,
+        StateChanged
+    };
+
+    Type type;
+    EntityID playerEntity;
+    int slot = -1; // Ability or item slot the event refers to, -1 if none
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "components/TypeId.h"
+#include "graphics/Renderer.h" // Color, Vector2
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Scene-wide singletons keyed by type, e.g. the ambient light colour.
+//
+// Lookups are an array index by ResourceId<T>. Systems declare resource access
+// the same way as component access - reads<AmbientLight>() or
+// writes<AmbientLight>() - so the scheduler never runs a writer alongside a
+// reader. Inserting or removing a resource is structural: during system
+// updates it goes through CommandBuffer::setResource()/removeResource().
+class ResourceMap {
+public:
+    // Inserts the resource, or replaces the current value
+    template<typename T>
+    void set(T value) {
+        const size_t id = ResourceId<T>::value;
+        if (id >= m_slots.size()) {
+            m_slots.resize(id + 1);
+        }
+        if (m_slots[id]) {
+            static_cast<Slot<T>*>(m_slots[id].get())->value = std::move(value);
+        } else {
+            m_slots[id] = std::make_unique<Slot<T>>(std::move(value));
+        }
+    }
+
+    // nullptr if the scene has no T
+    template<typename T>
+    T* find() {
+        const size_t id = ResourceId<T>::value;
+        if (id >= m_slots.size() || !m_slots[id]) return nullptr;
+        return &static_cast<Slot<T>*>(m_slots[id].get())->value;
+    }
+
+    template<typename T>
+    const T* find() const {
+        return const_cast<ResourceMap*>(this)->find<T>();
+    }
+
+    template<typename T>
+    T& get() {
+        T* resource = find<T>();
+        if (!resource) {
+            throw std::runtime_error("Resource not found");
+        }
+        return *resource;
+    }
+
+    template<typename T>
+    const T& get() const {
+        return const_cast<ResourceMap*>(this)->get<T>();
+    }
+
+    template<typename T>
+    bool contains() const { return find<T>() != nullptr; }
+
+    template<typename T>
+    void remove() {
+        const size_t id = ResourceId<T>::value;
+        if (id < m_slots.size()) {
+            m_slots[id].reset();
+        }
+    }
+
+    void clear() { m_slots.clear(); }
+
+    // Replaces every resource with a copy of source's. Throws if a resource
+    // type is not copyable.
+    void copyFrom(const ResourceMap& source) {
+        if (&source == this) return;
+        m_slots.resize(source.m_slots.size());
+        for (size_t id = 0; id < m_slots.size(); ++id) {
+            m_slots[id] = source.m_slots[id] ? source.m_slots[id]->clone() : nullptr;
+        }
+    }
+
+private:
+    struct SlotBase {
+        virtual ~SlotBase() = default;
+        virtual std::unique_ptr<SlotBase> clone() const = 0;
+    };
+
+    template<typename T>
+    struct Slot : SlotBase {
+        explicit Slot(T resource) : value(std::move(resource)) {}
+
+        std::unique_ptr<SlotBase> clone() const override {
+            if constexpr (std::is_copy_constructible_v<T>) {
+                return std::make_unique<Slot<T>>(value);
+            } else {
+                throw std::runtime_error("Resource is not copyable");
+            }
+        }
+
+        T value;
+    };
+
+    std::vector<std::unique_ptr<SlotBase>> m_slots; // Indexed by ResourceId<T>::value
+};
+
+// Built-in resources, inserted with their defaults by Scene::initialize()
+
+// Colour LightSystem fills the screen with before drawing lights
+struct AmbientLight {
+    Color color{50, 50, 80, 255}; // Dim blue
+};
+
+// Where AudioSystem hears 3D sources from
+struct AudioListenerPosition {
+    Vector2 position{0, 0};
+};
+
+// Which collider layers (Collider::layer, EnvironmentCollider::layer) meet,
+// as one bit per pair of the 32 layers. Kept symmetric; every pair collides
+// by default. CollisionSystem tests it before it looks at any bounds.
+struct CollisionMatrix {
+    static constexpr int LAYER_COUNT = 32;
+    
+    std::array<uint32_t, LAYER_COUNT> rows; // Bit b of rows[a]: layers a and b collide
+    
+    CollisionMatrix() { rows.fill(~0u); }
+    
+    bool collides(uint8_t a, uint8_t b) const {
+        return (rows[a % LAYER_COUNT] >> (b % LAYER_COUNT)) & 1u;
+    }
+    
+    void setCollides(uint8_t a, uint8_t b, bool collide) {
+        a %= LAYER_COUNT;
+        b %= LAYER_COUNT;
+        if (collide) {
+            rows[a] |= 1u << b;
+            rows[b] |= 1u << a;
+        } else {
+            rows[a] &= ~(1u << b);
+            rows[b] &= ~(1u << a);
+        }
+    }
+    
+    bool operator==(const CollisionMatrix& other) const { return rows == other.rows; }
+    bool operator!=(const CollisionMatrix& other) const { return rows != other.rows; }
+};
@@ -3,8 +3,21 @@
 #include "../components/EntityManager.h"
 #include "../generation/ProceduralGeneration.h"
 #include "../components/Components.h"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+    std::atomic<uint64_t> g_nextSceneSerial{1};
+
+    // Last buffer the calling thread used, so lookups usually skip the mutex
+    struct CachedCommandBuffer {
+        uint64_t sceneSerial = 0;
+        CommandBuffer* buffer = nullptr;
+    };
+    thread_local CachedCommandBuffer t_cachedCommandBuffer;
+}
 
-Scene::Scene() {
+Scene::Scene() : m_serial(g_nextSceneSerial.fetch_add(1, std::memory_order_relaxed)) {
     m_componentManager = std::make_unique<ComponentManager>();
     m_entityManager = std::make_unique<EntityManager>();
     systemManager = std::make_unique<SystemManager>();
@@ -29,6 +42,7 @@ void Scene::initialize() {
     registerComponent<Name>();
     registerComponent<ProceduralGenerated>();
     registerComponent<Transform>();
+    registerComponent<PreviousTransform>();
     registerComponent<Rotation>();
     registerComponent<Scale>();
     registerComponent<Sprite>();
@@ -36,6 +50,8 @@ void Scene::initialize() {
     registerComponent<RigidBody>();
     registerComponent<EntitySpawner>();
     registerComponent<ParticleEffect>();
+    registerComponent<EnvironmentTrigger>();
+    registerComponent<EnvironmentCollider>();
     
     // Register player-specific components
     registerComponent<PlayerController>();
@@ -64,26 +80,230 @@ void Scene::initialize() {
     registerComponent<UIImage>();
     registerComponent<UIHealthBar>();
     registerComponent<UIInventorySlot>();
+    
+    // Register tags
+    registerComponent<Static>();
+    registerComponent<Sleeping>();
+    
+    // Built-in resources with their defaults
+    setResource(AmbientLight());
+    setResource(AudioListenerPosition());
+    setResource(CollisionMatrix());
+    
+    // Built-in events
+    registerEvent<CollisionEvent>();
+    registerEvent<ContactEvent>();
+    registerEvent<TriggerEvent>();
+    registerEvent<PlayerEvent>();
 }
 
 void Scene::update(float deltaTime) {
+    // Drop removal records from before the previous frame and start a new tick
+    const ChangeTick previousFrameTick = m_removedPruneTick;
+    m_componentManager->pruneRemoved(m_removedPruneTick);
+    m_removedPruneTick = m_componentManager->advanceChangeTick();
+    
+    // Interpolation baseline, before anything moves
+    storePreviousTransforms(previousFrameTick);
+    m_interpolationAlpha = 1.0f;
+    
+    // Sync points: changes recorded between frames, then those recorded by systems
+    playbackCommands();
+    refreshSpatialIndex();
     systemManager->update(deltaTime);
+    playbackCommands();
+    refreshSpatialIndex();
+    
+    // Events published this frame become readable until the end of the next
+    m_events.swap();
 }
 
 void Scene::render(Renderer* renderer) {
     systemManager->render(renderer);
 }
 
+void Scene::render(Renderer* renderer, float alpha) {
+    m_interpolationAlpha = std::min(std::max(alpha, 0.0f), 1.0f);
+    render(renderer);
+}
+
+void Scene::storePreviousTransforms(ChangeTick since) {
+    if (!m_componentManager->isRegistered<PreviousTransform>()) return;
+    
+    // Physics moves bodies in fixed steps, so every one is interpolated
+    // whether or not whoever built it asked for that
+    if (m_componentManager->isRegistered<RigidBody>()) {
+        m_untrackedBodies.clear();
+        view<const Transform>().with<RigidBody>().exclude<PreviousTransform>().added<Transform, RigidBody>(since).each(
+            [this](EntityID entity, const Transform& transform) { m_untrackedBodies.emplace_back(entity, transform); });
+        for (const auto& [entity, previous] : m_untrackedBodies) {
+            addComponent(entity, previous);
+        }
+    }
+    
+    if (m_componentManager->getLastAddedTick(m_componentManager->getComponentType<PreviousTransform>()) == 0) {
+        return;
+    }
+    
+    // A Transform not written since the last copy still equals its copy
+    auto store = [](EntityID, const Transform& transform, PreviousTransform& previous) {
+        previous = PreviousTransform(transform);
+    };
+    view<const Transform, PreviousTransform>().changed<Transform>(since).each(store);
+}
+
+void Scene::refreshSpatialIndex() {
+    if (!m_componentManager->isRegistered<Transform>() || !m_componentManager->isRegistered<Collider>()) return;
+    
+    const ChangeTick since = m_spatialTick;
+    auto touched = [&](ComponentType type) {
+        return m_componentManager->getLastAddedTick(type) > since ||
+               m_componentManager->getLastChangedTick(type) > since ||
+               m_componentManager->getLastRemovedTick(type) > since;
+    };
+    if (!touched(m_componentManager->getComponentType<Transform>()) &&
+        !touched(m_componentManager->getComponentType<Collider>())) {
+        return;
+    }
+    m_spatialTick = m_componentManager->advanceChangeTick();
+    
+    auto dropIfGone = [this](EntityID entity) {
+        if (!m_spatialIndex.contains(entity)) return;
+        if (!isAlive(entity) || !hasComponent<Transform>(entity) || !hasComponent<Collider>(entity)) {
+            m_spatialIndex.remove(entity);
+        }
+    };
+    forEachRemoved<Transform>(since, dropIfGone);
+    forEachRemoved<Collider>(since, dropIfGone);
+    
+    // Added components count as changed
+    view<const Transform, const Collider>().changed<Transform, Collider>(since).each(
+        [this](EntityID entity, const Transform& transform, const Collider& collider) {
+            m_spatialIndex.update(entity, collider.getBounds(transform.position));
+        });
+}
+
 void Scene::cleanup() {
     // Cleanup will be handled by unique_ptr destructors
 }
 
-std::vector<EntityID> Scene::getEntitiesWithComponents(ComponentMask signature) {
+CommandBuffer& Scene::getCommandBuffer() {
+    if (t_cachedCommandBuffer.sceneSerial == m_serial) {
+        return *t_cachedCommandBuffer.buffer;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_commandBuffersMutex);
+    const std::thread::id thread = std::this_thread::get_id();
+    CommandBuffer* buffer = nullptr;
+    for (auto& [owner, candidate] : m_commandBuffers) {
+        if (owner == thread) {
+            buffer = candidate.get();
+            break;
+        }
+    }
+    if (!buffer) {
+        m_commandBuffers.emplace_back(thread, std::make_unique<CommandBuffer>());
+        buffer = m_commandBuffers.back().second.get();
+    }
+    
+    t_cachedCommandBuffer = {m_serial, buffer};
+    return *buffer;
+}
+
+void Scene::playbackCommands() {
+    std::lock_guard<std::mutex> lock(m_commandBuffersMutex);
+    for (auto& entry : m_commandBuffers) {
+        CommandBuffer& buffer = *entry.second;
+        if (buffer.empty()) continue;
+        playback(buffer);
+        buffer.clear();
+    }
+    flushPlaybackSignatures();
+}
+
+void Scene::playback(CommandBuffer& buffer) {
+    std::vector<EntityID> created(buffer.m_pendingCount, Entity::Null);
+    auto resolve = [&](const CommandBuffer::Target& target) {
+        return target.pending ? created[target.value] : target.value;
+    };
+    
+    for (auto& command : buffer.m_commands) {
+        if (command.kind == CommandBuffer::CommandKind::Create) {
+            const EntityID entity = m_entityManager->createEntity();
+            created[command.target.value] = entity;
+            touchForPlayback(entity);
+            continue;
+        }
+        
+        const EntityID entity = resolve(command.target);
+        if (!m_entityManager->isAlive(entity)) continue;
+        
+        switch (command.kind) {
+        case CommandBuffer::CommandKind::Destroy: {
+            auto found = m_playbackIndex.find(entity);
+            if (found != m_playbackIndex.end()) {
+                m_playbackEntries[found->second].destroyed = true;
+            }
+            destroyEntity(entity);
+            break;
+        }
+        case CommandBuffer::CommandKind::Add:
+        case CommandBuffer::CommandKind::Remove: {
+            // Only the component data changes here; signatures and system
+            // membership are updated once per entity in flushPlaybackSignatures()
+            PlaybackEntry& entry = touchForPlayback(entity);
+            const ComponentType type = command.apply(*m_componentManager, entity);
+            entry.after.set(type, command.kind == CommandBuffer::CommandKind::Add);
+            break;
+        }
+        case CommandBuffer::CommandKind::Create:
+            break;
+        }
+    }
+    
+    for (auto& command : buffer.m_resourceCommands) {
+        command(m_resources);
+    }
+}
+
+Scene::PlaybackEntry& Scene::touchForPlayback(EntityID entity) {
+    auto [found, inserted] = m_playbackIndex.try_emplace(entity, m_playbackEntries.size());
+    if (inserted) {
+        const ComponentMask& signature = m_entityManager->getSignature(entity);
+        m_playbackEntries.push_back({entity, signature, signature, false});
+    }
+    return m_playbackEntries[found->second];
+}
+
+void Scene::flushPlaybackSignatures() {
+    for (const PlaybackEntry& entry : m_playbackEntries) {
+        if (entry.destroyed || entry.before == entry.after) continue;
+        
+        m_entityManager->setSignature(entry.entity, entry.after);
+        const ComponentMask changed = entry.before ^ entry.after;
+        if (changed.count() == 1) {
+            for (ComponentType type = 0; type < MAX_COMPONENTS; ++type) {
+                if (changed.test(type)) {
+                    systemManager->entityComponentChanged(entry.entity, type, entry.after);
+                    break;
+                }
+            }
+        } else {
+            systemManager->entitySignatureChanged(entry.entity, entry.after);
+        }
+    }
+    m_playbackEntries.clear();
+    m_playbackIndex.clear();
+}
+
+std::vector<EntityID> Scene::getEntitiesWithComponents(ComponentMask signature) const {
     std::vector<EntityID> entities;
     
-    // This is a simple implementation - in a real engine you'd want more efficient queries
-    for (EntityID entity = 0; entity < m_entityManager->getLivingEntityCount(); ++entity) {
-        auto entitySignature = m_entityManager->getSignature(entity);
+    for (uint32_t index = 1; index < m_entityManager->getEntityCapacity(); ++index) {
+        EntityID entity = m_entityManager->getEntityAtIndex(index);
+        if (entity == Entity::Null) continue;
+        
+        const auto& entitySignature = m_entityManager->getSignature(entity);
         if ((entitySignature & signature) == signature) {
             entities.push_back(entity);
         }
@@ -111,7 +331,10 @@ std::string Scene::getEntityName(EntityID entity) const {
 std::vector<EntityID> Scene::getAllLivingEntities() const {
     std::vector<EntityID> entities;
     // Check for entities with non-empty signatures (living entities)
-    for (EntityID entity = 1; entity < EntityManager::getMaxEntities(); ++entity) {
+    for (uint32_t index = 1; index < m_entityManager->getEntityCapacity(); ++index) {
+        EntityID entity = m_entityManager->getEntityAtIndex(index);
+        if (entity == Entity::Null) continue;
+        
         auto signature = m_entityManager->getSignature(entity);
         if (signature.any()) { // Entity has at least one component
             entities.push_back(entity);
@@ -120,10 +343,68 @@ std::vector<EntityID> Scene::getAllLivingEntities() const {
     return entities;
 }
 
+std::vector<ComponentPoolStats> Scene::getComponentMemoryReport() const {
+    return m_componentManager->getMemoryReport();
+}
+
+size_t Scene::getEntityMemoryUsage() const {
+    return m_entityManager->getMemoryUsage();
+}
+
 void Scene::setProceduralMap(std::shared_ptr<ProceduralMap> map) {
     m_proceduralMap = map;
 }
 
+SceneSnapshot Scene::snapshot() const {
+    SceneSnapshot result;
+    snapshot(result);
+    return result;
+}
+
+void Scene::snapshot(SceneSnapshot& into) const {
+    into.m_components->copyFrom(*m_componentManager);
+    *into.m_entities = *m_entityManager;
+    into.m_resources.copyFrom(m_resources);
+    into.m_proceduralMap = m_proceduralMap;
+}
+
+void Scene::restore(const SceneSnapshot& snapshot) {
+    copyState(*snapshot.m_components, *snapshot.m_entities, snapshot.m_resources, snapshot.m_proceduralMap);
+}
+
+void Scene::copyFrom(const Scene& source) {
+    if (&source == this) return;
+    copyState(*source.m_componentManager, *source.m_entityManager, source.m_resources, source.m_proceduralMap);
+}
+
+void Scene::copyState(const ComponentManager& components, const EntityManager& entities,
+                      const ResourceMap& resources, std::shared_ptr<ProceduralMap> proceduralMap) {
+    // Pending commands and events refer to entities of the state being replaced
+    discardPendingCommands();
+    m_events.clear();
+    
+    m_componentManager->copyFrom(components);
+    *m_entityManager = entities;
+    m_resources.copyFrom(resources);
+    m_proceduralMap = std::move(proceduralMap);
+    
+    m_componentManager->markAllAdded();
+    systemManager->rebuildMembership(*m_entityManager);
+    
+    // Removal records of the replaced state are gone, so start over
+    m_spatialIndex.clear();
+    m_spatialTick = 0;
+}
+
+void Scene::discardPendingCommands() {
+    std::lock_guard<std::mutex> lock(m_commandBuffersMutex);
+    for (auto& entry : m_commandBuffers) {
+        entry.second->clear();
+    }
+    m_playbackEntries.clear();
+    m_playbackIndex.clear();
+}
+
 // Explicit template instantiations for all component types used in the game
 // This ensures the template methods are compiled into the library
 template void Scene::registerComponent<Name>();
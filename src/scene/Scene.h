@@ -2,15 +2,45 @@
 
 #include "components/EntityManager.h"
 #include "components/ComponentManager.h"
+#include "components/View.h"
+#include "CommandBuffer.h"
+#include "EventBus.h"
+#include "Resources.h"
+#include "SpatialIndex.h"
 #include "systems/System.h"
 #include "systems/SystemManager.h"
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
 class Renderer;
 class ProceduralMap;
 
+// A copy of a scene's entities, components and resources, taken with
+// Scene::snapshot() and put back with Scene::restore(). Systems are not part
+// of it, and the procedural map is shared rather than copied. Taking repeated
+// snapshots into the same object reuses its storage.
+class SceneSnapshot {
+public:
+    SceneSnapshot()
+        : m_components(std::make_unique<ComponentManager>()),
+          m_entities(std::make_unique<EntityManager>()) {}
+    
+    uint32_t getEntityCount() const { return m_entities->getLivingEntityCount(); }
+    
+private:
+    friend class Scene;
+    
+    std::unique_ptr<ComponentManager> m_components;
+    std::unique_ptr<EntityManager> m_entities;
+    ResourceMap m_resources;
+    std::shared_ptr<ProceduralMap> m_proceduralMap;
+};
+
 class Scene {
 public:
     Scene();
@@ -19,31 +49,67 @@ public:
     // Entity management
     EntityID createEntity();
     void destroyEntity(EntityID entity);
+    bool isAlive(EntityID entity) const { return m_entityManager->isAlive(entity); }
     
-    // Component management
+    // Component management. Tag types (see Tag) are added, removed and tested
+    // like components but only change the signature.
     template<typename T>
     void registerComponent() {
         m_componentManager->registerComponent<T>();
     }    template<typename T>
     void addComponent(EntityID entity, const T& component) {
+        auto signature = m_entityManager->getSignature(entity); // Throws for dead/stale handles
         m_componentManager->addComponent<T>(entity, T(component));
         
-        auto signature = m_entityManager->getSignature(entity);
-        signature.set(m_componentManager->getComponentType<T>(), true);
+        const ComponentType type = m_componentManager->getComponentType<T>();
+        signature.set(type, true);
         m_entityManager->setSignature(entity, signature);
         
-        systemManager->entitySignatureChanged(entity, signature);
+        systemManager->entityComponentChanged(entity, type, signature);
     }
     
     template<typename T>
     void removeComponent(EntityID entity) {
+        auto signature = m_entityManager->getSignature(entity); // Throws for dead/stale handles
         m_componentManager->removeComponent<T>(entity);
         
-        auto signature = m_entityManager->getSignature(entity);
-        signature.set(m_componentManager->getComponentType<T>(), false);
+        const ComponentType type = m_componentManager->getComponentType<T>();
+        signature.set(type, false);
         m_entityManager->setSignature(entity, signature);
         
-        systemManager->entitySignatureChanged(entity, signature);
+        systemManager->entityComponentChanged(entity, type, signature);
+    }
+    
+    // Bulk spawning: creates count entities, each with a copy of every
+    // prototype. Pool space is reserved once, the shared signature is computed
+    // once and system membership is updated in one pass per affected system.
+    //   auto bullets = scene.createEntities(1000, Transform(), RigidBody(), Sprite());
+    template<typename... Ts>
+    std::vector<EntityID> createEntities(size_t count, const Ts&... prototype) {
+        std::vector<EntityID> entities = m_entityManager->createEntities(count);
+        if constexpr (sizeof...(Ts) > 0) {
+            addComponents(entities, prototype...);
+        }
+        return entities;
+    }
+    
+    // Batch addComponent: gives every entity a copy of each prototype
+    template<typename... Ts>
+    void addComponents(const std::vector<EntityID>& entities, const Ts&... prototype) {
+        static_assert(sizeof...(Ts) > 0, "addComponents needs at least one component");
+        for (EntityID entity : entities) {
+            m_entityManager->getSignature(entity); // Throws for dead/stale handles
+        }
+        m_componentManager->addComponents(entities.data(), entities.size(), prototype...);
+        
+        ComponentMask added;
+        (added.set(m_componentManager->getComponentType<Ts>()), ...);
+        for (EntityID entity : entities) {
+            m_entityManager->setSignature(entity, m_entityManager->getSignature(entity) | added);
+        }
+        systemManager->entitiesComponentsChanged(entities, added, [&](size_t i) -> const ComponentMask& {
+            return m_entityManager->getSignature(entities[i]);
+        });
     }
     
     template<typename T>
@@ -51,19 +117,25 @@ public:
         return m_componentManager->getComponent<T>(entity);
     }
     
+    // Read-only access; unlike the non-const overload it is not recorded as a write
     template<typename T>
     const T& getComponent(EntityID entity) const {
-        return m_componentManager->getComponent<T>(entity);
+        const ComponentManager& components = *m_componentManager;
+        return components.getComponent<T>(entity);
     }
     
     template<typename T>
     bool hasComponent(EntityID entity) {
-        return m_componentManager->hasComponent<T>(entity);
+        return static_cast<const Scene&>(*this).hasComponent<T>(entity);
     }
     
     template<typename T>
     bool hasComponent(EntityID entity) const {
-        return m_componentManager->hasComponent<T>(entity);
+        if constexpr (is_tag_v<T>) {
+            return m_entityManager->getSignature(entity).test(m_componentManager->getComponentType<T>());
+        } else {
+            return m_componentManager->hasComponent<T>(entity);
+        }
     }
     
     template<typename T>
@@ -71,6 +143,105 @@ public:
         return m_componentManager->getComponentType<T>();
     }
     
+    template<typename T>
+    bool isComponentRegistered() const {
+        return m_componentManager->isRegistered<T>();
+    }
+    
+    // Scene resources (see ResourceMap). getResource() throws if the scene has
+    // no T; tryGetResource() returns nullptr instead. Systems running in
+    // parallel must declare reads<T>()/writes<T>() and insert or remove
+    // resources through the command buffer.
+    template<typename T>
+    void setResource(T resource) {
+        m_resources.set<std::decay_t<T>>(std::move(resource));
+    }
+    
+    template<typename T>
+    T& getResource() { return m_resources.get<T>(); }
+    
+    template<typename T>
+    const T& getResource() const { return m_resources.get<T>(); }
+    
+    template<typename T>
+    T* tryGetResource() { return m_resources.find<T>(); }
+    
+    template<typename T>
+    const T* tryGetResource() const { return m_resources.find<T>(); }
+    
+    template<typename T>
+    bool hasResource() const { return m_resources.contains<T>(); }
+    
+    template<typename T>
+    void removeResource() { m_resources.remove<T>(); }
+    
+    // Typed events (see EventBus). publishEvent() is safe from any thread;
+    // getEvents() returns the events published during the previous frame.
+    template<typename T>
+    void registerEvent() { m_events.registerEvent<T>(); }
+    
+    template<typename T>
+    void publishEvent(T event) { m_events.publish<std::decay_t<T>>(std::move(event)); }
+    
+    template<typename T>
+    void publishEvents(const std::vector<T>& events) { m_events.publishBatch<T>(events); }
+    
+    template<typename T>
+    const std::vector<T>& getEvents() const { return m_events.read<T>(); }
+    
+    // Iterate every entity with all of Ts, e.g.
+    //   scene.view<Transform, const RigidBody>().exclude<Sprite>().each(
+    //       [](EntityID entity, Transform& transform, const RigidBody& body) { ... });
+    template<typename... Ts>
+    View<Ts...> view() {
+        return View<Ts...>(*m_componentManager, *m_entityManager);
+    }
+    
+    // Change detection (see ComponentManager). A consumer remembers a tick and
+    // later asks what changed after it:
+    //   const ChangeTick since = m_lastTick;
+    //   m_lastTick = scene.advanceChangeTick();
+    //   scene.view<const Transform>().changed<Transform>(since).each(...);
+    // Removal records are kept until the end of the frame after the one they
+    // were made in, so forEachRemoved() must be polled at least once per frame.
+    ChangeTick getChangeTick() const { return m_componentManager->getChangeTick(); }
+    ChangeTick advanceChangeTick() { return m_componentManager->advanceChangeTick(); }
+    
+    template<typename T>
+    void markChanged(EntityID entity) {
+        m_componentManager->markChanged<T>(entity);
+    }
+    
+    template<typename T>
+    ChangeTick getLastAddedTick() const {
+        return m_componentManager->getLastAddedTick(m_componentManager->getComponentType<T>());
+    }
+    
+    template<typename T>
+    ChangeTick getLastChangedTick() const {
+        return m_componentManager->getLastChangedTick(m_componentManager->getComponentType<T>());
+    }
+    
+    template<typename T>
+    ChangeTick getLastRemovedTick() const {
+        return m_componentManager->getLastRemovedTick(m_componentManager->getComponentType<T>());
+    }
+    
+    template<typename T, typename Func>
+    void forEachRemoved(ChangeTick since, Func&& func) const {
+        m_componentManager->forEachRemoved<T>(since, std::forward<Func>(func));
+    }
+    
+    // Storage layout (see StorageMode). Must be chosen before components are added.
+    void setStorageMode(StorageMode mode) { m_componentManager->setStorageMode(mode); }
+    StorageMode getStorageMode() const { return m_componentManager->getStorageMode(); }
+    
+    // Archetype mode only: func(count, entities, Ts*...) once per matching chunk
+    template<typename... Ts, typename Func>
+    void forEachChunk(Func&& func) {
+        m_componentManager->forEachChunk<Ts...>(std::forward<Func>(func));
+    }
+    
     // System management
     template<typename T>
     std::shared_ptr<T> registerSystem() {
@@ -81,20 +252,92 @@ public:
     void setSystemSignature(ComponentMask signature) {
         systemManager->setSignature<T>(signature);
     }
+    
+    // Deferred structural changes. Systems must not create/destroy entities or
+    // add/remove components directly during update() - they record into the
+    // calling thread's buffer instead, which is played back at the next sync
+    // point (before and after the system updates in Scene::update).
+    CommandBuffer& getCommandBuffer();
+    void playbackCommands();
+    
+    // Parallel by default; Serial runs the same schedule on the calling thread
+    void setSystemExecutionMode(SystemExecutionMode mode) { systemManager->setExecutionMode(mode); }
+    SystemExecutionMode getSystemExecutionMode() const { return systemManager->getExecutionMode(); }
+    
+    // Whole-scene copies for play-in-editor and rollback. Entity IDs are kept,
+    // components of trivially copyable types are copied a chunk at a time,
+    // and restored components count as newly added for change detection.
+    // System membership is rebuilt; commands not yet played back are
+    // discarded. Must not be called while systems are updating.
+    SceneSnapshot snapshot() const;
+    void snapshot(SceneSnapshot& into) const; // Reuses into's storage
+    void restore(const SceneSnapshot& snapshot);
+    
+    // Makes this scene's entities, components and resources a copy of
+    // source's; registered systems stay this scene's own
+    void copyFrom(const Scene& source);
       // Scene lifecycle
     virtual void initialize();
     virtual void update(float deltaTime);
     virtual void render(Renderer* renderer);
     virtual void cleanup();
     
-    // Entity queries
-    std::vector<EntityID> getEntitiesWithComponents(ComponentMask signature);
+    // Renders a frame that lies alpha (0..1) of the way from the state before
+    // the latest update() to the state after it; Engine::run passes the
+    // fixed-step remainder. Plain render() draws the latest state.
+    // Entities with a PreviousTransform are interpolated; update() gives one
+    // to every RigidBody entity that lacks it.
+    void render(Renderer* renderer, float alpha);
+    float getInterpolationAlpha() const { return m_interpolationAlpha; }
+    
+    // Spatial queries over every entity with a Transform and a Collider,
+    // against its collider bounds (see SpatialIndex). The index follows the
+    // change ticks and is refreshed when update() starts and ends, so systems
+    // see colliders where they were when the frame started; code that moves
+    // colliders outside update() and queries straight away calls
+    // refreshSpatialIndex() first. None of the queries allocate.
+    //   scene.queryRadius(position, 200.0f, [&](EntityID entity, const Rect& bounds) { ... }, enemies);
+    void refreshSpatialIndex();
+    const SpatialIndex& getSpatialIndex() const { return m_spatialIndex; }
+    
+    // func(entity, bounds) for every collider overlapping area / within
+    // radius of center; func may return false to stop
+    template<typename Func>
+    void queryAABB(const Rect& area, Func&& func, const SpatialFilter& filter = SpatialFilter()) const {
+        m_spatialIndex.queryAABB(area, spatialAccept(filter), std::forward<Func>(func));
+    }
+    
+    template<typename Func>
+    void queryRadius(const Vector2& center, float radius, Func&& func, const SpatialFilter& filter = SpatialFilter()) const {
+        m_spatialIndex.queryRadius(center, radius, spatialAccept(filter), std::forward<Func>(func));
+    }
+    
+    // Nearest collider along the ray; false if none within maxDistance
+    bool raycast(const Vector2& origin, const Vector2& direction, float maxDistance, RaycastHit& hit,
+                 const SpatialFilter& filter = SpatialFilter()) const {
+        return m_spatialIndex.raycast(origin, direction, maxDistance, spatialAccept(filter), hit);
+    }
+    
+    // Replaces results with the k colliders nearest to point, nearest first;
+    // reuse results across calls to keep its storage
+    void nearest(const Vector2& point, size_t k, std::vector<NearestHit>& results,
+                 const SpatialFilter& filter = SpatialFilter(),
+                 float maxDistance = std::numeric_limits<float>::max()) const {
+        m_spatialIndex.nearest(point, k, spatialAccept(filter), results, maxDistance);
+    }
+    
+    // Entity queries (allocates - prefer view<Ts...>() in per-frame code)
+    std::vector<EntityID> getEntitiesWithComponents(ComponentMask signature) const;
     
     // Entity naming utilities
     void setEntityName(EntityID entity, const std::string& name);
     std::string getEntityName(EntityID entity) const;
     std::vector<EntityID> getAllLivingEntities() const;
     
+    // Memory diagnostics
+    std::vector<ComponentPoolStats> getComponentMemoryReport() const;
+    size_t getEntityMemoryUsage() const;
+    
     // Procedural map support
     void setProceduralMap(std::shared_ptr<ProceduralMap> map);
     std::shared_ptr<ProceduralMap> getProceduralMap() const { return m_proceduralMap; }
@@ -106,5 +349,50 @@ protected:
     std::unique_ptr<SystemManager> systemManager;
     
 private:
+    // Signature of an entity touched during playback, before and after the batch
+    struct PlaybackEntry {
+        EntityID entity;
+        ComponentMask before;
+        ComponentMask after;
+        bool destroyed;
+    };
+    
+    void playback(CommandBuffer& buffer);
+    PlaybackEntry& touchForPlayback(EntityID entity);
+    void flushPlaybackSignatures();
+    void discardPendingCommands();
+    void storePreviousTransforms(ChangeTick since);
+    
+    // Entities destroyed since the last refresh are still indexed, so liveness
+    // is checked along with the filter
+    struct SpatialAccept {
+        const EntityManager& entities;
+        const SpatialFilter& filter;
+        
+        bool operator()(EntityID entity) const {
+            if (!entities.isAlive(entity)) return false;
+            const ComponentMask& signature = entities.getSignature(entity);
+            return (signature & filter.with) == filter.with && (signature & filter.without).none();
+        }
+    };
+    SpatialAccept spatialAccept(const SpatialFilter& filter) const { return {*m_entityManager, filter}; }
+    
+    void copyState(const ComponentManager& components, const EntityManager& entities,
+                   const ResourceMap& resources, std::shared_ptr<ProceduralMap> proceduralMap);
+    
     std::shared_ptr<ProceduralMap> m_proceduralMap;
+    ResourceMap m_resources;
+    EventBus m_events;
+    
+    ChangeTick m_removedPruneTick = 0;
+    SpatialIndex m_spatialIndex;
+    ChangeTick m_spatialTick = 0;
+    float m_interpolationAlpha = 1.0f;
+    std::vector<std::pair<EntityID, PreviousTransform>> m_untrackedBodies; // RigidBody entities given a PreviousTransform this frame
+    
+    const uint64_t m_serial; // Distinguishes scenes in the per-thread buffer cache
+    std::mutex m_commandBuffersMutex;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<CommandBuffer>>> m_commandBuffers;
+    std::vector<PlaybackEntry> m_playbackEntries;
+    std::unordered_map<EntityID, size_t> m_playbackIndex;
 };
@@ -0,0 +1,86 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+
+void SpatialIndex::update(EntityID entity, const Rect& bounds) {
+    const uint32_t slot = Entity::index(entity);
+    if (slot >= m_entries.size()) {
+        m_entries.resize(slot + 1);
+    }
+
+    Entry& entry = m_entries[slot];
+    if (entry.proxy != AABBTree::NULL_NODE && entry.entity != entity) {
+        m_tree.destroyProxy(entry.proxy); // The slot's previous, destroyed entity
+        entry.proxy = AABBTree::NULL_NODE;
+    }
+
+    if (entry.proxy == AABBTree::NULL_NODE) {
+        entry.proxy = m_tree.createProxy(bounds, slot);
+    } else {
+        const Vector2 displacement(bounds.x - entry.bounds.x, bounds.y - entry.bounds.y);
+        m_tree.moveProxy(entry.proxy, bounds, displacement);
+    }
+    entry.entity = entity;
+    entry.bounds = bounds;
+}
+
+void SpatialIndex::remove(EntityID entity) {
+    if (!contains(entity)) return;
+    Entry& entry = m_entries[Entity::index(entity)];
+    m_tree.destroyProxy(entry.proxy);
+    entry = Entry();
+}
+
+void SpatialIndex::clear() {
+    m_tree.clear();
+    m_entries.clear();
+}
+
+bool SpatialIndex::contains(EntityID entity) const {
+    const uint32_t slot = Entity::index(entity);
+    return slot < m_entries.size() && m_entries[slot].entity == entity && m_entries[slot].proxy != AABBTree::NULL_NODE;
+}
+
+float SpatialIndex::distanceSquared(const Vector2& point, const Rect& bounds) {
+    const float dx = std::max(std::max(bounds.x - point.x, point.x - (bounds.x + bounds.width)), 0.0f);
+    const float dy = std::max(std::max(bounds.y - point.y, point.y - (bounds.y + bounds.height)), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+bool SpatialIndex::normalize(const Vector2& direction, Vector2& unit) {
+    const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+    if (!(length > 0.0f)) return false;
+    unit = Vector2(direction.x / length, direction.y / length);
+    return true;
+}
+
+bool SpatialIndex::intersectRay(const Vector2& origin, const Vector2& direction, float maxDistance,
+                                const Rect& bounds, float& distance, Vector2& normal) {
+    float enter = 0.0f;
+    float exit = maxDistance;
+    normal = Vector2();
+    const float origins[2] = {origin.x, origin.y};
+    const float directions[2] = {direction.x, direction.y};
+    const float mins[2] = {bounds.x, bounds.y};
+    const float maxs[2] = {bounds.x + bounds.width, bounds.y + bounds.height};
+    for (int axis = 0; axis < 2; ++axis) {
+        if (directions[axis] == 0.0f) {
+            if (origins[axis] < mins[axis] || origins[axis] > maxs[axis]) return false;
+            continue;
+        }
+        const float inverse = 1.0f / directions[axis];
+        float near = (mins[axis] - origins[axis]) * inverse;
+        float far = (maxs[axis] - origins[axis]) * inverse;
+        if (near > far) std::swap(near, far);
+        if (near > enter) {
+            // The face the ray crosses into faces against it
+            enter = near;
+            const float facing = directions[axis] > 0.0f ? -1.0f : 1.0f;
+            normal = axis == 0 ? Vector2(facing, 0.0f) : Vector2(0.0f, facing);
+        }
+        exit = std::min(exit, far);
+        if (enter > exit) return false;
+    }
+    distance = enter;
+    return true;
+}
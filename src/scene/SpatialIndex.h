@@ -0,0 +1,161 @@
+#pragma once
+
+#include "components/Components.h"
+#include "physics/AABBTree.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+// Restricts a spatial query to entities whose signature has every component
+// (or tag) in with and none in without
+struct SpatialFilter {
+    ComponentMask with;
+    ComponentMask without;
+};
+
+struct RaycastHit {
+    EntityID entity = Entity::Null;
+    float distance = 0.0f; // From the origin, in world units
+    Vector2 point;
+    Vector2 normal;        // Of the face hit; zero if the ray starts inside
+};
+
+struct NearestHit {
+    EntityID entity;
+    float distance; // From the point to the bounds; zero inside them
+};
+
+// Entity bounds in an AABBTree, answering area, radius, ray and
+// nearest-neighbour queries. Scene keeps one over its colliders (see
+// Scene::queryAABB()), but it works over any boxes keyed by entity.
+//
+// Entries are stored by entity slot and keep their exact bounds next to the
+// tree's fat box, so results are exact and an entry that moves only touches
+// the tree once it leaves its fat box. Every query takes an accept(entity)
+// predicate, checked before the exact test, and none of them allocates
+// (nearest() once results has grown to k).
+class SpatialIndex {
+public:
+    explicit SpatialIndex(float margin = 8.0f) : m_tree(margin) {}
+
+    // Inserts or moves entity's entry, replacing a stale entity that held its slot
+    void update(EntityID entity, const Rect& bounds);
+    void remove(EntityID entity);
+    void clear();
+
+    bool contains(EntityID entity) const;
+    size_t size() const { return m_tree.getProxyCount(); }
+
+    // func(entity, bounds) for every accepted entry overlapping area (edges
+    // included); func may return false to stop
+    template<typename Accept, typename Func>
+    void queryAABB(const Rect& area, Accept&& accept, Func&& func) const {
+        m_tree.query(area, [&](uint32_t slot) {
+            const Entry& entry = m_entries[slot];
+            if (!overlaps(entry.bounds, area) || !accept(entry.entity)) return true;
+            return invoke(func, entry);
+        });
+    }
+
+    // func(entity, bounds) for every accepted entry within radius of center
+    template<typename Accept, typename Func>
+    void queryRadius(const Vector2& center, float radius, Accept&& accept, Func&& func) const {
+        const float radiusSquared = radius * radius;
+        m_tree.query(Rect(center.x - radius, center.y - radius, 2.0f * radius, 2.0f * radius), [&](uint32_t slot) {
+            const Entry& entry = m_entries[slot];
+            if (distanceSquared(center, entry.bounds) > radiusSquared || !accept(entry.entity)) return true;
+            return invoke(func, entry);
+        });
+    }
+
+    // Nearest accepted entry the ray from origin along direction (any
+    // length) hits within maxDistance; false if none or direction is zero
+    template<typename Accept>
+    bool raycast(const Vector2& origin, const Vector2& direction, float maxDistance, Accept&& accept,
+                 RaycastHit& hit) const {
+        Vector2 unit;
+        if (!normalize(direction, unit)) return false;
+
+        bool found = false;
+        float best = maxDistance;
+        m_tree.raycast(origin, unit, maxDistance, [&](uint32_t slot) {
+            const Entry& entry = m_entries[slot];
+            float distance;
+            Vector2 normal;
+            if (intersectRay(origin, unit, best, entry.bounds, distance, normal) && accept(entry.entity)) {
+                found = true;
+                best = distance;
+                hit.entity = entry.entity;
+                hit.distance = distance;
+                hit.point = Vector2(origin.x + unit.x * distance, origin.y + unit.y * distance);
+                hit.normal = normal;
+            }
+            return best;
+        });
+        return found;
+    }
+
+    // Replaces results with the (up to) k accepted entries nearest to point
+    // and within maxDistance, nearest first
+    template<typename Accept>
+    void nearest(const Vector2& point, size_t k, Accept&& accept, std::vector<NearestHit>& results,
+                 float maxDistance = std::numeric_limits<float>::max()) const {
+        results.clear();
+        if (k == 0) return;
+
+        // Squared distances until the search is done
+        const float limit = maxDistance < std::numeric_limits<float>::max() ? maxDistance * maxDistance
+                                                                             : std::numeric_limits<float>::max();
+        float bound = limit;
+        m_tree.queryNearest(point, limit, [&](uint32_t slot) {
+            const Entry& entry = m_entries[slot];
+            const float distance = distanceSquared(point, entry.bounds);
+            if (distance > bound || (results.size() == k && distance >= bound) || !accept(entry.entity)) return bound;
+
+            size_t position = results.size();
+            while (position > 0 && results[position - 1].distance > distance) --position;
+            if (results.size() == k) {
+                results.pop_back(); // Always after position, since distance < bound
+            }
+            results.insert(results.begin() + position, NearestHit{entry.entity, distance});
+            if (results.size() == k) {
+                bound = results.back().distance;
+            }
+            return bound;
+        });
+        for (NearestHit& result : results) {
+            result.distance = std::sqrt(result.distance);
+        }
+    }
+
+private:
+    struct Entry {
+        EntityID entity = Entity::Null;
+        int32_t proxy = AABBTree::NULL_NODE;
+        Rect bounds;
+    };
+
+    template<typename Func>
+    static bool invoke(Func& func, const Entry& entry) {
+        if constexpr (std::is_void_v<std::invoke_result_t<Func&, EntityID, const Rect&>>) {
+            func(entry.entity, entry.bounds);
+            return true;
+        } else {
+            return func(entry.entity, entry.bounds);
+        }
+    }
+
+    static bool overlaps(const Rect& a, const Rect& b) {
+        return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+    }
+    static float distanceSquared(const Vector2& point, const Rect& bounds);
+    static bool normalize(const Vector2& direction, Vector2& unit);
+    // Slab test against the exact bounds; distance is where the ray enters
+    static bool intersectRay(const Vector2& origin, const Vector2& direction, float maxDistance,
+                             const Rect& bounds, float& distance, Vector2& normal);
+
+    AABBTree m_tree; // Proxy ids are entity slots
+    std::vector<Entry> m_entries; // By entity slot
+};
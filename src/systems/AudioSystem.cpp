@@ -53,21 +53,29 @@ void AudioSystem::shutdown() {
 void AudioSystem::update(float deltaTime) {
     if (!m_scene || !s_audioInitialized) return;
     
-    // Update audio sources
-    for (const auto& entity : entities) {
-        auto& audioSource = m_scene->getComponent<AudioSource>(entity);
-        auto& transform = m_scene->getComponent<Transform>(entity);
-        
-        // Handle play on start
-        if (audioSource.playOnStart && !audioSource.isPlaying && !audioSource.audioFile.empty()) {
-            playSound(audioSource, entity);
-        }
-        
-        // Update 3D audio positioning if enabled
-        if (audioSource.is3D && audioSource.isPlaying) {
-            update3DAudio(audioSource, transform, entity);
+    // Drop channel bindings of destroyed entities so a recycled slot does not
+    // inherit the previous owner's channel
+    for (auto it = m_entityChannels.begin(); it != m_entityChannels.end();) {
+        if (!m_scene->isAlive(it->first)) {
+            it = m_entityChannels.erase(it);
+        } else {
+            ++it;
         }
     }
+    
+    // Update audio sources
+    m_scene->view<AudioSource, const Transform>().each(
+        [this](EntityID entity, AudioSource& audioSource, const Transform& transform) {
+            // Handle play on start
+            if (audioSource.playOnStart && !audioSource.isPlaying && !audioSource.audioFile.empty()) {
+                playSound(audioSource, entity);
+            }
+            
+            // Update 3D audio positioning if enabled
+            if (audioSource.is3D && audioSource.isPlaying) {
+                update3DAudio(audioSource, transform, entity);
+            }
+        });
 }
 
 void AudioSystem::playSound(AudioSource& audioSource, EntityID entity) {
@@ -235,7 +243,8 @@ void AudioSystem::update3DAudio(AudioSource& audioSource, const Transform& trans
     int channel = it->second;
     
     // Calculate distance from listener (assuming listener is at origin for simplicity)
-    Vector2 listenerPos = m_listenerPosition;
+    const AudioListenerPosition* listener = m_scene->tryGetResource<AudioListenerPosition>();
+    Vector2 listenerPos = listener ? listener->position : Vector2(0, 0);
     float distance = std::sqrt(std::pow(transform.position.x - listenerPos.x, 2) + 
                               std::pow(transform.position.y - listenerPos.y, 2));
     
@@ -267,9 +276,10 @@ void AudioSystem::update3DAudio(AudioSource& audioSource, const Transform& trans
 }
 
 void AudioSystem::setListenerPosition(const Vector2& position) {
-    m_listenerPosition = position;
+    if (!m_scene) return;
+    m_scene->setResource(AudioListenerPosition{position});
 }
 
 void AudioSystem::setListenerPosition(float x, float y) {
-    m_listenerPosition = {x, y};
+    setListenerPosition(Vector2(x, y));
 }
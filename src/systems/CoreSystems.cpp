@@ -1,35 +1,29 @@
 #include "CoreSystems.h"
 #include "scene/Scene.h"
+#include "core/Engine.h"
+#include "core/JobSystem.h"
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
 
 // RenderSystem Implementation
 void RenderSystem::render(Renderer* renderer) {
-    // Create a vector of entities with sprites for sorting
-    std::vector<EntityID> renderableEntities;
-    
-    for (auto entity : entities) {
-        if (m_scene->hasComponent<Sprite>(entity)) {
-            auto& sprite = m_scene->getComponent<Sprite>(entity);
-            if (sprite.visible) {
-                renderableEntities.push_back(entity);
-            }
-        }
+    if (drawOrderIsStale()) {
+        rebuildDrawOrder();
     }
     
-    // Sort by layer (lower layers rendered first)
-    std::sort(renderableEntities.begin(), renderableEntities.end(), 
-        [this](EntityID a, EntityID b) {
-            auto& spriteA = m_scene->getComponent<Sprite>(a);
-            auto& spriteB = m_scene->getComponent<Sprite>(b);
-            return spriteA.layer < spriteB.layer;
-        });
-    
-    // Render all sprites
-    for (auto entity : renderableEntities) {
-        auto& transform = m_scene->getComponent<Transform>(entity);
-        auto& sprite = m_scene->getComponent<Sprite>(entity);
+    // Read-only lookups, so drawing does not count as a write
+    const Scene& scene = *m_scene;
+    const float alpha = scene.getInterpolationAlpha();
+    const bool interpolate = alpha < 1.0f && scene.isComponentRegistered<PreviousTransform>();
+    for (const EntityID entity : m_drawOrder) {
+        Transform transform = scene.getComponent<Transform>(entity);
+        const auto& sprite = scene.getComponent<Sprite>(entity);
+        if (interpolate && scene.hasComponent<PreviousTransform>(entity)) {
+            transform = interpolateTransform(scene.getComponent<PreviousTransform>(entity), transform, alpha);
+        }
           if (sprite.texture) {
             Rect dstRect(
                 transform.position.x, 
@@ -57,99 +51,739 @@ void RenderSystem::render(Renderer* renderer) {
     }
 }
 
+Transform RenderSystem::interpolateTransform(const PreviousTransform& previous, const Transform& current, float alpha) {
+    auto lerp = [alpha](float from, float to) { return from + (to - from) * alpha; };
+    Transform result = current;
+    result.position = Vector2(lerp(previous.position.x, current.position.x), lerp(previous.position.y, current.position.y));
+    result.scale = Vector2(lerp(previous.scale.x, current.scale.x), lerp(previous.scale.y, current.scale.y));
+    result.rotation = lerp(previous.rotation, current.rotation);
+    return result;
+}
+
+bool RenderSystem::drawOrderIsStale() const {
+    // The order depends on which entities have both components and on the
+    // sprites' layer/visibility; moving a Transform does not affect it
+    return !m_drawOrderBuilt ||
+           m_scene->getLastAddedTick<Transform>() > m_drawOrderTick ||
+           m_scene->getLastRemovedTick<Transform>() > m_drawOrderTick ||
+           m_scene->getLastChangedTick<Sprite>() > m_drawOrderTick ||
+           m_scene->getLastRemovedTick<Sprite>() > m_drawOrderTick;
+}
+
+void RenderSystem::rebuildDrawOrder() {
+    m_drawOrderTick = m_scene->advanceChangeTick();
+    m_drawOrderBuilt = true;
+    
+    // Collect visible sprites for sorting (the list is reused between rebuilds)
+    m_drawList.clear();
+    m_scene->view<const Transform, const Sprite>().each(
+        [this](EntityID entity, const Transform&, const Sprite& sprite) {
+            if (sprite.visible) {
+                m_drawList.push_back({entity, sprite.layer});
+            }
+        });
+    
+    // Sort by layer (lower layers rendered first), ties by entity for a stable order
+    std::sort(m_drawList.begin(), m_drawList.end(), 
+        [](const DrawItem& a, const DrawItem& b) {
+            if (a.layer != b.layer) return a.layer < b.layer;
+            return a.entity < b.entity;
+        });
+    
+    m_drawOrder.clear();
+    for (const auto& item : m_drawList) {
+        m_drawOrder.push_back(item.entity);
+    }
+}
+
 // PhysicsSystem Implementation
-void PhysicsSystem::update(float deltaTime) {
-    for (auto entity : entities) {
-        auto& transform = m_scene->getComponent<Transform>(entity);
-        auto& rigidBody = m_scene->getComponent<RigidBody>(entity);
+namespace {
+    // One job's bodies copied out of their components into SoA streams, so
+    // BodyIntegrator can run over them with vector loads
+    struct BodyBatch {
+        static constexpr size_t CAPACITY = 256;
+        
+        alignas(32) float positionX[CAPACITY];
+        alignas(32) float positionY[CAPACITY];
+        alignas(32) float velocityX[CAPACITY];
+        alignas(32) float velocityY[CAPACITY];
+        alignas(32) float accelerationX[CAPACITY];
+        alignas(32) float accelerationY[CAPACITY];
+        alignas(32) float drag[CAPACITY];
+        alignas(32) uint32_t gravityMask[CAPACITY];
+        Transform* transforms[CAPACITY];
+        RigidBody* rigidBodies[CAPACITY];
+        size_t count = 0;
         
-        // Apply gravity
-        if (rigidBody.useGravity) {
-            rigidBody.acceleration.y += GRAVITY * deltaTime;
+        void add(Transform& transform, RigidBody& rigidBody) {
+            positionX[count] = transform.position.x;
+            positionY[count] = transform.position.y;
+            velocityX[count] = rigidBody.velocity.x;
+            velocityY[count] = rigidBody.velocity.y;
+            accelerationX[count] = rigidBody.acceleration.x;
+            accelerationY[count] = rigidBody.acceleration.y;
+            drag[count] = rigidBody.drag;
+            gravityMask[count] = rigidBody.useGravity ? ~0u : 0u;
+            transforms[count] = &transform;
+            rigidBodies[count] = &rigidBody;
+            ++count;
         }
         
-        // Update velocity with acceleration
-        rigidBody.velocity = rigidBody.velocity + (rigidBody.acceleration * deltaTime);
+        void flush(const BodyIntegrator& integrator, float deltaTime, float gravity) {
+            BodyIntegrator::Streams streams;
+            streams.positionX = positionX;
+            streams.positionY = positionY;
+            streams.velocityX = velocityX;
+            streams.velocityY = velocityY;
+            streams.accelerationX = accelerationX;
+            streams.accelerationY = accelerationY;
+            streams.drag = drag;
+            streams.gravityMask = gravityMask;
+            streams.count = count;
+            integrator.integrate(streams, deltaTime, gravity);
+            
+            for (size_t i = 0; i < count; ++i) {
+                transforms[i]->position = Vector2(positionX[i], positionY[i]);
+                rigidBodies[i]->velocity = Vector2(velocityX[i], velocityY[i]);
+                rigidBodies[i]->acceleration = Vector2(accelerationX[i], accelerationY[i]);
+            }
+            count = 0;
+        }
+    };
+}
+
+void PhysicsSystem::update(float deltaTime) {
+    // Bodies integrate independently, so ranges of the view run on the job system.
+    // Each range is copied into streams a batch at a time and written back after the step.
+    auto bodies = m_scene->view<Transform, RigidBody>().exclude<Static, Sleeping>();
+    Engine::getInstance().getJobSystem().parallel_for(size_t(0), bodies.workSize(), INTEGRATION_GRAIN_SIZE,
+        [this, &bodies, deltaTime](size_t begin, size_t end) {
+            BodyBatch batch;
+            bodies.eachInRange(begin, end, [&](EntityID, Transform& transform, RigidBody& rigidBody) {
+                batch.add(transform, rigidBody);
+                if (batch.count == BodyBatch::CAPACITY) {
+                    batch.flush(m_integrator, deltaTime, GRAVITY);
+                }
+            });
+            batch.flush(m_integrator, deltaTime, GRAVITY);
+        });
+}
+
+// CollisionSystem Implementation
+namespace {
+    Rect inflate(const Rect& bounds, float margin) {
+        return Rect(bounds.x - margin, bounds.y - margin, bounds.width + 2.0f * margin, bounds.height + 2.0f * margin);
+    }
+}
+
+void CollisionSystem::update(float deltaTime) {
+    m_sleepStats.fellAsleep = 0;
+    m_sleepStats.wokeUp = 0;
+    
+    // Last update's Sleeping removals have played back
+    for (EntityID entity : m_wokenBodies) {
+        SleepRecord& record = m_sleepRecords[Entity::index(entity)];
+        if (record.entity == entity && record.island == WAKING) {
+            record.entity = Entity::Null;
+        }
+    }
+    m_wokenBodies.clear();
+    
+    // A matrix edit can end contacts that are kept untested
+    const CollisionMatrix* matrix = static_cast<const Scene&>(*m_scene).tryGetResource<CollisionMatrix>();
+    const CollisionMatrix current = matrix ? *matrix : CollisionMatrix();
+    const bool matrixChanged = current != m_matrix;
+    m_matrix = current;
+    
+    wakeTouchedSleepers();
+    resolveTilemaps(deltaTime);
+    
+    // Reading through const views keeps unchanged components unstamped
+    ++m_contactFrame;
+    m_colliders.clear();
+    m_scene->view<const Transform, const Collider>().exclude<Sleeping>().each(
+        [this](EntityID entity, const Transform& transform, const Collider& collider) {
+            if (collider.isStatic) return;
+            m_colliders.push_back({entity, &transform, &collider});
+            if (isParked(entity)) {
+                m_parkedDirty = true; // Sleeping was removed by other code
+            }
+            
+            const uint32_t slot = Entity::index(entity);
+            if (slot >= m_movingStamps.size()) {
+                m_movingStamps.resize(slot + 1);
+            }
+            m_movingStamps[slot] = {entity, m_contactFrame};
+        });
+    
+    const bool staticsRebuilt = staticCollidersChanged();
+    if (staticsRebuilt) {
+        rebuildStaticColliders();
+    }
+    
+    if (m_broadphaseType == Broadphase::Grid) {
+        // Moving colliders are re-inserted every frame (the lists are reused),
+        // grown by CONTACT_MARGIN so resting neighbours are paired too
+        m_grid.clearDynamic();
+        for (uint32_t i = 0; i < m_colliders.size(); ++i) {
+            m_grid.insertDynamic(i, inflate(m_colliders[i].collider->getBounds(m_colliders[i].transform->position), CONTACT_MARGIN));
+        }
+        m_grid.findPairs(m_pairs);
+    } else {
+        findTreePairs();
+    }
+    
+    // Resolve in a fixed order, independent of the broadphase layout
+    std::sort(m_pairs.begin(), m_pairs.end(), [](const SpatialHash::Pair& a, const SpatialHash::Pair& b) {
+        if (a.a != b.a) return a.a < b.a;
+        if (a.bStatic != b.bStatic) return b.bStatic;
+        return a.b < b.b;
+    });
+    
+    m_touching.clear();
+    for (const SpatialHash::Pair& pair : m_pairs) {
+        // Bounds come from the live transforms, so earlier resolutions this
+        // frame are taken into account
+        const ColliderEntry& a = m_colliders[pair.a];
+        const uint8_t layerB = pair.bStatic ? m_staticColliders[pair.b].layer : m_colliders[pair.b].collider->layer;
+        if (!m_matrix.collides(a.collider->layer, layerB)) continue;
         
-        // Apply drag
-        rigidBody.velocity = rigidBody.velocity * rigidBody.drag;
+        const Rect boundsA = a.collider->getBounds(a.transform->position);
+        if (pair.bStatic) {
+            const StaticCollider& b = m_staticColliders[pair.b];
+            const bool trigger = a.collider->isTrigger || b.isTrigger;
+            if (checkCollision(boundsA, b.bounds) && checkMasks(boundsA, a.collider->mask.get(), b.bounds, b.mask.get())) {
+                touch(a.entity, b.entity, trigger, false);
+                if (trigger) continue;
+                resolve(a.entity, boundsA, b.entity, b.bounds, true);
+                if (b.sleeping) {
+                    m_wakeRequests.push_back(b.entity);
+                }
+            } else if (!trigger && checkCollision(inflate(boundsA, CONTACT_MARGIN), b.bounds)) {
+                touch(a.entity, b.entity, false, true);
+            }
+            continue;
+        }
         
-        // Update position with velocity
-        transform.position = transform.position + (rigidBody.velocity * deltaTime);
+        const ColliderEntry& b = m_colliders[pair.b];
+        const Rect boundsB = b.collider->getBounds(b.transform->position);
+        const bool trigger = a.collider->isTrigger || b.collider->isTrigger;
+        if (checkCollision(boundsA, boundsB) && checkMasks(boundsA, a.collider->mask.get(), boundsB, b.collider->mask.get())) {
+            touch(a.entity, b.entity, trigger, false);
+            if (trigger) continue;
+            resolve(a.entity, boundsA, b.entity, boundsB, false);
+            m_islandContacts.push_back({a.entity, b.entity});
+        } else if (!trigger && checkCollision(inflate(boundsA, CONTACT_MARGIN), boundsB)) {
+            touch(a.entity, b.entity, false, true);
+            m_islandContacts.push_back({a.entity, b.entity}); // Resting against each other
+        }
+    }
+    
+    updateContacts(staticsRebuilt || matrixChanged);
+    updateSleep(deltaTime);
+}
+
+void CollisionSystem::setBroadphase(Broadphase broadphase) {
+    if (broadphase == m_broadphaseType) return;
+    m_broadphaseType = broadphase;
+    
+    // Statics are gathered again into the new structure on the next update
+    m_staticBuilt = false;
+    m_grid.clearStatic();
+    m_grid.clearDynamic();
+    m_staticTree.clear();
+    m_dynamicTree.clear();
+    m_treeProxies.clear();
+}
+
+void CollisionSystem::setCellSize(float cellSize) {
+    m_grid.setCellSize(cellSize);
+}
+
+void CollisionSystem::setSleepSettings(const SleepSettings& settings) {
+    if (!(settings.speedThreshold >= 0.0f) || !(settings.timeToSleep >= 0.0f)) {
+        throw std::runtime_error("Sleep speed threshold and time must not be negative");
+    }
+    if (m_sleepSettings.enabled && !settings.enabled) {
+        m_wakeAll = true;
+    }
+    m_sleepSettings = settings;
+}
+
+size_t CollisionSystem::getSleepingBodyCount() const {
+    size_t count = 0;
+    m_scene->view<const RigidBody>().with<Sleeping>().each([&count](EntityID, const RigidBody&) { ++count; });
+    return count;
+}
+
+void CollisionSystem::wakeTouchedSleepers() {
+    // Sleepers written by anything but this system since its last update,
+    // e.g. a force applied or a teleport
+    m_wakeRequests.clear();
+    if (m_wakeAll) {
+        m_scene->view<const RigidBody>().with<Sleeping>().each([this](EntityID entity, const RigidBody&) {
+            m_wakeRequests.push_back(entity);
+        });
+        m_wakeAll = false;
+    } else {
+        m_scene->view<const Transform, const RigidBody>().with<Sleeping>().changed<Transform, RigidBody>(m_sleepTick).each(
+            [this](EntityID entity, const Transform&, const RigidBody&) { m_wakeRequests.push_back(entity); });
+    }
+    
+    // Tags are only changed once the views are done
+    for (EntityID entity : m_wakeRequests) {
+        wake(entity);
+    }
+    m_wakeRequests.clear();
+}
+
+void CollisionSystem::wake(EntityID entity) {
+    // The tag stays until playback, so a body already woken this update is
+    // told apart by its record
+    CommandBuffer& commands = m_scene->getCommandBuffer();
+    auto wakeBody = [this, &commands](EntityID body) {
+        if (!m_scene->isAlive(body) || !m_scene->hasComponent<Sleeping>(body)) return;
+        const uint32_t slot = Entity::index(body);
+        if (slot >= m_sleepRecords.size()) {
+            m_sleepRecords.resize(slot + 1);
+        }
+        SleepRecord& record = m_sleepRecords[slot];
+        if (record.entity == body && record.island == WAKING) return;
+        record = {body, WAKING};
+        m_wokenBodies.push_back(body);
         
-        // Reset acceleration for next frame
-        rigidBody.acceleration = Vector2(0, 0);
+        commands.removeComponent<Sleeping>(body);
+        if (m_scene->hasComponent<RigidBody>(body)) {
+            m_scene->getComponent<RigidBody>(body).sleepTime = 0.0f;
+        }
+        ++m_sleepStats.wokeUp;
+        ++m_sleepStats.totalWokeUp;
+        m_parkedDirty = true;
+    };
+    
+    const uint32_t slot = Entity::index(entity);
+    if (slot >= m_sleepRecords.size() || m_sleepRecords[slot].entity != entity || m_sleepRecords[slot].island == WAKING) {
+        wakeBody(entity); // Put to sleep by other code, restored from a snapshot, or already woken
+        return;
+    }
+    
+    const uint32_t island = m_sleepRecords[slot].island;
+    for (EntityID body : m_sleepIslands[island].bodies) {
+        SleepRecord& record = m_sleepRecords[Entity::index(body)];
+        if (record.entity == body) {
+            record.entity = Entity::Null;
+        }
+        wakeBody(body);
     }
+    m_sleepIslands[island].bodies.clear();
+    m_freeSleepIslands.push_back(island);
 }
 
-// CollisionSystem Implementation
-void CollisionSystem::update(float deltaTime) {
-    std::vector<EntityID> colliders;
+void CollisionSystem::updateSleep(float deltaTime) {
+    // Sleepers pushed into this frame; they acted as static until now
+    for (EntityID entity : m_wakeRequests) {
+        wake(entity);
+    }
+    m_wakeRequests.clear();
+    
+    // Every awake body is a node; contacts join nodes into islands
+    m_islandBodies.clear();
+    m_islandParent.clear();
+    m_islandReady.clear();
+    const float threshold = m_sleepSettings.speedThreshold;
+    m_scene->view<RigidBody>().exclude<Static, Sleeping>().each([&](EntityID entity, RigidBody& body) {
+        const float speedSquared = body.velocity.x * body.velocity.x + body.velocity.y * body.velocity.y;
+        body.sleepTime = speedSquared <= threshold * threshold ? body.sleepTime + deltaTime : 0.0f;
+        
+        const uint32_t slot = Entity::index(entity);
+        if (slot >= m_islandNodes.size()) {
+            m_islandNodes.resize(slot + 1);
+        }
+        const uint32_t node = static_cast<uint32_t>(m_islandBodies.size());
+        m_islandNodes[slot] = node;
+        m_islandBodies.push_back(entity);
+        m_islandParent.push_back(node);
+        m_islandReady.push_back(body.canSleep && body.sleepTime >= m_sleepSettings.timeToSleep ? 1 : 0);
+    });
     
-    // Collect all entities with colliders
-    for (auto entity : entities) {
-        if (m_scene->hasComponent<Collider>(entity)) {
-            colliders.push_back(entity);
+    // Node of an entity, or none; slots keep stale nodes from earlier frames
+    auto nodeOf = [this](EntityID entity) {
+        const uint32_t slot = Entity::index(entity);
+        if (slot >= m_islandNodes.size()) return UINT32_MAX;
+        const uint32_t node = m_islandNodes[slot];
+        return node < m_islandBodies.size() && m_islandBodies[node] == entity ? node : UINT32_MAX;
+    };
+    for (const auto& contact : m_islandContacts) {
+        const uint32_t a = nodeOf(contact.first);
+        const uint32_t b = nodeOf(contact.second);
+        if (a == UINT32_MAX || b == UINT32_MAX) continue;
+        const uint32_t rootA = findIsland(a);
+        const uint32_t rootB = findIsland(b);
+        if (rootA != rootB) {
+            m_islandParent[rootB] = rootA;
         }
     }
+    m_islandContacts.clear();
     
-    // Check collisions between all pairs
-    for (size_t i = 0; i < colliders.size(); ++i) {
-        for (size_t j = i + 1; j < colliders.size(); ++j) {
-            EntityID entityA = colliders[i];
-            EntityID entityB = colliders[j];
-            
-            auto& transformA = m_scene->getComponent<Transform>(entityA);
-            auto& transformB = m_scene->getComponent<Transform>(entityB);
-            auto& colliderA = m_scene->getComponent<Collider>(entityA);
-            auto& colliderB = m_scene->getComponent<Collider>(entityB);
+    // An island sleeps only if every body in it is ready to
+    const size_t nodeCount = m_islandBodies.size();
+    m_islandGroup.assign(nodeCount, UINT32_MAX);
+    size_t islands = 0;
+    for (uint32_t node = 0; node < nodeCount; ++node) {
+        const uint32_t root = findIsland(node);
+        if (root == node) ++islands;
+        if (!m_islandReady[node]) {
+            m_islandGroup[root] = 0; // Marks the island as staying awake
+        }
+    }
+    m_sleepStats.islands = islands;
+    m_sleepStats.awakeBodies = nodeCount;
+    
+    if (m_sleepSettings.enabled) {
+        m_sleepBatch.clear();
+        for (uint32_t node = 0; node < nodeCount; ++node) {
+            const uint32_t root = findIsland(node);
+            if (m_islandGroup[root] == 0) continue;
+            if (m_islandGroup[root] == UINT32_MAX) {
+                uint32_t island;
+                if (m_freeSleepIslands.empty()) {
+                    island = static_cast<uint32_t>(m_sleepIslands.size());
+                    m_sleepIslands.emplace_back();
+                } else {
+                    island = m_freeSleepIslands.back();
+                    m_freeSleepIslands.pop_back();
+                }
+                m_islandGroup[root] = island + 1; // 0 is taken by awake islands
+            }
             
-            Rect boundsA = colliderA.getBounds(transformA.position);
-            Rect boundsB = colliderB.getBounds(transformB.position);
+            const EntityID entity = m_islandBodies[node];
+            const uint32_t island = m_islandGroup[root] - 1;
+            m_sleepIslands[island].bodies.push_back(entity);
+            const uint32_t slot = Entity::index(entity);
+            if (slot >= m_sleepRecords.size()) {
+                m_sleepRecords.resize(slot + 1);
+            }
+            m_sleepRecords[slot] = {entity, island};
+            m_sleepBatch.push_back(entity);
+        }
+        
+        CommandBuffer& commands = m_scene->getCommandBuffer();
+        for (EntityID entity : m_sleepBatch) {
+            RigidBody& body = m_scene->getComponent<RigidBody>(entity);
+            body.velocity = Vector2(0, 0);
+            body.acceleration = Vector2(0, 0);
+            commands.addComponent(entity, Sleeping());
+        }
+        if (!m_sleepBatch.empty()) {
+            m_parkedDirty = true;
+        }
+        m_sleepStats.fellAsleep += m_sleepBatch.size();
+        m_sleepStats.totalFellAsleep += m_sleepBatch.size();
+    }
+    
+    // Our own writes above must not count as touching the sleepers
+    m_sleepTick = m_scene->advanceChangeTick();
+}
+
+uint32_t CollisionSystem::findIsland(uint32_t node) {
+    while (m_islandParent[node] != node) {
+        m_islandParent[node] = m_islandParent[m_islandParent[node]]; // Path halving
+        node = m_islandParent[node];
+    }
+    return node;
+}
+
+bool CollisionSystem::isParked(EntityID entity) const {
+    const uint32_t slot = Entity::index(entity);
+    return slot < m_parked.size() && m_parked[slot] == entity;
+}
+
+void CollisionSystem::resolveTilemaps(float deltaTime) {
+    m_tilemaps.clear();
+    m_scene->view<const Transform, const EnvironmentCollider>().each(
+        [this](EntityID entity, const Transform& transform, const EnvironmentCollider& environment) {
+            if (environment.shape == EnvironmentCollider::ColliderShape::Tilemap && environment.tilemap) {
+                m_tilemaps.push_back({entity, transform.position, environment.tilemap.get(), environment.layer});
+            }
+        });
+    if (m_tilemaps.empty()) return;
+    
+    m_scene->view<const Transform, const Collider>().exclude<Sleeping>().each(
+        [this, deltaTime](EntityID entity, const Transform& transform, const Collider& collider) {
+            if (collider.isStatic || collider.isTrigger) return;
             
-            if (checkCollision(boundsA, boundsB)) {
-                // Handle collision response
-                if (!colliderA.isTrigger && !colliderB.isTrigger) {
-                    // Physical collision - separate objects
-                    Vector2 normal = getCollisionNormal(boundsA, boundsB);
-                    
-                    // Only move non-static objects
-                    if (!colliderA.isStatic && !colliderB.isStatic) {
-                        // Move both objects away from each other
-                        float separation = 2.0f; // Minimum separation distance
-                        transformA.position = transformA.position - (normal * separation * 0.5f);
-                        transformB.position = transformB.position + (normal * separation * 0.5f);
-                    } else if (!colliderA.isStatic) {
-                        // Only move A
-                        float separation = 2.0f;
-                        transformA.position = transformA.position - (normal * separation);
-                    } else if (!colliderB.isStatic) {
-                        // Only move B
-                        float separation = 2.0f;
-                        transformB.position = transformB.position + (normal * separation);
-                    }
-                    
-                    // Adjust velocities if entities have RigidBody components
-                    if (m_scene->hasComponent<RigidBody>(entityA) && !colliderA.isStatic) {
-                        auto& rb = m_scene->getComponent<RigidBody>(entityA);
-                        // Simple velocity reflection
-                        if (normal.x != 0) rb.velocity.x *= -0.5f;
-                        if (normal.y != 0) rb.velocity.y *= -0.5f;
-                    }
-                    
-                    if (m_scene->hasComponent<RigidBody>(entityB) && !colliderB.isStatic) {
-                        auto& rb = m_scene->getComponent<RigidBody>(entityB);
-                        // Simple velocity reflection
-                        if (normal.x != 0) rb.velocity.x *= -0.5f;
-                        if (normal.y != 0) rb.velocity.y *= -0.5f;
+            Vector2 position = transform.position;
+            for (const TilemapEntry& tilemap : m_tilemaps) {
+                if (!m_matrix.collides(collider.layer, tilemap.layer)) continue;
+                
+                // Map-relative bounds; only the cells under the box are read
+                const Rect bounds = collider.getBounds(position - tilemap.origin);
+                if (!tilemap.map->overlapsSolid(bounds)) continue;
+                
+                RigidBody* body = m_scene->hasComponent<RigidBody>(entity) ? &m_scene->getComponent<RigidBody>(entity) : nullptr;
+                Vector2 correction;
+                bool hitX = false;
+                bool hitY = false;
+                if (body) {
+                    const Vector2 delta = body->velocity * deltaTime;
+                    const Rect start(bounds.x - delta.x, bounds.y - delta.y, bounds.width, bounds.height);
+                    if (!tilemap.map->overlapsSolid(start)) {
+                        const TileCollisionMap::SweepResult sweep = tilemap.map->sweep(start, delta);
+                        correction = sweep.delta - delta;
+                        hitX = sweep.hitX;
+                        hitY = sweep.hitY;
                     }
                 }
+                if (!hitX && !hitY) {
+                    // No body, or it started this frame inside a wall
+                    correction = tilemap.map->resolveOverlap(bounds);
+                    hitX = correction.x != 0.0f;
+                    hitY = correction.y != 0.0f;
+                    if (!hitX && !hitY) continue;
+                }
                 
-                // Trigger events could be handled here
-                // onCollision(entityA, entityB);
+                position = position + correction;
+                m_scene->getComponent<Transform>(entity).position = position;
+                if (hitX) {
+                    if (body) body->velocity.x = 0.0f;
+                    m_scene->publishEvent(CollisionEvent{entity, tilemap.entity, Vector2(correction.x < 0.0f ? -1.0f : 1.0f, 0.0f)});
+                }
+                if (hitY) {
+                    if (body) body->velocity.y = 0.0f;
+                    m_scene->publishEvent(CollisionEvent{entity, tilemap.entity, Vector2(0.0f, correction.y < 0.0f ? -1.0f : 1.0f)});
+                }
             }
+        });
+}
+
+bool CollisionSystem::staticCollidersChanged() const {
+    if (!m_staticBuilt || m_parkedDirty ||
+        m_scene->getLastAddedTick<Sleeping>() > m_staticTick ||
+        m_scene->getLastAddedTick<Collider>() > m_staticTick ||
+        m_scene->getLastChangedTick<Collider>() > m_staticTick ||
+        m_scene->getLastRemovedTick<Collider>() > m_staticTick ||
+        m_scene->getLastRemovedTick<Transform>() > m_staticTick) {
+        return true;
+    }
+    if (m_scene->getLastChangedTick<Transform>() <= m_staticTick) {
+        return false;
+    }
+    
+    // Transforms were written - only a static collider moving matters
+    bool staticMoved = false;
+    m_scene->view<const Transform, const Collider>().changed<Transform>(m_staticTick).each(
+        [&staticMoved](EntityID, const Transform&, const Collider& collider) {
+            staticMoved = staticMoved || collider.isStatic;
+        });
+    return staticMoved;
+}
+
+void CollisionSystem::rebuildStaticColliders() {
+    m_staticTick = m_scene->advanceChangeTick();
+    m_staticBuilt = true;
+    m_parkedDirty = false;
+    
+    for (const StaticCollider& previous : m_staticColliders) {
+        if (previous.sleeping) m_parked[Entity::index(previous.entity)] = Entity::Null;
+    }
+    m_staticColliders.clear();
+    m_grid.clearStatic();
+    m_staticTree.clear();
+    m_scene->view<const Transform, const Collider>().each(
+        [this](EntityID entity, const Transform& transform, const Collider& collider) {
+            const bool sleeping = !collider.isStatic && m_scene->hasComponent<Sleeping>(entity);
+            if (!collider.isStatic && !sleeping) return;
+            const uint32_t id = static_cast<uint32_t>(m_staticColliders.size());
+            const Rect bounds = collider.getBounds(transform.position);
+            if (m_broadphaseType == Broadphase::Grid) {
+                m_grid.insertStatic(id, bounds);
+            } else {
+                m_staticTree.createProxy(bounds, id);
+            }
+            m_staticColliders.push_back({entity, bounds, collider.isTrigger, sleeping, collider.layer, collider.mask});
+            
+            if (sleeping) {
+                const uint32_t slot = Entity::index(entity);
+                if (slot >= m_parked.size()) {
+                    m_parked.resize(slot + 1, Entity::Null);
+                }
+                m_parked[slot] = entity;
+            }
+        });
+}
+
+void CollisionSystem::findTreePairs() {
+    // Moving colliders keep their proxy between frames; moveProxy() only
+    // touches the tree once a collider leaves its fat box
+    ++m_treeFrame;
+    for (uint32_t i = 0; i < m_colliders.size(); ++i) {
+        const ColliderEntry& entry = m_colliders[i];
+        const Rect bounds = entry.collider->getBounds(entry.transform->position);
+        const uint32_t slot = Entity::index(entry.entity);
+        if (slot >= m_treeProxies.size()) {
+            m_treeProxies.resize(slot + 1);
+        }
+        
+        TreeProxy& treeProxy = m_treeProxies[slot];
+        if (treeProxy.proxy != AABBTree::NULL_NODE && treeProxy.entity == entry.entity) {
+            m_dynamicTree.moveProxy(treeProxy.proxy, bounds, entry.transform->position - treeProxy.position);
+            m_dynamicTree.setId(treeProxy.proxy, i);
+        } else {
+            if (treeProxy.proxy != AABBTree::NULL_NODE) {
+                m_dynamicTree.destroyProxy(treeProxy.proxy); // Slot reused by a new entity
+            }
+            treeProxy.entity = entry.entity;
+            treeProxy.proxy = m_dynamicTree.createProxy(bounds, i);
+        }
+        treeProxy.frame = m_treeFrame;
+        treeProxy.position = entry.transform->position;
+    }
+    
+    // Destroyed, static or collider-less entities lose their proxy
+    for (TreeProxy& treeProxy : m_treeProxies) {
+        if (treeProxy.proxy != AABBTree::NULL_NODE && treeProxy.frame != m_treeFrame) {
+            m_dynamicTree.destroyProxy(treeProxy.proxy);
+            treeProxy.proxy = AABBTree::NULL_NODE;
+        }
+    }
+    
+    // A real overlap is inside both fat boxes, so querying with each
+    // collider's bounds (grown by CONTACT_MARGIN to find resting neighbours)
+    // and keeping b > a reports every pair once
+    m_pairs.clear();
+    for (uint32_t i = 0; i < m_colliders.size(); ++i) {
+        const Rect bounds = inflate(m_colliders[i].collider->getBounds(m_colliders[i].transform->position), CONTACT_MARGIN);
+        m_dynamicTree.query(bounds, [this, i](uint32_t other) {
+            if (other > i) m_pairs.push_back({i, other, false});
+            return true;
+        });
+        m_staticTree.query(bounds, [this, i](uint32_t other) {
+            m_pairs.push_back({i, other, true});
+            return true;
+        });
+    }
+}
+
+void CollisionSystem::resolve(EntityID entityA, const Rect& boundsA, EntityID entityB, const Rect& boundsB, bool staticB) {
+    const Vector2 normal = getCollisionNormal(boundsA, boundsB);
+    m_scene->publishEvent(CollisionEvent{entityA, entityB, normal});
+    
+    // Physical collision - separate objects. A is always a moving collider.
+    const float separation = CONTACT_MARGIN; // Minimum separation distance
+    if (staticB) {
+        // Only move A
+        auto& transformA = m_scene->getComponent<Transform>(entityA);
+        transformA.position = transformA.position - (normal * separation);
+    } else {
+        // Move both objects away from each other
+        auto& transformA = m_scene->getComponent<Transform>(entityA);
+        auto& transformB = m_scene->getComponent<Transform>(entityB);
+        transformA.position = transformA.position - (normal * separation * 0.5f);
+        transformB.position = transformB.position + (normal * separation * 0.5f);
+    }
+    
+    // Adjust velocities if entities have RigidBody components
+    if (m_scene->hasComponent<RigidBody>(entityA)) {
+        auto& rb = m_scene->getComponent<RigidBody>(entityA);
+        // Simple velocity reflection
+        if (normal.x != 0) rb.velocity.x *= -0.5f;
+        if (normal.y != 0) rb.velocity.y *= -0.5f;
+    }
+    
+    if (!staticB && m_scene->hasComponent<RigidBody>(entityB)) {
+        auto& rb = m_scene->getComponent<RigidBody>(entityB);
+        // Simple velocity reflection
+        if (normal.x != 0) rb.velocity.x *= -0.5f;
+        if (normal.y != 0) rb.velocity.y *= -0.5f;
+    }
+}
+
+void CollisionSystem::touch(EntityID entityA, EntityID entityB, bool trigger, bool keepOnly) {
+    if (entityB < entityA) std::swap(entityA, entityB);
+    m_touching.push_back({entityA, entityB, trigger, keepOnly});
+}
+
+void CollisionSystem::updateContacts(bool staticsRebuilt) {
+    auto before = [](EntityID a1, EntityID b1, EntityID a2, EntityID b2) {
+        return a1 != a2 ? a1 < a2 : b1 < b2;
+    };
+    std::sort(m_touching.begin(), m_touching.end(), [&before](const TouchingPair& x, const TouchingPair& y) {
+        return before(x.a, x.b, y.a, y.b);
+    });
+    
+    // Merge this frame's pairs with the cache; both are sorted by (a, b)
+    m_nextContacts.clear();
+    m_contactEvents.clear();
+    auto emit = [this](const Contact& contact, ContactEvent::Phase phase) {
+        m_contactEvents.push_back({contact.a, contact.b, phase, contact.trigger});
+    };
+    size_t cached = 0;
+    size_t touching = 0;
+    while (cached < m_contacts.size() || touching < m_touching.size()) {
+        const Contact* contact = cached < m_contacts.size() ? &m_contacts[cached] : nullptr;
+        const TouchingPair* pair = touching < m_touching.size() ? &m_touching[touching] : nullptr;
+        
+        if (pair && (!contact || before(pair->a, pair->b, contact->a, contact->b))) {
+            // Not cached: only a real overlap starts a contact
+            if (!pair->keepOnly) {
+                m_nextContacts.push_back({pair->a, pair->b, pair->trigger});
+                emit(m_nextContacts.back(), ContactEvent::Phase::Enter);
+            }
+        } else if (!pair || before(contact->a, contact->b, pair->a, pair->b)) {
+            // Cached but not found this frame
+            if (keepsUntested(*contact, staticsRebuilt)) {
+                m_nextContacts.push_back(*contact);
+                if (m_stayEvents) emit(*contact, ContactEvent::Phase::Stay);
+            } else {
+                emit(*contact, ContactEvent::Phase::Exit);
+            }
+            ++cached;
+            continue;
+        } else {
+            m_nextContacts.push_back({pair->a, pair->b, pair->trigger});
+            if (m_stayEvents) emit(m_nextContacts.back(), ContactEvent::Phase::Stay);
+            ++cached;
+        }
+        
+        // A pair may be found more than once
+        const TouchingPair& found = m_touching[touching];
+        while (touching < m_touching.size() && m_touching[touching].a == found.a && m_touching[touching].b == found.b) {
+            ++touching;
         }
     }
+    
+    m_contacts.swap(m_nextContacts);
+    m_scene->publishEvents(m_contactEvents);
+}
+
+bool CollisionSystem::isMoving(EntityID entity) const {
+    const uint32_t slot = Entity::index(entity);
+    return slot < m_movingStamps.size() && m_movingStamps[slot].entity == entity &&
+           m_movingStamps[slot].frame == m_contactFrame;
+}
+
+bool CollisionSystem::keepsUntested(const Contact& contact, bool recheck) const {
+    // A moving collider was tested against everything near it this frame
+    if (isMoving(contact.a) || isMoving(contact.b)) return false;
+    
+    const Scene& scene = *m_scene; // Only read, so nothing is stamped
+    for (const EntityID entity : {contact.a, contact.b}) {
+        if (!scene.isAlive(entity) || !scene.hasComponent<Transform>(entity) || !scene.hasComponent<Collider>(entity)) {
+            return false;
+        }
+    }
+    if (!recheck) return true;
+    
+    // Statics were rebuilt or the matrix changed, so the pair may be gone
+    const Collider& colliderA = scene.getComponent<Collider>(contact.a);
+    const Collider& colliderB = scene.getComponent<Collider>(contact.b);
+    if (!m_matrix.collides(colliderA.layer, colliderB.layer)) return false;
+    const Rect boundsA = colliderA.getBounds(scene.getComponent<Transform>(contact.a).position);
+    const Rect boundsB = colliderB.getBounds(scene.getComponent<Transform>(contact.b).position);
+    if (colliderA.isTrigger || colliderB.isTrigger) {
+        return checkCollision(boundsA, boundsB) && checkMasks(boundsA, colliderA.mask.get(), boundsB, colliderB.mask.get());
+    }
+    return checkCollision(inflate(boundsA, CONTACT_MARGIN), boundsB);
 }
 
 bool CollisionSystem::checkCollision(const Rect& a, const Rect& b) {
@@ -159,6 +793,15 @@ bool CollisionSystem::checkCollision(const Rect& a, const Rect& b) {
             a.y + a.height > b.y);
 }
 
+bool CollisionSystem::checkMasks(const Rect& a, const CollisionMask* maskA, const Rect& b, const CollisionMask* maskB) {
+    if (maskA && maskB) {
+        return CollisionMask::overlaps(*maskA, Vector2(a.x, a.y), *maskB, Vector2(b.x, b.y));
+    }
+    if (maskA) return CollisionMask::overlaps(*maskA, Vector2(a.x, a.y), b);
+    if (maskB) return CollisionMask::overlaps(*maskB, Vector2(b.x, b.y), a);
+    return true;
+}
+
 Vector2 CollisionSystem::getCollisionNormal(const Rect& a, const Rect& b) {
     Vector2 centerA(a.x + a.width / 2, a.y + a.height / 2);
     Vector2 centerB(b.x + b.width / 2, b.y + b.height / 2);
@@ -3,50 +3,329 @@
 #include "System.h"
 #include "PlayerSystem.h"
 #include "graphics/Renderer.h"
+#include "physics/AABBTree.h"
+#include "physics/BodyIntegrator.h"
+#include "physics/CollisionMask.h"
+#include "physics/SpatialHash.h"
+#include "physics/TileCollisionMap.h"
+#include "scene/EventBus.h"
+#include "scene/Resources.h"
 #include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 // Forward declare Scene class
 class Scene;
 
 class RenderSystem : public System {
 public:
-    RenderSystem() = default;
+    RenderSystem() {
+        reads<Transform, Sprite>();
+    }
     
+    // Entities with a PreviousTransform are drawn between it and their
+    // Transform by the scene's interpolation alpha
     void render(Renderer* renderer) override;
     void setScene(Scene* scene) { m_scene = scene; }
+    
+    static Transform interpolateTransform(const PreviousTransform& previous, const Transform& current, float alpha);
 
 private:
+    struct DrawItem {
+        EntityID entity;
+        int layer;
+    };
+    
+    // The sorted draw order is cached and only rebuilt when sprites or the
+    // set of drawable entities changed (see Scene change detection)
+    bool drawOrderIsStale() const;
+    void rebuildDrawOrder();
+    
     Scene* m_scene = nullptr;
+    std::vector<DrawItem> m_drawList;
+    std::vector<EntityID> m_drawOrder;
+    ChangeTick m_drawOrderTick = 0;
+    bool m_drawOrderBuilt = false;
 };
 
 class PhysicsSystem : public System {
 public:
-    PhysicsSystem() = default;
+    PhysicsSystem() {
+        writes<Transform, RigidBody>();
+    }
     
     void update(float deltaTime) override;
     void setScene(Scene* scene) { m_scene = scene; }
+    
+    // Instruction set and deterministic mode of the integration step; see
+    // BodyIntegrator. Deterministic by default.
+    BodyIntegrator& getIntegrator() { return m_integrator; }
+    const BodyIntegrator& getIntegrator() const { return m_integrator; }
 
 private:
     Scene* m_scene = nullptr;
+    BodyIntegrator m_integrator;
     const float GRAVITY = 980.0f; // pixels per second squared
+    static constexpr size_t INTEGRATION_GRAIN_SIZE = 256; // Bodies per job
 };
 
+// Candidate pairs come from a broadphase: a SpatialHash grid (the default) or
+// a pair of AABBTrees, see setBroadphase(). Colliders marked isStatic stay in
+// the broadphase between frames and are only re-inserted when a static
+// collider or its Transform changed (see Scene change detection). Moving
+// colliders are re-inserted every frame into the grid; in the tree they keep
+// their proxy and are only reinserted after leaving its fat box. Pairs are
+// only formed with a moving collider, so two statics are never paired, and
+// the scene's CollisionMatrix drops pairs whose layers do not meet before
+// their bounds are compared. Pairs whose bounds overlap are then tested
+// against the colliders' CollisionMasks, if they have any; bounds without a
+// mask count as solid.
+//
+// Moving, non-trigger colliders are also kept out of the solid cells of
+// Tilemap EnvironmentColliders. Bodies with a RigidBody are swept from where
+// this frame's velocity started them, one axis at a time, and lose their
+// velocity on the blocked axis; anything else found inside a solid cell is
+// pushed out along the shortest axis. Each blocked axis publishes a
+// CollisionEvent with the tilemap entity as b.
+//
+// Rigid bodies that stay below the sleep speed for the sleep time are put to
+// sleep (see Sleeping) - an island at a time, an island being the bodies
+// linked by non-trigger contacts, so a pile sleeps and wakes as one. Sleeping
+// colliders join the static ones in the broadphase and are not re-inserted or
+// tested against each other. A moving collider pushing into one, or a write to
+// its Transform or RigidBody, wakes its whole island. update() may run on a
+// worker, so the Sleeping tags are added and removed through the scene's
+// command buffer: a body keeps its old state until the commands play back
+// after the systems, and still acts as static for the frame it is woken in.
+//
+// Touching pairs are kept in a contact cache between frames and diffed
+// against the pairs found each frame, publishing a ContactEvent batch of
+// Enter and Exit phases (and Stay, see setStayEvents()). Pairs involving a
+// trigger only go into the cache - no normal, response or CollisionEvent. A
+// solid pair pushed apart keeps its contact while within CONTACT_MARGIN, and
+// a pair neither of whose colliders moved this frame (sleeping, or a sleeper
+// and a static) keeps it untested, so resting piles cost nothing.
 class CollisionSystem : public System {
 public:
-    CollisionSystem() = default;
+    CollisionSystem() {
+        reads<Collider, EnvironmentCollider, CollisionMatrix>();
+        writes<Transform, RigidBody>();
+        runAfter<PhysicsSystem>();
+    }
     
     void update(float deltaTime) override;
     void setScene(Scene* scene) { m_scene = scene; }
     
+    // Grid (SpatialHash) suits colliders of similar size; Tree (AABBTree)
+    // copes with a mix of tiny and very large colliders
+    enum class Broadphase {
+        Grid,
+        Tree
+    };
+    
+    void setBroadphase(Broadphase broadphase);
+    Broadphase getBroadphase() const { return m_broadphaseType; }
+    
+    // Broadphase grid cell size in pixels; a few times the typical collider
+    // size works best
+    void setCellSize(float cellSize);
+    float getCellSize() const { return m_grid.getCellSize(); }
+    
+    struct SleepSettings {
+        bool enabled = true;       // Disabling wakes every sleeping body
+        float speedThreshold = 8.0f; // Pixels per second
+        float timeToSleep = 0.5f;  // Seconds below speedThreshold
+    };
+    
+    struct SleepStats {
+        size_t awakeBodies = 0;    // Rigid bodies considered for sleep last update
+        size_t islands = 0;        // Islands they formed
+        size_t fellAsleep = 0;     // Last update
+        size_t wokeUp = 0;         // Last update
+        uint64_t totalFellAsleep = 0;
+        uint64_t totalWokeUp = 0;
+    };
+    
+    // A pair of touching colliders in the contact cache
+    struct Contact {
+        EntityID a; // a < b
+        EntityID b;
+        bool trigger;
+    };
+    
+    // Pairs touching after the last update, sorted by (a, b)
+    const std::vector<Contact>& getContacts() const { return m_contacts; }
+    
+    // Stay events for every cached pair, every frame. Off by default so the
+    // events scale with contact changes; getContacts() lists the rest.
+    void setStayEvents(bool enabled) { m_stayEvents = enabled; }
+    bool getStayEvents() const { return m_stayEvents; }
+    
+    // Throws if a threshold or time is negative
+    void setSleepSettings(const SleepSettings& settings);
+    const SleepSettings& getSleepSettings() const { return m_sleepSettings; }
+    const SleepStats& getSleepStats() const { return m_sleepStats; }
+    // Counted on demand
+    size_t getSleepingBodyCount() const;
+    
     // Utility functions for collision detection
     static bool checkCollision(const Rect& a, const Rect& b);
+    // For bounds that overlap: false if a mask leaves no solid pixel in common
+    static bool checkMasks(const Rect& a, const CollisionMask* maskA, const Rect& b, const CollisionMask* maskB);
     static Vector2 getCollisionNormal(const Rect& a, const Rect& b);
 
 private:
+    struct ColliderEntry {
+        EntityID entity;
+        const Transform* transform;
+        const Collider* collider;
+    };
+    
+    // Static colliders are cached by value: component addresses are not
+    // stable across frames
+    struct StaticCollider {
+        EntityID entity;
+        Rect bounds;
+        bool isTrigger;
+        bool sleeping; // A sleeping body parked with the statics
+        uint8_t layer;
+        std::shared_ptr<const CollisionMask> mask;
+    };
+    
+    // Tree broadphase proxy of a moving collider, indexed by entity slot
+    struct TreeProxy {
+        EntityID entity = Entity::Null;
+        int32_t proxy = AABBTree::NULL_NODE;
+        uint32_t frame = 0; // Last frame the collider was seen
+        Vector2 position;   // Transform position that frame
+    };
+    
+    struct TilemapEntry {
+        EntityID entity;
+        Vector2 origin;
+        const TileCollisionMap* map;
+        uint8_t layer;
+    };
+    
+    // Resolution pushes overlapping colliders this far apart, so moving
+    // colliders at most this far apart count as touching for islands
+    static constexpr float CONTACT_MARGIN = 2.0f;
+    
+    // A pair found touching this frame; a keepOnly pair (solid, within
+    // CONTACT_MARGIN but not overlapping) keeps a cached contact without
+    // starting one
+    struct TouchingPair {
+        EntityID a;
+        EntityID b;
+        bool trigger;
+        bool keepOnly;
+    };
+    
+    // Last frame an entity slot held a moving collider
+    struct MovingStamp {
+        EntityID entity = Entity::Null;
+        uint32_t frame = 0;
+    };
+    
+    // Bodies put to sleep together; woken together
+    struct SleepIsland {
+        std::vector<EntityID> bodies;
+    };
+    
+    // Per entity slot
+    struct SleepRecord {
+        EntityID entity = Entity::Null;
+        uint32_t island = 0; // Or WAKING
+    };
+    
+    // Island of a body whose Sleeping removal is already recorded this update
+    static constexpr uint32_t WAKING = UINT32_MAX;
+    
+    void resolveTilemaps(float deltaTime);
+    void wakeTouchedSleepers();
+    void wake(EntityID entity);
+    void updateSleep(float deltaTime);
+    uint32_t findIsland(uint32_t node);
+    bool isParked(EntityID entity) const;
+    bool staticCollidersChanged() const;
+    void rebuildStaticColliders();
+    void findTreePairs();
+    void resolve(EntityID entityA, const Rect& boundsA, EntityID entityB, const Rect& boundsB, bool staticB);
+    void touch(EntityID entityA, EntityID entityB, bool trigger, bool keepOnly);
+    void updateContacts(bool staticsRebuilt);
+    bool isMoving(EntityID entity) const;
+    bool keepsUntested(const Contact& contact, bool recheck) const;
+    
+    Scene* m_scene = nullptr;
+    Broadphase m_broadphaseType = Broadphase::Grid;
+    SpatialHash m_grid;
+    AABBTree m_staticTree{0.0f}; // Static boxes never move, so no margin
+    AABBTree m_dynamicTree;
+    std::vector<TreeProxy> m_treeProxies;
+    uint32_t m_treeFrame = 0;
+    std::vector<ColliderEntry> m_colliders;        // Moving colliders, this frame
+    std::vector<StaticCollider> m_staticColliders;
+    std::vector<SpatialHash::Pair> m_pairs;        // Both broadphases report these
+    std::vector<TilemapEntry> m_tilemaps;
+    ChangeTick m_staticTick = 0;
+    bool m_staticBuilt = false;
+    CollisionMatrix m_matrix; // The scene's, copied each update
+    
+    SleepSettings m_sleepSettings;
+    SleepStats m_sleepStats;
+    std::vector<Contact> m_contacts;              // The contact cache, sorted
+    std::vector<Contact> m_nextContacts;
+    std::vector<TouchingPair> m_touching;         // This frame
+    std::vector<ContactEvent> m_contactEvents;
+    std::vector<MovingStamp> m_movingStamps;      // By entity slot
+    uint32_t m_contactFrame = 0;
+    bool m_stayEvents = false;
+    
+    std::vector<EntityID> m_parked;               // Sleeping entity parked with the statics, by slot
+    std::vector<std::pair<EntityID, EntityID>> m_islandContacts; // Non-trigger moving pairs, this frame
+    std::vector<EntityID> m_wakeRequests;         // Sleepers touched this frame
+    std::vector<SleepIsland> m_sleepIslands;      // Unused ones are empty
+    std::vector<uint32_t> m_freeSleepIslands;
+    std::vector<SleepRecord> m_sleepRecords;
+    std::vector<EntityID> m_wokenBodies;          // Recorded as WAKING this update
+    std::vector<uint32_t> m_islandNodes;          // Union-find node by entity slot, this frame
+    std::vector<uint32_t> m_islandParent;
+    std::vector<EntityID> m_islandBodies;         // Entity of each node
+    std::vector<uint8_t> m_islandReady;           // Node may sleep
+    std::vector<uint32_t> m_islandGroup;          // By root: 0 stays awake, else sleep island + 1
+    std::vector<EntityID> m_sleepBatch;
+    ChangeTick m_sleepTick = 0;
+    bool m_parkedDirty = false;
+    bool m_wakeAll = false;
+};
+
+// Publishes a TriggerEvent when an entity with a Collider enters, stays in or
+// leaves an EnvironmentTrigger area - only the phase the trigger's type asks
+// for. The area's top-left corner is the trigger's Transform position.
+// Colliders are found through Scene::queryAABB(), so like every spatial query
+// during update() it sees them where they were when the frame started.
+// Interact triggers are left to gameplay code.
+class TriggerSystem : public System {
+public:
+    TriggerSystem() {
+        reads<Transform, Collider>();
+        writes<EnvironmentTrigger>();
+        runAfter<CollisionSystem>();
+    }
+    
+    void update(float deltaTime) override;
+    void setScene(Scene* scene) { m_scene = scene; }
+
+private:
+    void publish(EntityID triggerEntity, const EnvironmentTrigger& trigger, EntityID other);
+    
     Scene* m_scene = nullptr;
+    std::vector<EntityID> m_overlapping;
+    std::unordered_map<EntityID, std::vector<EntityID>> m_inside; // Per trigger, sorted
 };
 
-// Input system for handling player input
+// Input system for handling player input. It declares no component access, so
+// the scheduler runs it exclusively on the main thread (SDL keyboard state).
 class InputSystem : public System {
 public:
     InputSystem();
@@ -64,7 +343,10 @@ private:
 // Particle system for managing particle effects
 class ParticleSystem : public System {
 public:
-    ParticleSystem() = default;
+    ParticleSystem() {
+        reads<Transform>();
+        writes<ParticleEffect>();
+    }
     
     void update(float deltaTime) override;
     void render(Renderer* renderer) override;
@@ -72,6 +354,7 @@ public:
 
 private:
     Scene* m_scene = nullptr;
+    static constexpr size_t UPDATE_GRAIN_SIZE = 8; // Effects per job; each holds many particles
     
     void renderParticle(Renderer* renderer, const ParticleEffect::Particle& particle, 
                        const Vector2& position, std::shared_ptr<Texture> texture);
@@ -80,19 +363,21 @@ private:
 // Light system for rendering dynamic lighting
 class LightSystem : public System {
 public:
-    LightSystem() = default;
+    LightSystem() {
+        reads<Transform>();
+        writes<LightSource>();
+    }
     
     void update(float deltaTime) override;
     void render(Renderer* renderer) override;
     void setScene(Scene* scene) { m_scene = scene; }
     
-    // Ambient light controls
+    // Ambient light controls (stored in the scene's AmbientLight resource)
     void setAmbientLight(float r, float g, float b, float intensity = 0.2f);
     void renderAmbientLight(Renderer* renderer, int screenWidth, int screenHeight);
 
 private:
     Scene* m_scene = nullptr;
-    Color m_ambientLight{50, 50, 80, 255}; // Default dim blue ambient light
     
     // Light rendering functions
     void renderLight(Renderer* renderer, const LightSource& light, const Transform& transform);
@@ -105,10 +390,15 @@ private:
                          Uint8 r, Uint8 g, Uint8 b, Uint8 alpha);
 };
 
-// Audio system for managing sound effects and music
+// Audio system for managing sound effects and music. SDL_mixer may only be
+// called from the main thread, so the scheduler keeps it there.
 class AudioSystem : public System {
 public:
-    AudioSystem() = default;
+    AudioSystem() {
+        reads<Transform, AudioListenerPosition>();
+        writes<AudioSource>();
+        runOnMainThread();
+    }
     ~AudioSystem() = default;
     
     // System lifecycle
@@ -129,14 +419,13 @@ public:
     void stopMusic();
     void setMusicVolume(float volume);
     
-    // 3D Audio
+    // 3D Audio (stored in the scene's AudioListenerPosition resource)
     void setListenerPosition(const Vector2& position);
     void setListenerPosition(float x, float y);
 
 private:
     Scene* m_scene = nullptr;
     float m_masterVolume = 1.0f;
-    Vector2 m_listenerPosition{0, 0};
     
     // Entity to audio channel mapping
     std::unordered_map<EntityID, int> m_entityChannels;
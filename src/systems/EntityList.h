@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../components/Entity.h"
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+// Dense set of entities with O(1) insert, erase and lookup.
+//
+// Entities are kept packed in a vector for cache-friendly iteration; a
+// back-index keyed by slot index records each entity's position so erase can
+// swap-and-pop. Iteration order is insertion order until sort() is called.
+class EntityList {
+public:
+    using const_iterator = std::vector<EntityID>::const_iterator;
+
+    // Returns false if the entity was already present
+    bool insert(EntityID entity) {
+        const uint32_t index = Entity::index(entity);
+        if (index >= m_positions.size()) {
+            m_positions.resize(index + 1, NOT_PRESENT);
+        }
+        uint32_t& position = m_positions[index];
+        if (position != NOT_PRESENT) {
+            if (m_entities[position] == entity) return false;
+            // A stale handle for the same slot - replace it in place
+            m_entities[position] = entity;
+            return true;
+        }
+        position = static_cast<uint32_t>(m_entities.size());
+        m_entities.push_back(entity);
+        return true;
+    }
+
+    // Returns false if the entity was not present
+    bool erase(EntityID entity) {
+        if (!contains(entity)) return false;
+
+        const uint32_t position = m_positions[Entity::index(entity)];
+        const EntityID last = m_entities.back();
+        m_entities[position] = last;
+        m_positions[Entity::index(last)] = position;
+        m_entities.pop_back();
+        m_positions[Entity::index(entity)] = NOT_PRESENT;
+        return true;
+    }
+
+    bool contains(EntityID entity) const {
+        const uint32_t index = Entity::index(entity);
+        if (index >= m_positions.size()) return false;
+        const uint32_t position = m_positions[index];
+        return position != NOT_PRESENT && m_entities[position] == entity;
+    }
+
+    size_t count(EntityID entity) const { return contains(entity) ? 1 : 0; }
+
+    // Orders the entities by slot index, for systems that need a deterministic order
+    void sort() {
+        std::sort(m_entities.begin(), m_entities.end(), [](EntityID a, EntityID b) {
+            return Entity::index(a) < Entity::index(b);
+        });
+        for (uint32_t position = 0; position < m_entities.size(); ++position) {
+            m_positions[Entity::index(m_entities[position])] = position;
+        }
+    }
+
+    // Grows geometrically, so reserving ahead of every batch stays amortised O(1)
+    void reserve(size_t capacity) {
+        if (capacity > m_entities.capacity()) {
+            m_entities.reserve(std::max(capacity, m_entities.capacity() * 2));
+        }
+    }
+
+    void clear() {
+        m_entities.clear();
+        m_positions.clear();
+    }
+
+    size_t size() const { return m_entities.size(); }
+    bool empty() const { return m_entities.empty(); }
+    const EntityID* data() const { return m_entities.data(); }
+    EntityID operator[](size_t position) const { return m_entities[position]; }
+
+    const_iterator begin() const { return m_entities.begin(); }
+    const_iterator end() const { return m_entities.end(); }
+
+private:
+    static constexpr uint32_t NOT_PRESENT = std::numeric_limits<uint32_t>::max();
+
+    std::vector<EntityID> m_entities;
+    std::vector<uint32_t> m_positions;  // Slot index -> position in m_entities
+};
@@ -9,18 +9,17 @@ void LightSystem::update(float deltaTime) {
     if (!m_scene) return;
     
     // Update dynamic light properties
-    for (const auto& entity : entities) {
-        auto& lightSource = m_scene->getComponent<LightSource>(entity);
-        
-        if (!lightSource.enabled) continue;
-        
-        // Handle flickering lights
-        if (lightSource.flicker) {
-            lightSource.flickerTimer += deltaTime * lightSource.flickerSpeed;
-            float flickerAmount = std::sin(lightSource.flickerTimer) * lightSource.flickerIntensity;
-            // Intensity will be modified during rendering
-        }
-    }
+    m_scene->view<LightSource, const Transform>().each(
+        [deltaTime](EntityID, LightSource& lightSource, const Transform&) {
+            if (!lightSource.enabled) return;
+            
+            // Handle flickering lights
+            if (lightSource.flicker) {
+                lightSource.flickerTimer += deltaTime * lightSource.flickerSpeed;
+                float flickerAmount = std::sin(lightSource.flickerTimer) * lightSource.flickerIntensity;
+                // Intensity will be modified during rendering
+            }
+        });
 }
 
 void LightSystem::render(Renderer* renderer) {
@@ -34,14 +33,12 @@ void LightSystem::render(Renderer* renderer) {
     SDL_SetRenderDrawBlendMode(renderer->getSDLRenderer(), SDL_BLENDMODE_ADD);
     
     // Render all light sources
-    for (const auto& entity : entities) {
-        auto& lightSource = m_scene->getComponent<LightSource>(entity);
-        auto& transform = m_scene->getComponent<Transform>(entity);
-        
-        if (!lightSource.enabled) continue;
-        
-        renderLight(renderer, lightSource, transform);
-    }
+    m_scene->view<const LightSource, const Transform>().each(
+        [this, renderer](EntityID, const LightSource& lightSource, const Transform& transform) {
+            if (!lightSource.enabled) return;
+            
+            renderLight(renderer, lightSource, transform);
+        });
     
     // Restore original blend mode
     SDL_SetRenderDrawBlendMode(renderer->getSDLRenderer(), originalBlendMode);
@@ -194,13 +191,21 @@ void LightSystem::drawFilledCircle(Renderer* renderer, int centerX, int centerY,
 }
 
 void LightSystem::setAmbientLight(float r, float g, float b, float intensity) {
-    m_ambientLight.r = static_cast<Uint8>(r * 255 * intensity);
-    m_ambientLight.g = static_cast<Uint8>(g * 255 * intensity);
-    m_ambientLight.b = static_cast<Uint8>(b * 255 * intensity);
-    m_ambientLight.a = 255;
+    if (!m_scene) return;
+    
+    AmbientLight ambient;
+    ambient.color.r = static_cast<Uint8>(r * 255 * intensity);
+    ambient.color.g = static_cast<Uint8>(g * 255 * intensity);
+    ambient.color.b = static_cast<Uint8>(b * 255 * intensity);
+    ambient.color.a = 255;
+    m_scene->setResource(ambient);
 }
 
 void LightSystem::renderAmbientLight(Renderer* renderer, int screenWidth, int screenHeight) {
+    if (!m_scene) return;
+    const AmbientLight* ambient = m_scene->tryGetResource<AmbientLight>();
+    const Color ambientColor = ambient ? ambient->color : AmbientLight().color;
+    
     SDL_Renderer* sdlRenderer = renderer->getSDLRenderer();
     
     // Get current blend mode
@@ -211,7 +216,7 @@ void LightSystem::renderAmbientLight(Renderer* renderer, int screenWidth, int sc
     SDL_SetRenderDrawBlendMode(sdlRenderer, SDL_BLENDMODE_BLEND);
     
     // Fill screen with ambient light color
-    SDL_SetRenderDrawColor(sdlRenderer, m_ambientLight.r, m_ambientLight.g, m_ambientLight.b, m_ambientLight.a);
+    SDL_SetRenderDrawColor(sdlRenderer, ambientColor.r, ambientColor.g, ambientColor.b, ambientColor.a);
     SDL_Rect screenRect = {0, 0, screenWidth, screenHeight};
     SDL_RenderFillRect(sdlRenderer, &screenRect);
     
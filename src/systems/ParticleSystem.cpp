@@ -2,34 +2,33 @@
 #include "../components/Components.h"
 #include "../graphics/Renderer.h"
 #include "../scene/Scene.h"
+#include "../core/Engine.h"
+#include "../core/JobSystem.h"
 #include <SDL.h>
 
 void ParticleSystem::update(float deltaTime) {
     if (!m_scene) return;
     
-    // Iterate through all entities that match this system's signature
-    for (const auto& entity : entities) {
-        auto& particleEffect = m_scene->getComponent<ParticleEffect>(entity);
-        auto& transform = m_scene->getComponent<Transform>(entity);
-        
-        // Update the particle effect
-        particleEffect.update(deltaTime, transform.position);
-    }
+    // Each effect simulates its own particles, so effects update in parallel
+    auto effects = m_scene->view<ParticleEffect, const Transform>();
+    Engine::getInstance().getJobSystem().parallel_for(effects, UPDATE_GRAIN_SIZE,
+        [deltaTime](EntityID, ParticleEffect& particleEffect, const Transform& transform) {
+            // Update the particle effect
+            particleEffect.update(deltaTime, transform.position);
+        });
 }
 
 void ParticleSystem::render(Renderer* renderer) {
     if (!m_scene || !renderer) return;
     
-    // Iterate through all entities that match this system's signature
-    for (const auto& entity : entities) {
-        auto& particleEffect = m_scene->getComponent<ParticleEffect>(entity);
-        auto& transform = m_scene->getComponent<Transform>(entity);
-        
-        // Render all particles
-        for (const auto& particle : particleEffect.particles) {
-            renderParticle(renderer, particle, transform.position, particleEffect.texture);
-        }
-    }
+    // Iterate through all entities with a particle effect and a transform
+    m_scene->view<const ParticleEffect, const Transform>().each(
+        [this, renderer](EntityID, const ParticleEffect& particleEffect, const Transform& transform) {
+            // Render all particles
+            for (const auto& particle : particleEffect.particles) {
+                renderParticle(renderer, particle, transform.position, particleEffect.texture);
+            }
+        });
 }
 
 void ParticleSystem::renderParticle(Renderer* renderer, const ParticleEffect::Particle& particle, 
@@ -1,5 +1,6 @@
 #include "PlayerSystem.h"
 #include "../core/Engine.h"
+#include "../physics/TileCollisionMap.h"
 #include "../utils/ResourceManager.h"
 #include <algorithm>
 #include <cmath>
@@ -25,7 +26,7 @@ EntityID PlayerSystem::createPlayerEntity(Scene* scene, const Vector2& startPosi
     scene->addComponent<Name>(playerEntity, Name("Player"));
     
     // Trigger creation event
-    triggerEvent(PlayerEvent::StateChanged, playerEntity);
+    triggerEvent(scene, PlayerEvent::StateChanged, playerEntity);
     
     return playerEntity;
 }
@@ -84,41 +85,37 @@ void PlayerSystem::setupPlayerComponents(Scene* scene, EntityID playerEntity) {
 void PlayerSystem::update(Scene* scene, float deltaTime) {
     if (!scene) return;
     
-    // Get all entities with player components
-    auto allEntities = scene->getAllLivingEntities();
-    
-    for (EntityID entity : allEntities) {
-        if (!isPlayerEntity(scene, entity)) continue;
-        
-        // Get components
-        auto* controller = &scene->getComponent<PlayerController>(entity);
-        auto* stats = &scene->getComponent<PlayerStats>(entity);
-        auto* physics = &scene->getComponent<PlayerPhysics>(entity);
-        auto* state = &scene->getComponent<PlayerState>(entity);
-        auto* abilities = &scene->getComponent<PlayerAbilities>(entity);
-        
-        // Update timers and cooldowns
-        abilities->updateCooldowns(deltaTime);
-        updateStatusEffects(stats, deltaTime);
-        
-        // Update physics
-        updatePhysics(physics, controller, controller->moveDirection, deltaTime);
-        handleCollisions(scene, entity, physics, deltaTime);
-        
-        // Update state machine
-        updatePlayerState(state, controller, physics, deltaTime);
-        
-        // Update animations
-        updateAnimations(scene, entity, state, deltaTime);
-        
-        // Apply physics to transform
-        auto& transform = scene->getComponent<Transform>(entity);
-        transform.position = transform.position + (physics->velocity * deltaTime);
-        
-        // Reset input direction for next frame
-        controller->moveDirection = Vector2(0, 0);
-        controller->jumpPressed = false;
-    }
+    // Every entity with the player components (see isPlayerEntity)
+    scene->view<PlayerController, PlayerStats, PlayerPhysics>().each(
+        [&](EntityID entity, PlayerController& controllerRef, PlayerStats& statsRef, PlayerPhysics& physicsRef) {
+            auto* controller = &controllerRef;
+            auto* stats = &statsRef;
+            auto* physics = &physicsRef;
+            auto* state = &scene->getComponent<PlayerState>(entity);
+            auto* abilities = &scene->getComponent<PlayerAbilities>(entity);
+            
+            // Update timers and cooldowns
+            abilities->updateCooldowns(deltaTime);
+            updateStatusEffects(stats, deltaTime);
+            
+            // Update physics
+            updatePhysics(physics, controller, controller->moveDirection, deltaTime);
+            handleCollisions(scene, entity, physics, deltaTime);
+            
+            // Update state machine
+            updatePlayerState(state, controller, physics, deltaTime);
+            
+            // Update animations
+            updateAnimations(scene, entity, state, deltaTime);
+            
+            // Apply physics to transform
+            auto& transform = scene->getComponent<Transform>(entity);
+            transform.position = transform.position + (physics->velocity * deltaTime);
+            
+            // Reset input direction for next frame
+            controller->moveDirection = Vector2(0, 0);
+            controller->jumpPressed = false;
+        });
 }
 
 void PlayerSystem::handleInput(Scene* scene, const Uint8* keyboardState, float deltaTime) {
@@ -367,44 +364,64 @@ void PlayerSystem::handleCollisions(Scene* scene, EntityID playerEntity, PlayerP
     auto& transform = scene->getComponent<Transform>(playerEntity);
     auto& collider = scene->getComponent<Collider>(playerEntity);
     
+    // Sweep this frame's movement through tilemap colliders one axis at a
+    // time. A blocked axis moves flush against the wall and loses its
+    // velocity, so update() does not move it any further.
+    Vector2 delta = physics->velocity * deltaTime;
+    scene->view<const Transform, const EnvironmentCollider>().each(
+        [&](EntityID, const Transform& mapTransform, const EnvironmentCollider& environment) {
+            if (environment.shape != EnvironmentCollider::ColliderShape::Tilemap || !environment.tilemap) return;
+            
+            const Rect bounds = collider.getBounds(transform.position - mapTransform.position);
+            const TileCollisionMap::SweepResult sweep = environment.tilemap->sweep(bounds, delta);
+            if (sweep.hitX) {
+                transform.position.x += sweep.delta.x;
+                physics->velocity.x = 0.0f;
+                delta.x = 0.0f;
+            }
+            if (sweep.hitY) {
+                const bool landed = delta.y > 0.0f;
+                transform.position.y += sweep.delta.y;
+                physics->velocity.y = 0.0f;
+                delta.y = 0.0f;
+                if (landed) {
+                    physics->isGrounded = true;
+                    physics->coyoteTimer = physics->coyoteTime;
+                    auto& controller = scene->getComponent<PlayerController>(playerEntity);
+                    controller.jumpsRemaining = controller.maxJumps;
+                }
+            }
+        });
+    
     // Get player bounds
     Rect playerBounds = collider.getBounds(transform.position);
     
-    // Check collision with other entities
-    auto allEntities = scene->getAllLivingEntities();
-    for (EntityID otherEntity : allEntities) {
-        if (otherEntity == playerEntity) continue;
+    // Check collision with the static colliders around the player
+    const Scene& colliders = *scene;
+    scene->queryAABB(playerBounds, [&](EntityID otherEntity, const Rect& otherBounds) {
+        if (otherEntity == playerEntity || !colliders.hasComponent<Collider>(otherEntity) ||
+            !colliders.getComponent<Collider>(otherEntity).isStatic) return;
         
-        if (scene->hasComponent<Transform>(otherEntity) && 
-            scene->hasComponent<Collider>(otherEntity)) {
+        // Simple AABB collision check
+        if (playerBounds.x < otherBounds.x + otherBounds.width &&
+            playerBounds.x + playerBounds.width > otherBounds.x &&
+            playerBounds.y < otherBounds.y + otherBounds.height &&
+            playerBounds.y + playerBounds.height > otherBounds.y) {
             
-            auto& otherTransform = scene->getComponent<Transform>(otherEntity);
-            auto& otherCollider = scene->getComponent<Collider>(otherEntity);
+            // Simple collision response - stop movement
+            physics->velocity = Vector2(0, 0);
             
-            if (otherCollider.isStatic) {
-                Rect otherBounds = otherCollider.getBounds(otherTransform.position);
-                  // Simple AABB collision check
-                if (playerBounds.x < otherBounds.x + otherBounds.width &&
-                    playerBounds.x + playerBounds.width > otherBounds.x &&
-                    playerBounds.y < otherBounds.y + otherBounds.height &&
-                    playerBounds.y + playerBounds.height > otherBounds.y) {
-                    
-                    // Simple collision response - stop movement
-                    physics->velocity = Vector2(0, 0);
-                    
-                    // Set grounded if colliding from above
-                    if (playerBounds.y + playerBounds.height <= otherBounds.y + 10) {
-                        physics->isGrounded = true;
-                        physics->coyoteTimer = physics->coyoteTime;
-                        
-                        // Reset jumps when landing
-                        auto& controller = scene->getComponent<PlayerController>(playerEntity);
-                        controller.jumpsRemaining = controller.maxJumps;
-                    }
-                }
+            // Set grounded if colliding from above
+            if (playerBounds.y + playerBounds.height <= otherBounds.y + 10) {
+                physics->isGrounded = true;
+                physics->coyoteTimer = physics->coyoteTime;
+                
+                // Reset jumps when landing
+                auto& controller = scene->getComponent<PlayerController>(playerEntity);
+                controller.jumpsRemaining = controller.maxJumps;
             }
         }
-    }
+    });
 }
 
 void PlayerSystem::updatePlayerState(PlayerState* state, const PlayerController* controller, 
@@ -562,14 +579,24 @@ void PlayerSystem::setupDefaultItems(PlayerInventory* inventory) {
 EntityID PlayerSystem::findPlayerEntity(Scene* scene) const {
     if (!scene) return 0;
     
-    auto allEntities = scene->getAllLivingEntities();
-    for (EntityID entity : allEntities) {
-        if (isPlayerEntity(scene, entity)) {
-            return entity;
-        }
+    // Generational handles make the cached player safe to reuse: a destroyed
+    // or recycled entity fails isAlive() instead of aliasing a new one
+    if (scene == m_cachedScene && scene->isAlive(m_cachedPlayer) &&
+        isPlayerEntity(scene, m_cachedPlayer)) {
+        return m_cachedPlayer;
     }
     
-    return 0;
+    m_cachedScene = scene;
+    m_cachedPlayer = 0;
+    
+    scene->view<const PlayerController, const PlayerStats, const PlayerPhysics>().each(
+        [this](EntityID entity, const PlayerController&, const PlayerStats&, const PlayerPhysics&) {
+            if (m_cachedPlayer == 0) {
+                m_cachedPlayer = entity;
+            }
+        });
+    
+    return m_cachedPlayer;
 }
 
 bool PlayerSystem::isPlayerEntity(Scene* scene, EntityID entity) const {
@@ -580,19 +607,12 @@ bool PlayerSystem::isPlayerEntity(Scene* scene, EntityID entity) const {
            scene->hasComponent<PlayerPhysics>(entity);
 }
 
-void PlayerSystem::triggerEvent(PlayerEvent::Type type, EntityID playerEntity, void* data) {
+void PlayerSystem::triggerEvent(Scene* scene, PlayerEvent::Type type, EntityID playerEntity, int slot) {
     PlayerEvent event;
     event.type = type;
     event.playerEntity = playerEntity;
-    event.data = data;
-    
-    for (auto& callback : m_eventCallbacks) {
-        callback(event);
-    }
-}
-
-void PlayerSystem::registerEventCallback(PlayerEventCallback callback) {
-    m_eventCallbacks.push_back(callback);
+    event.slot = slot;
+    scene->publishEvent(event);
 }
 
 void PlayerSystem::useAbility(Scene* scene, EntityID playerEntity, int abilityIndex) {
@@ -658,7 +678,7 @@ void PlayerSystem::useAbility(Scene* scene, EntityID playerEntity, int abilityIn
     }
     
     // Trigger ability used event
-    triggerEvent(PlayerEvent::AbilityUsed, playerEntity, &ability);
+    triggerEvent(scene, PlayerEvent::AbilityUsed, playerEntity, abilityIndex);
 }
 
 void PlayerSystem::useItem(Scene* scene, EntityID playerEntity, int itemIndex) {
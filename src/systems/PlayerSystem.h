@@ -40,26 +40,13 @@ public:
     Vector2 getPlayerPosition(Scene* scene, EntityID playerEntity) const;
     PlayerStats::DerivedStats getPlayerStats(Scene* scene, EntityID playerEntity) const;
     
-    // Player events (for game systems to respond to player actions)
-    struct PlayerEvent {
-        enum Type {
-            LevelUp,
-            Death,
-            ItemPickup,
-            AbilityUsed,
-            StateChanged
-        };
-        
-        Type type;
-        EntityID playerEntity;
-        void* data; // Event-specific data
-    };
-    
-    using PlayerEventCallback = std::function<void(const PlayerEvent&)>;
-    void registerEventCallback(PlayerEventCallback callback);
+    // Player actions are published as PlayerEvents on the scene's event bus;
+    // game systems read them with scene->getEvents<PlayerEvent>()
 
 private:
-    std::vector<PlayerEventCallback> m_eventCallbacks;
+    // Last player found by findPlayerEntity (validated with Scene::isAlive)
+    mutable Scene* m_cachedScene = nullptr;
+    mutable EntityID m_cachedPlayer = 0;
     
     // Input handling helpers
     Vector2 getInputDirection(const PlayerController* controller, const Uint8* keyboardState);
@@ -82,7 +69,7 @@ private:
     void updateAnimations(Scene* scene, EntityID playerEntity, const PlayerState* state, float deltaTime);
     
     // Event helpers
-    void triggerEvent(PlayerEvent::Type type, EntityID playerEntity, void* data = nullptr);
+    void triggerEvent(Scene* scene, PlayerEvent::Type type, EntityID playerEntity, int slot = -1);
     
     // Default player configuration
     void setupDefaultAbilities(PlayerAbilities* abilities);
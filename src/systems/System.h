@@ -1,16 +1,91 @@
 #pragma once
 
-#include <set>
+#include "EntityList.h"
+#include "../components/TypeId.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
 
 // Forward declarations
 class Renderer;
-using EntityID = uint32_t;
 
 class System {
 public:
-    std::set<EntityID> entities;
+    EntityList entities;
     
     virtual ~System() = default;
     virtual void update(float deltaTime) {}
     virtual void render(Renderer* renderer) {}
+    
+    // Scheduling declarations (see SystemScheduler). A system that declares no
+    // component access is treated as exclusive: it runs alone on the calling
+    // thread, ordered against every other system.
+    bool hasDeclaredAccess() const { return m_declaredAccess; }
+    // Exclusive systems and those that called runOnMainThread() run on the
+    // thread calling SystemScheduler::run()
+    bool isMainThreadOnly() const { return m_mainThreadOnly || !m_declaredAccess; }
+    const std::vector<size_t>& getReads() const { return m_reads; }    // ComponentIds
+    const std::vector<size_t>& getWrites() const { return m_writes; }  // ComponentIds
+    const std::vector<size_t>& getRunAfter() const { return m_runAfter; }    // SystemIds
+    const std::vector<size_t>& getRunBefore() const { return m_runBefore; }  // SystemIds
+    
+    // True if the two systems may not run at the same time
+    bool conflictsWith(const System& other) const {
+        if (!m_declaredAccess || !other.m_declaredAccess) return true;
+        return overlaps(m_writes, other.m_writes) ||
+               overlaps(m_writes, other.m_reads) ||
+               overlaps(m_reads, other.m_writes);
+    }
+
+protected:
+    // Call from the constructor, e.g. reads<Transform>(); writes<RigidBody>();
+    template<typename... Ts>
+    void reads() {
+        m_declaredAccess = true;
+        (m_reads.push_back(ComponentId<Ts>::value), ...);
+    }
+    
+    template<typename... Ts>
+    void writes() {
+        m_declaredAccess = true;
+        (m_writes.push_back(ComponentId<Ts>::value), ...);
+    }
+    
+    // For systems that touch no components but are safe to run concurrently
+    void declareNoComponentAccess() {
+        m_declaredAccess = true;
+    }
+    
+    // For systems that declare their access but call APIs that must stay on
+    // the main thread (SDL, SDL_mixer). Unlike exclusive systems they still
+    // run alongside worker systems they do not conflict with.
+    void runOnMainThread() {
+        m_mainThreadOnly = true;
+    }
+    
+    // Explicit ordering against other system types (ignored if not registered)
+    template<typename... Ts>
+    void runAfter() {
+        (m_runAfter.push_back(SystemId<Ts>::value), ...);
+    }
+    
+    template<typename... Ts>
+    void runBefore() {
+        (m_runBefore.push_back(SystemId<Ts>::value), ...);
+    }
+
+private:
+    static bool overlaps(const std::vector<size_t>& a, const std::vector<size_t>& b) {
+        for (size_t id : a) {
+            if (std::find(b.begin(), b.end(), id) != b.end()) return true;
+        }
+        return false;
+    }
+    
+    bool m_declaredAccess = false;
+    bool m_mainThreadOnly = false;
+    std::vector<size_t> m_reads;
+    std::vector<size_t> m_writes;
+    std::vector<size_t> m_runAfter;
+    std::vector<size_t> m_runBefore;
 };
@@ -1,61 +1,211 @@
 #pragma once
 
 #include "System.h"
+#include "SystemScheduler.h"
+#include "../components/EntityManager.h"
+#include "../components/TypeId.h"
+#include <array>
 #include <memory>
-#include <unordered_map>
-#include <typeindex>
+#include <vector>
+#include <stdexcept>
 
+// Systems are looked up through a flat array indexed by SystemId<T>::value.
+// update() runs them through a SystemScheduler built from their declared
+// component access; render() runs them in registration order on the calling
+// thread.
+//
+// For each component bit the manager keeps the list of systems whose signature
+// contains that bit, so adding or removing one component only re-evaluates the
+// systems that can be affected by it.
 class SystemManager {
 public:
     template<typename T>
     std::shared_ptr<T> registerSystem() {
-        const char* typeName = typeid(T).name();
+        const size_t id = SystemId<T>::value;
+        if (id >= m_slots.size()) {
+            m_slots.resize(id + 1, NOT_REGISTERED);
+        }
         
         auto system = std::make_shared<T>();
-        m_systems.insert({typeName, system});
+        if (m_slots[id] != NOT_REGISTERED) {
+            // Re-registering replaces the previous instance but keeps its signature
+            m_systems[m_slots[id]].system = system;
+            m_scheduleDirty = true;
+            return system;
+        }
+        
+        m_slots[id] = m_systems.size();
+        m_systems.push_back({system, ComponentMask(), id});
+        rebuildComponentIndex();
+        m_scheduleDirty = true;
         return system;
     }
     
     template<typename T>
     void setSignature(ComponentMask signature) {
-        const char* typeName = typeid(T).name();
-        m_signatures.insert({typeName, signature});
+        const size_t id = SystemId<T>::value;
+        if (id >= m_slots.size() || m_slots[id] == NOT_REGISTERED) {
+            throw std::runtime_error("System not registered");
+        }
+        m_systems[m_slots[id]].signature = signature;
+        rebuildComponentIndex();
     }
     
     void entityDestroyed(EntityID entity) {
-        for (auto const& pair : m_systems) {
-            auto const& system = pair.second;
-            system->entities.erase(entity);
+        for (auto const& entry : m_systems) {
+            entry.system->entities.erase(entity);
         }
     }
     
+    // Full re-evaluation against every system
     void entitySignatureChanged(EntityID entity, ComponentMask entitySignature) {
-        for (auto const& pair : m_systems) {
-            auto const& type = pair.first;
-            auto const& system = pair.second;
-            auto const& systemSignature = m_signatures[type];
+        for (auto const& entry : m_systems) {
+            updateMembership(entry, entity, entitySignature);
+        }
+    }
+    
+    // A single component bit changed; only systems that use it can change membership
+    void entityComponentChanged(EntityID entity, ComponentType type, const ComponentMask& entitySignature) {
+        for (size_t index : m_systemsByComponent[type]) {
+            updateMembership(m_systems[index], entity, entitySignature);
+        }
+        // Empty signatures match every entity that has any component
+        for (size_t index : m_wildcardSystems) {
+            m_systems[index].system->entities.insert(entity);
+        }
+    }
+    
+    // Batch form of entityComponentChanged: every entity changed only bits in
+    // `changed`, and signatureOf(i) is the new signature of entities[i]. Each
+    // affected system is visited once and walks the whole batch.
+    template<typename SignatureOf>
+    void entitiesComponentsChanged(const std::vector<EntityID>& entities, const ComponentMask& changed,
+                                   SignatureOf&& signatureOf) {
+        std::vector<bool> affected(m_systems.size(), false);
+        for (ComponentType type = 0; type < MAX_COMPONENTS; ++type) {
+            if (!changed.test(type)) continue;
+            for (size_t index : m_systemsByComponent[type]) {
+                affected[index] = true;
+            }
+        }
+        
+        for (size_t index = 0; index < m_systems.size(); ++index) {
+            const SystemEntry& entry = m_systems[index];
+            EntityList& members = entry.system->entities;
+            if (entry.signature.none()) {
+                // Wildcard systems take every entity that has any component
+                members.reserve(members.size() + entities.size());
+                for (EntityID entity : entities) {
+                    members.insert(entity);
+                }
+                continue;
+            }
+            if (!affected[index]) continue;
             
-            if ((entitySignature & systemSignature) == systemSignature) {
-                system->entities.insert(entity);
-            } else {
-                system->entities.erase(entity);
+            members.reserve(members.size() + entities.size());
+            for (size_t i = 0; i < entities.size(); ++i) {
+                updateMembership(entry, entities[i], signatureOf(i));
+            }
+        }
+    }
+    
+    // Recomputes every system's entity list from scratch, e.g. after the
+    // scene's entities were replaced wholesale. Members end up in slot order.
+    void rebuildMembership(const EntityManager& entities) {
+        for (auto const& entry : m_systems) {
+            entry.system->entities.clear();
+        }
+        const uint32_t capacity = entities.getEntityCapacity();
+        for (uint32_t index = 1; index < capacity; ++index) {
+            const EntityID entity = entities.getEntityAtIndex(index);
+            if (entity == Entity::Null) continue;
+            const ComponentMask& signature = entities.getSignature(entity);
+            if (signature.none()) continue;
+            for (auto const& entry : m_systems) {
+                if ((signature & entry.signature) == entry.signature) {
+                    entry.system->entities.insert(entity);
+                }
             }
         }
     }
     
     void update(float deltaTime) {
-        for (auto const& pair : m_systems) {
-            pair.second->update(deltaTime);
+        if (m_scheduleDirty) {
+            rebuildSchedule();
         }
+        m_scheduler.run(deltaTime, m_executionMode);
+    }
+    
+    // Serial runs the same schedule on one thread, for debugging
+    void setExecutionMode(SystemExecutionMode mode) { m_executionMode = mode; }
+    SystemExecutionMode getExecutionMode() const { return m_executionMode; }
+    
+    const SystemScheduler& getScheduler() {
+        if (m_scheduleDirty) {
+            rebuildSchedule();
+        }
+        return m_scheduler;
     }
     
     void render(Renderer* renderer) {
-        for (auto const& pair : m_systems) {
-            pair.second->render(renderer);
+        for (auto const& entry : m_systems) {
+            entry.system->render(renderer);
         }
     }
 
 private:
-    std::unordered_map<const char*, ComponentMask> m_signatures{};
-    std::unordered_map<const char*, std::shared_ptr<System>> m_systems{};
+    static constexpr size_t NOT_REGISTERED = static_cast<size_t>(-1);
+    
+    struct SystemEntry {
+        std::shared_ptr<System> system;
+        ComponentMask signature;
+        size_t systemId;
+    };
+    
+    static void updateMembership(const SystemEntry& entry, EntityID entity, const ComponentMask& entitySignature) {
+        if ((entitySignature & entry.signature) == entry.signature) {
+            entry.system->entities.insert(entity);
+        } else {
+            entry.system->entities.erase(entity);
+        }
+    }
+    
+    void rebuildComponentIndex() {
+        for (auto& systems : m_systemsByComponent) {
+            systems.clear();
+        }
+        m_wildcardSystems.clear();
+        
+        for (size_t index = 0; index < m_systems.size(); ++index) {
+            const ComponentMask& signature = m_systems[index].signature;
+            if (signature.none()) {
+                m_wildcardSystems.push_back(index);
+                continue;
+            }
+            for (ComponentType type = 0; type < MAX_COMPONENTS; ++type) {
+                if (signature.test(type)) {
+                    m_systemsByComponent[type].push_back(index);
+                }
+            }
+        }
+    }
+    
+    void rebuildSchedule() {
+        std::vector<SystemScheduler::Entry> entries;
+        entries.reserve(m_systems.size());
+        for (auto const& entry : m_systems) {
+            entries.push_back({entry.system.get(), entry.systemId});
+        }
+        m_scheduler.build(entries);
+        m_scheduleDirty = false;
+    }
+    
+    std::vector<size_t> m_slots;         // SystemId<T>::value -> index into m_systems
+    std::vector<SystemEntry> m_systems;  // Registration order
+    std::array<std::vector<size_t>, MAX_COMPONENTS> m_systemsByComponent;
+    std::vector<size_t> m_wildcardSystems;
+    
+    SystemScheduler m_scheduler;
+    SystemExecutionMode m_executionMode = SystemExecutionMode::Parallel;
+    bool m_scheduleDirty = true;
 };
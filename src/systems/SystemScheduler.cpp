@@ -0,0 +1,197 @@
+#include "SystemScheduler.h"
+#include "System.h"
+#include "../core/Engine.h"
+#include "../core/JobSystem.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
+
+void SystemScheduler::build(const std::vector<Entry>& systems) {
+    m_systems = systems;
+    const size_t count = m_systems.size();
+
+    // Explicit constraints as edges between registration indices
+    std::vector<std::vector<size_t>> explicitEdges(count);
+    std::vector<std::vector<size_t>> explicitPredecessors(count);
+    auto findById = [&](size_t systemId) {
+        for (size_t i = 0; i < count; ++i) {
+            if (m_systems[i].systemId == systemId) return i;
+        }
+        return count;
+    };
+    auto addExplicitEdge = [&](size_t from, size_t to) {
+        if (from == count || to == count || from == to) return;
+        explicitEdges[from].push_back(to);
+        explicitPredecessors[to].push_back(from);
+    };
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t id : m_systems[i].system->getRunAfter()) {
+            addExplicitEdge(findById(id), i);
+        }
+        for (size_t id : m_systems[i].system->getRunBefore()) {
+            addExplicitEdge(i, findById(id));
+        }
+    }
+
+    // Registration order, except that a system's explicit predecessors are
+    // pulled in front of it
+    enum class Mark { None, Visiting, Placed };
+    std::vector<Mark> marks(count, Mark::None);
+    m_order.clear();
+    std::function<void(size_t)> place = [&](size_t index) {
+        if (marks[index] == Mark::Placed) return;
+        if (marks[index] == Mark::Visiting) {
+            throw std::runtime_error("System schedule has a dependency cycle");
+        }
+        marks[index] = Mark::Visiting;
+        for (size_t predecessor : explicitPredecessors[index]) {
+            place(predecessor);
+        }
+        marks[index] = Mark::Placed;
+        m_order.push_back(index);
+    };
+    for (size_t i = 0; i < count; ++i) {
+        place(i);
+    }
+
+    // Every conflicting or explicitly constrained pair runs in m_order
+    m_dependencies.assign(count, {});
+    m_dependents.assign(count, {});
+    for (size_t a = 0; a < count; ++a) {
+        for (size_t b = a + 1; b < count; ++b) {
+            const size_t first = m_order[a];
+            const size_t second = m_order[b];
+            const bool constrained = std::find(explicitEdges[first].begin(), explicitEdges[first].end(), second)
+                                     != explicitEdges[first].end();
+            if (constrained || m_systems[first].system->conflictsWith(*m_systems[second].system)) {
+                m_dependencies[second].push_back(first);
+                m_dependents[first].push_back(second);
+            }
+        }
+    }
+}
+
+void SystemScheduler::run(float deltaTime, SystemExecutionMode mode) {
+    if (mode == SystemExecutionMode::Parallel && m_systems.size() > 1) {
+        runParallel(deltaTime);
+    } else {
+        runSerial(deltaTime);
+    }
+}
+
+void SystemScheduler::runSerial(float deltaTime) {
+    for (size_t index : m_order) {
+        m_systems[index].system->update(deltaTime);
+    }
+}
+
+void SystemScheduler::runParallel(float deltaTime) {
+    const size_t count = m_systems.size();
+    if (count == 0) return;
+
+    struct FrameState {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<size_t> remaining;
+        std::deque<size_t> mainThreadQueue;
+        size_t finished = 0;
+        std::exception_ptr error;
+    } state;
+
+    state.remaining.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        state.remaining[i] = m_dependencies[i].size();
+    }
+
+    JobSystem& jobs = Engine::getInstance().getJobSystem();
+    std::function<void(size_t)> dispatch;
+
+    // Called with state.mutex held. Exclusive and main-thread systems always
+    // run on the calling thread; everything else goes to the job system.
+    auto schedule = [&](size_t index) {
+        if (m_systems[index].system->isMainThreadOnly()) {
+            state.mainThreadQueue.push_back(index);
+        } else {
+            jobs.submit([&dispatch, index]() { dispatch(index); });
+        }
+    };
+
+    // Runs a system, then releases its dependents. The final notify happens
+    // under the lock so the frame state outlives every worker's last access.
+    auto execute = [&](size_t index) {
+        std::exception_ptr error;
+        try {
+            m_systems[index].system->update(deltaTime);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (error && !state.error) {
+            state.error = error;
+        }
+        for (size_t dependent : m_dependents[index]) {
+            if (--state.remaining[dependent] == 0) {
+                schedule(dependent);
+            }
+        }
+        ++state.finished;
+        state.condition.notify_all();
+    };
+    dispatch = execute;
+
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (size_t index : m_order) {
+            if (state.remaining[index] == 0) {
+                schedule(index);
+            }
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (state.finished < count) {
+        state.condition.wait(lock, [&]() {
+            return state.finished == count || !state.mainThreadQueue.empty();
+        });
+        if (!state.mainThreadQueue.empty()) {
+            const size_t index = state.mainThreadQueue.front();
+            state.mainThreadQueue.pop_front();
+            lock.unlock();
+            execute(index);
+            lock.lock();
+        }
+    }
+
+    if (state.error) {
+        std::rethrow_exception(state.error);
+    }
+}
+
+std::string SystemScheduler::describe() const {
+    std::ostringstream out;
+    for (size_t step = 0; step < m_order.size(); ++step) {
+        const size_t index = m_order[step];
+        const System& system = *m_systems[index].system;
+        out << step << ": " << typeid(system).name();
+        if (!system.hasDeclaredAccess()) {
+            out << " (exclusive)";
+        } else if (system.isMainThreadOnly()) {
+            out << " (main thread)";
+        }
+        if (!m_dependencies[index].empty()) {
+            out << " after";
+            for (size_t dependency : m_dependencies[index]) {
+                out << " " << typeid(*m_systems[dependency].system).name();
+            }
+        }
+        out << "\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class System;
+
+enum class SystemExecutionMode {
+    Serial,   // One system at a time on the calling thread, in schedule order
+    Parallel  // Non-conflicting systems run concurrently on worker threads
+};
+
+// Orders system updates from the systems' declared component access and
+// explicit runBefore/runAfter constraints.
+//
+// build() keeps registration order except that each system's explicit
+// predecessors are moved in front of it, then adds an edge between every pair
+// of systems whose access conflicts, in that order. The result is a DAG:
+// Serial mode runs it in order, Parallel mode runs every system as soon as its
+// predecessors have finished. Both modes give the same result for systems
+// that declare their access correctly.
+class SystemScheduler {
+public:
+    struct Entry {
+        System* system = nullptr;
+        size_t systemId = 0;  // SystemId<T>::value
+    };
+
+    // Throws std::runtime_error if the explicit constraints form a cycle
+    void build(const std::vector<Entry>& systems);
+
+    void run(float deltaTime, SystemExecutionMode mode);
+
+    // Indices into the systems passed to build(), in serial execution order
+    const std::vector<size_t>& getOrder() const { return m_order; }
+    // Indices of the systems that must finish before system i starts
+    const std::vector<size_t>& getDependencies(size_t index) const { return m_dependencies[index]; }
+
+    // Human readable dump of the schedule, for debugging
+    std::string describe() const;
+
+private:
+    void runSerial(float deltaTime);
+    void runParallel(float deltaTime);
+
+    std::vector<Entry> m_systems;
+    std::vector<size_t> m_order;
+    std::vector<std::vector<size_t>> m_dependencies;
+    std::vector<std::vector<size_t>> m_dependents;
+};
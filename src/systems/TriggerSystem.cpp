@@ -0,0 +1,66 @@
+#include "CoreSystems.h"
+#include "../components/Components.h"
+#include "../scene/Scene.h"
+#include <algorithm>
+#include <iterator>
+
+void TriggerSystem::update(float) {
+    if (!m_scene) return;
+    const Scene& scene = *m_scene; // Nothing is written until a trigger fires
+    
+    for (const EntityID triggerEntity : entities) {
+        const auto& trigger = scene.getComponent<EnvironmentTrigger>(triggerEntity);
+        const Vector2& position = scene.getComponent<Transform>(triggerEntity).position;
+        const Rect area(position.x, position.y, trigger.size.x, trigger.size.y);
+        
+        // Only the colliders the scene's spatial index finds around the area
+        m_overlapping.clear();
+        scene.queryAABB(area, [&](EntityID other, const Rect& bounds) {
+            if (other != triggerEntity && CollisionSystem::checkCollision(area, bounds)) {
+                m_overlapping.push_back(other);
+            }
+        });
+        std::sort(m_overlapping.begin(), m_overlapping.end());
+        
+        std::vector<EntityID>& inside = m_inside[triggerEntity];
+        switch (trigger.type) {
+            case EnvironmentTrigger::TriggerType::Enter:
+                for (const EntityID other : m_overlapping) {
+                    if (!std::binary_search(inside.begin(), inside.end(), other)) {
+                        publish(triggerEntity, trigger, other);
+                    }
+                }
+                break;
+            case EnvironmentTrigger::TriggerType::Exit:
+                for (const EntityID other : inside) {
+                    if (!std::binary_search(m_overlapping.begin(), m_overlapping.end(), other)) {
+                        publish(triggerEntity, trigger, other);
+                    }
+                }
+                break;
+            case EnvironmentTrigger::TriggerType::Stay:
+                for (const EntityID other : m_overlapping) {
+                    publish(triggerEntity, trigger, other);
+                }
+                break;
+            case EnvironmentTrigger::TriggerType::Interact:
+                break;
+        }
+        inside.swap(m_overlapping);
+    }
+    
+    // Forget triggers that were destroyed or lost their component
+    for (auto it = m_inside.begin(); it != m_inside.end();) {
+        it = entities.contains(it->first) ? std::next(it) : m_inside.erase(it);
+    }
+}
+
+void TriggerSystem::publish(EntityID triggerEntity, const EnvironmentTrigger& trigger, EntityID other) {
+    if (trigger.triggerOnce && trigger.hasTriggered) return;
+    if (!trigger.hasTriggered) {
+        // The first firing is the only write, so a trigger is not stamped as
+        // changed every frame it fires
+        m_scene->getComponent<EnvironmentTrigger>(triggerEntity).hasTriggered = true;
+    }
+    m_scene->publishEvent(TriggerEvent{triggerEntity, other, trigger.type});
+}